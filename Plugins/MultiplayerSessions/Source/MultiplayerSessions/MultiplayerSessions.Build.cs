@@ -27,7 +27,6 @@ public class MultiplayerSessions : ModuleRules
 			{
 				"Core",
                 "OnlineSubsystem",
-				"OnlineSubsystemSteam",
 				"UMG",
 				"Slate",
 				"SlateCore"
@@ -43,6 +42,8 @@ public class MultiplayerSessions : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"Sockets",
+				"Networking",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -54,5 +55,14 @@ public class MultiplayerSessions : ModuleRules
 				// ... add any modules that your module loads dynamically here ...
 			}
 			);
+
+		// Steam 헤더는 사용하지 않으므로 런타임에만 필요하다.
+		// Steam 이 없는 플랫폼 / 헤드리스 빌드는 OnlineSubsystemNull 로 동작한다.
+		if ( Target.Platform == UnrealTargetPlatform.Win64 ||
+			 Target.Platform == UnrealTargetPlatform.Mac ||
+			 Target.Platform == UnrealTargetPlatform.Linux )
+		{
+			DynamicallyLoadedModuleNames.Add( "OnlineSubsystemSteam" );
+		}
 	}
 }
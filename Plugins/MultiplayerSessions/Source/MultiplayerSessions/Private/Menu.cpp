@@ -4,7 +4,6 @@
 #include "Menu.h"
 #include "MultiPlayerSessionsSubsystem.h"
 #include "OnlineSessionSettings.h"
-#include "OnlineSubsystem.h"
 #include "Components/Button.h"
 
 
@@ -16,6 +15,7 @@ void UMenu::MenuSetup( int32 numberOfPublicConnections, FString typeOfMatch, FSt
 	m_PathToLobby = FString::Printf( TEXT( "%s?listen" ), *lobbyPath );
 	m_NumPublicConnections = numberOfPublicConnections;
 	m_MatchType = typeOfMatch;
+	m_MatchTypeName = FName( *typeOfMatch );
 
 	AddToViewport();
 	SetVisibility( ESlateVisibility::Visible );
@@ -49,6 +49,7 @@ void UMenu::MenuSetup( int32 numberOfPublicConnections, FString typeOfMatch, FSt
 		// 대리자 클래스에 함수를 매핑합니다.
 		m_MultiPlayerSessionSubsystem->GetMultiplayerOnCreateSessionComplete().AddDynamic(this, &ThisClass::OnCreateSession);
 		m_MultiPlayerSessionSubsystem->GetMultiplayerOnFindSessionsComplete().AddUObject( this, &ThisClass::OnFindSessions );
+		m_MultiPlayerSessionSubsystem->GetMultiplayerOnFindSessionsPartial().AddUObject( this, &ThisClass::OnFindSessionsPartial );
 		m_MultiPlayerSessionSubsystem->GetMultiplayerOnJoinSessionComplete().AddUObject(this, &ThisClass::OnJoinSession);
 		m_MultiPlayerSessionSubsystem->GetMultiplayerOnDestroySessionComplete().AddDynamic( this, &ThisClass::OnDestroySession );
 		m_MultiPlayerSessionSubsystem->GetMultiplayerOnStartSessionComplete().AddDynamic( this, &ThisClass::OnStartSession );
@@ -132,29 +133,39 @@ void UMenu::OnFindSessions( const TArray<FOnlineSessionSearchResult>& sessionRes
 	if ( nullptr == m_MultiPlayerSessionSubsystem )
 		return;
 
-	for ( auto& result : sessionResults )
+	// 핑과 빈 슬롯 기준 순위대로 참가하고, 실패하면 다음 후보로 넘어간다.
+	if ( m_MultiPlayerSessionSubsystem->JoinBestSession( GetSessionTarget(), m_MatchTypeName ) )
+		return;
+
+	// 조건에 맞는 세션이 없으면 다시 검색할 수 있도록 버튼을 활성화한다.
+	m_JoinButton->SetIsEnabled( true );
+
+	if ( GEngine )
 	{
-		FString settingsValue;
-		result.Session.SessionSettings.Get( FName( "MatchType" ), settingsValue );
-		if ( m_MatchType == settingsValue )
-		{
-			m_MultiPlayerSessionSubsystem->JoinSession( result );
-			return;
-		}
+		GEngine->AddOnScreenDebugMessage(
+			-1,
+			15.f,
+			FColor::Red,
+			FString( TEXT( "Failed to Find Session" ) ) );
 	}
+}
 
-	if ( !bWasSuccessful || sessionResults.Num() == 0 )
-	{
-		m_JoinButton->SetIsEnabled( true );
+////////////////////////////////////////////////////////////////////////////
+/// 세션 부분 검색 결과를 처리한다. [ Delegator 로부터 전달받아 호출된 함수 ]
+////////////////////////////////////////////////////////////////////////////
+void UMenu::OnFindSessionsPartial( const TArray<FOnlineSessionSearchResult>& sessionResults, int32 firstNewIndex )
+{
+	if ( nullptr == m_MultiPlayerSessionSubsystem )
+		return;
 
-		if ( GEngine )
-		{
-			GEngine->AddOnScreenDebugMessage(
-				-1,
-				15.f,
-				FColor::Red,
-				FString( TEXT( "Failed to Find Session" ) ) );
-		}
+	// 조건에 맞는 세션이 아직 없으면 순위 계산 없이 다음 결과를 기다린다.
+	if ( nullptr == m_MultiPlayerSessionSubsystem->FindIndexedSession( m_MatchTypeName ) )
+		return;
+
+	// 조건에 맞는 세션이 도착하면 나머지 검색을 기다리지 않고 지금까지 도착한 결과 중 가장 좋은 후보에 참가한다.
+	if ( m_MultiPlayerSessionSubsystem->JoinBestSession( GetSessionTarget(), m_MatchTypeName ) )
+	{
+		m_MultiPlayerSessionSubsystem->StopFindSessions();
 	}
 }
 
@@ -163,32 +174,34 @@ void UMenu::OnFindSessions( const TArray<FOnlineSessionSearchResult>& sessionRes
 ////////////////////////////////////////////////////////////////////////////
 void UMenu::OnJoinSession( EOnJoinSessionCompleteResult::Type result )
 {
-	// 일단 Success 가 아니면 반환
+	// 모든 후보에 참가하지 못했으면 다시 검색할 수 있도록 버튼을 활성화한다.
 	if ( EOnJoinSessionCompleteResult::Success != result )
-		return;
-
-	IOnlineSubsystem* subSystem = IOnlineSubsystem::Get();
-	if ( subSystem )
 	{
-		IOnlineSessionPtr sessionInterface = subSystem->GetSessionInterface();
-		if ( sessionInterface.IsValid() )
+		m_JoinButton->SetIsEnabled( true );
+
+		if ( GEngine )
 		{
-			FString address;
-			sessionInterface->GetResolvedConnectString( NAME_GameSession, address );
-
-			APlayerController* playerController = GetGameInstance()->GetFirstLocalPlayerController();
-			if ( playerController )
-			{
-				// absolute travel 유영의 주소를 전달한다.
-				playerController->ClientTravel( address, ETravelType::TRAVEL_Absolute );
-			}
-			
+			GEngine->AddOnScreenDebugMessage(
+				-1,
+				15.f,
+				FColor::Red,
+				FString( TEXT( "Failed to Join Session" ) ) );
 		}
+
+		return;
 	}
 
-	if ( result != EOnJoinSessionCompleteResult::Success )
+	// 참가한 세션의 주소는 세션 서브시스템의 백엔드로부터 얻는다.
+	FString address;
+	if ( m_MultiPlayerSessionSubsystem && m_MultiPlayerSessionSubsystem->GetResolvedConnectString( address ) )
 	{
-		m_JoinButton->SetIsEnabled( true );
+		// 분할 화면에서도 메뉴를 띄운 플레이어가 이동한다.
+		APlayerController* playerController = GetOwningPlayer();
+		if ( playerController )
+		{
+			// absolute travel 유영의 주소를 전달한다.
+			playerController->ClientTravel( address, ETravelType::TRAVEL_Absolute );
+		}
 	}
 }
 
@@ -204,6 +217,14 @@ void UMenu::OnDestroySession( bool bWasSuccessful )
 ////////////////////////////////////////////////////////////////////////////
 void UMenu::OnStartSession( bool bWasSuccessful )
 {
+	if ( GEngine )
+	{
+		GEngine->AddOnScreenDebugMessage(
+			-1,
+			15.f,
+			bWasSuccessful ? FColor::Yellow : FColor::Red,
+			FString( bWasSuccessful ? TEXT( "Session Started" ) : TEXT( "Failed to Start Session" ) ) );
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -216,8 +237,12 @@ void UMenu::HostButtonClicked()
 
 	if ( m_MultiPlayerSessionSubsystem )
 	{
+		// 세션 생성을 기다리는 동안 로비 맵을 미리 로드하고, 참가하는 쪽도 미리 로드하도록 광고한다.
+		m_MultiPlayerSessionSubsystem->PreloadMap( m_PathToLobby );
+		m_MultiPlayerSessionSubsystem->SetHostMap( m_PathToLobby );
+
 		/// TODO. 일단 들어오는지 검사하기 위해서 임시로 적용.
-		m_MultiPlayerSessionSubsystem->CreateSession( m_NumPublicConnections, m_MatchType );
+		m_MultiPlayerSessionSubsystem->CreateSession( GetSessionTarget(), m_NumPublicConnections, m_MatchType );
 	}
 
 	if ( GEngine )
@@ -240,7 +265,11 @@ void UMenu::JoinButtonClicked()
 
 	if ( m_MultiPlayerSessionSubsystem )
 	{
-		m_MultiPlayerSessionSubsystem->FindSessions( 10000 );
+		// 호스트는 같은 로비 맵에서 기다리므로, 검색과 참가를 기다리는 동안 미리 로드한다.
+		m_MultiPlayerSessionSubsystem->PreloadMap( m_PathToLobby );
+
+		// 10000 은 상한이다. 적은 수로 찾기 시작해서 조건에 맞는 세션이 없을 때만 넓힌다.
+		m_MultiPlayerSessionSubsystem->FindSessionsStreaming( GetSessionTarget(), 10000, m_MatchTypeName );
 	}
 
 	if ( GEngine )
@@ -271,3 +300,11 @@ void UMenu::MenuTearDown()
 		}
 	}
 }
+
+////////////////////////////////////////////////////////////////////////////
+/// 메뉴를 소유한 로컬 플레이어의 세션 대상을 반환합니다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerSessionTarget UMenu::GetSessionTarget() const
+{
+	return FMultiplayerSessionTarget::ForLocalPlayer( GetOwningLocalPlayer() );
+}
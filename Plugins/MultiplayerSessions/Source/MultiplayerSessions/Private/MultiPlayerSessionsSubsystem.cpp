@@ -2,279 +2,2205 @@
 
 
 #include "MultiPlayerSessionsSubsystem.h"
-#include "OnlineSubsystem.h"
+#include "MultiplayerSessions.h"
+#include "MultiplayerFakeSessionBackend.h"
+#include "MultiplayerLanSessionBackend.h"
 #include "OnlineSessionSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Engine/GameInstance.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "IPAddress.h"
+#include "Misc/ConfigCacheIni.h"
 
 
+namespace MultiplayerSessionsSubsystem
+{
+	/// 월드의 세션 서브시스템을 반환한다.
+	static UMultiPlayerSessionsSubsystem* GetSubsystem( UWorld* world )
+	{
+		UGameInstance* gameInstance = world ? world->GetGameInstance() : nullptr;
+		return gameInstance ? gameInstance->GetSubsystem< UMultiPlayerSessionsSubsystem >() : nullptr;
+	}
+
+	/// 서브시스템의 리슨 포트를 광고하는 LAN 백엔드를 만든다.
+	static TSharedRef< FMultiplayerLanSessionBackend > MakeLanBackend( UMultiPlayerSessionsSubsystem* subsystem, const FMultiplayerLanDiscoveryConfig& config )
+	{
+		TSharedRef< FMultiplayerLanSessionBackend > backend = MakeShared< FMultiplayerLanSessionBackend >( config );
+
+		TWeakObjectPtr< UMultiPlayerSessionsSubsystem > weakSubsystem( subsystem );
+		backend->SetGamePortResolver( [ weakSubsystem ]()
+		{
+			return weakSubsystem.IsValid() ? weakSubsystem->GetListenPort() : 0;
+		} );
+
+		return backend;
+	}
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice FakeBackendCommand(
+		TEXT( "MultiplayerSessions.FakeBackend" ),
+		TEXT( "세션 백엔드를 프로세스 내 가짜 백엔드로 바꿉니다. " )
+		TEXT( "사용법 : MultiplayerSessions.FakeBackend [NumSessions=] [Regions=] [LatencyMs=] [JitterMs=] [CreateFail=] [FindFail=] [JoinFail=] [FullRace=] [Seed=] [LAN]" ),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda( []( const TArray< FString >& args, UWorld* world, FOutputDevice& output )
+		{
+			UMultiPlayerSessionsSubsystem* subsystem = GetSubsystem( world );
+			if ( nullptr == subsystem )
+				return;
+
+			const FString params = FString::Join( args, TEXT( " " ) );
+
+			FMultiplayerFakeBackendConfig config;
+			FParse::Value( *params, TEXT( "NumSessions=" ),	config.NumSessions );
+			FParse::Value( *params, TEXT( "Regions=" ),		config.NumRegions );
+			FParse::Value( *params, TEXT( "LatencyMs=" ),	config.LatencyMs );
+			FParse::Value( *params, TEXT( "JitterMs=" ),	config.LatencyJitterMs );
+			FParse::Value( *params, TEXT( "CreateFail=" ),	config.CreateFailureRate );
+			FParse::Value( *params, TEXT( "FindFail=" ),	config.FindFailureRate );
+			FParse::Value( *params, TEXT( "JoinFail=" ),	config.JoinFailureRate );
+			FParse::Value( *params, TEXT( "FullRace=" ),	config.FullLobbyRaceRate );
+			FParse::Value( *params, TEXT( "Seed=" ),		config.Seed );
+			config.bIsLAN = FParse::Param( *params, TEXT( "LAN" ) );
+
+			if ( !subsystem->SetSessionBackend( MakeShared< FMultiplayerFakeSessionBackend >( config ) ) )
+			{
+				output.Log( TEXT( "Session operations are in flight. Try again when idle." ) );
+				return;
+			}
+
+			output.Logf( TEXT( "Fake session backend : %d sessions, %.0fms + %.0fms jitter" ), config.NumSessions, config.LatencyMs, config.LatencyJitterMs );
+		} ) );
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice LanBackendCommand(
+		TEXT( "MultiplayerSessions.LanBackend" ),
+		TEXT( "세션 백엔드를 LAN 탐색 백엔드로 바꿉니다. " )
+		TEXT( "사용법 : MultiplayerSessions.LanBackend [Probe=127.0.0.1,10.0.0.1-254] [BasePort=] [Ports=] [Shard=] [Window=] [TimeoutMs=]" ),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda( []( const TArray< FString >& args, UWorld* world, FOutputDevice& output )
+		{
+			UMultiPlayerSessionsSubsystem* subsystem = GetSubsystem( world );
+			if ( nullptr == subsystem )
+				return;
+
+			const FString params = FString::Join( args, TEXT( " " ) );
+
+			FMultiplayerLanDiscoveryConfig config = FMultiplayerLanDiscoveryConfig::Load();
+
+			FString probeAddresses;
+			if ( FParse::Value( *params, TEXT( "Probe=" ), probeAddresses, false ) )
+			{
+				probeAddresses.ParseIntoArray( config.ProbeAddresses, TEXT( "," ) );
+			}
+
+			float timeoutMs = config.ProbeTimeout * 1000.f;
+			FParse::Value( *params, TEXT( "BasePort=" ),	config.BasePort );
+			FParse::Value( *params, TEXT( "Ports=" ),		config.NumPorts );
+			FParse::Value( *params, TEXT( "Shard=" ),		config.ShardSize );
+			FParse::Value( *params, TEXT( "Window=" ),		config.MaxConcurrentShards );
+			FParse::Value( *params, TEXT( "TimeoutMs=" ),	timeoutMs );
+
+			config.NumPorts			   = FMath::Max( config.NumPorts, 1 );
+			config.ShardSize		   = FMath::Max( config.ShardSize, 1 );
+			config.MaxConcurrentShards = FMath::Max( config.MaxConcurrentShards, 1 );
+			config.ProbeTimeout		   = FMath::Max( timeoutMs / 1000.f, 0.01f );
+
+			if ( !subsystem->SetSessionBackend( MakeLanBackend( subsystem, config ) ) )
+			{
+				output.Log( TEXT( "Session operations are in flight. Try again when idle." ) );
+				return;
+			}
+
+			output.Logf( TEXT( "LAN session backend : %d addresses x %d ports, %d per shard, %d shards in flight" ),
+				config.ProbeAddresses.Num(), config.NumPorts, config.ShardSize, config.MaxConcurrentShards );
+		} ) );
+
+	static FAutoConsoleCommandWithWorldAndArgs OnlineBackendCommand(
+		TEXT( "MultiplayerSessions.OnlineBackend" ),
+		TEXT( "세션 백엔드를 온라인 서브시스템으로 되돌립니다." ),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda( []( const TArray< FString >& args, UWorld* world )
+		{
+			UMultiPlayerSessionsSubsystem* subsystem = GetSubsystem( world );
+			if ( subsystem )
+			{
+				subsystem->SetSessionBackend( nullptr );
+			}
+		} ) );
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 생성자
+////////////////////////////////////////////////////////////////////////////
+UMultiPlayerSessionsSubsystem::UMultiPlayerSessionsSubsystem()
+	: m_SessionScorer( MakeShared< FMultiplayerPingScorer >() )
+	, m_MapPreloader( MakeShared< FMultiplayerMapPreloader >() )
+{
+	// 유니크 아이디 설정 ( 다른 빌드의 세션은 검색하지 않는다 )
+	m_HostAdvertisement.BuildId = 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 서브시스템을 초기화합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::Initialize( FSubsystemCollectionBase& collection )
+{
+	Super::Initialize( collection );
+
+	// 서브 시스템으로 부터 세션 관리가 가능한 세션 인터페이스 정보를 가져온다.
+	m_SessionInterface = FMultiplayerOnlineSessionBackend::Create();
+
+	// LAN 파티 / 사내 테스트 장비에서는 브로드캐스트 한 번 대신 여러 주소와 포트를 나눠서 동시에 탐색한다.
+	if ( m_SessionInterface.IsValid() && m_SessionInterface->IsLAN() )
+	{
+		const FMultiplayerLanDiscoveryConfig lanConfig = FMultiplayerLanDiscoveryConfig::Load();
+		if ( lanConfig.bEnabled )
+		{
+			m_SessionInterface = MultiplayerSessionsSubsystem::MakeLanBackend( this, lanConfig );
+		}
+	}
+
+	BindBackendDelegates();
+
+	if ( GConfig )
+	{
+		GConfig->GetBool( FMultiplayerDedicatedServerConfig::ConfigSection, TEXT( "bSearchDedicatedServers" ), m_SearchDedicatedServers, GGameIni );
+		GConfig->GetInt( TEXT( "MultiplayerSessions.Search" ), TEXT( "InitialSearchResults" ), m_InitialSearchResults, GGameIni );
+		GConfig->GetInt( TEXT( "MultiplayerSessions.Search" ), TEXT( "SearchResultsGrowth" ), m_SearchResultsGrowth, GGameIni );
+
+		SetAdaptiveSearchLimit( m_InitialSearchResults, m_SearchResultsGrowth );
+	}
+
+	m_QosConfig = FMultiplayerQosConfig::Load();
+
+	// 헤드리스 서버는 메뉴 없이 시작하므로 설정을 읽어 바로 세션을 등록한다.
+	if ( IsDedicatedServer() )
+	{
+		m_DedicatedServerConfig = FMultiplayerDedicatedServerConfig::Load();
+
+		if ( m_DedicatedServerConfig.bAutoRegister )
+		{
+			RegisterDedicatedServer();
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 서브시스템을 정리합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::Deinitialize()
+{
+	StopStreamingSearchTicker();
+	CancelSearchCacheRefresh();
+
+	if ( m_RegisterRetryTickerHandle.IsValid() )
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker( m_RegisterRetryTickerHandle );
+		m_RegisterRetryTickerHandle.Reset();
+	}
+
+	for ( TPair< FName, TUniquePtr< FMultiplayerSessionChannel > >& channel : m_SessionChannels )
+	{
+		StopJoinTimeoutTicker( *channel.Value );
+		StopBackfillTicker( *channel.Value );
+	}
+
+	// 측정 작업은 취소만 알리고, 에코 응답 스레드는 끝날 때까지 기다린다.
+	m_QosProber.Reset();
+	m_QosResponder.Reset();
+
+	UnbindBackendDelegates();
+
+	m_MapPreloader->Reset();
+
+	Super::Deinitialize();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 생성합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::CreateSession( int32 numPublicConnections, FString matchType )
+{
+	CreateSession( FMultiplayerSessionTarget(), numPublicConnections, MoveTemp( matchType ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 대상 세션을 생성합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::CreateSession( const FMultiplayerSessionTarget& target, int32 numPublicConnections, FString matchType )
+{
+	FMultiplayerSessionRequest request;
+	request.Op					 = EMultiplayerSessionOp::Create;
+	request.Target				 = target;
+	request.NumPublicConnections = numPublicConnections;
+	request.MatchType			 = MoveTemp( matchType );
+
+	QueueRequest( MoveTemp( request ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 찾습니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::FindSessions( int32 maxSearchResults, FName matchType )
+{
+	FindSessions( FMultiplayerSessionTarget(), maxSearchResults, matchType );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 대상 플레이어로 세션을 찾습니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::FindSessions( const FMultiplayerSessionTarget& target, int32 maxSearchResults, FName matchType )
+{
+	FMultiplayerSessionRequest request;
+	request.Op				 = EMultiplayerSessionOp::Find;
+	request.Target			 = target;
+	request.MaxSearchResults = maxSearchResults;
+	request.SearchMatchType	 = matchType;
+
+	QueueRequest( MoveTemp( request ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 찾으면서 도착한 결과를 pollInterval 마다 부분 결과로 전달합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::FindSessionsStreaming( int32 maxSearchResults, FName matchType, float pollInterval )
+{
+	FindSessionsStreaming( FMultiplayerSessionTarget(), maxSearchResults, matchType, pollInterval );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 대상 플레이어로 세션을 찾으면서 도착한 결과를 pollInterval 마다 부분 결과로 전달합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::FindSessionsStreaming( const FMultiplayerSessionTarget& target, int32 maxSearchResults, FName matchType, float pollInterval )
+{
+	FMultiplayerSessionRequest request;
+	request.Op				 = EMultiplayerSessionOp::Find;
+	request.Target			 = target;
+	request.MaxSearchResults = maxSearchResults;
+	request.SearchMatchType	 = matchType;
+	request.PollInterval	 = FMath::Max( pollInterval, KINDA_SMALL_NUMBER );
+
+	QueueRequest( MoveTemp( request ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 진행 중인 세션 찾기를 중단합니다. 완료 대리자는 더 이상 호출되지 않습니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::StopFindSessions()
+{
+	// 아직 시작하지 않은 검색은 대기열에서 뺀다.
+	m_SearchChannel.PendingRequests.Reset();
+
+	if ( EMultiplayerSessionOp::Find != m_SearchChannel.ActiveRequest.Op )
+		return;
+
+	StopStreamingSearchTicker();
+
+	// 검색 완료 대리자는 Finding 상태에서만 처리하므로 상태를 되돌리면 이후 완료는 무시된다.
+	if ( m_SessionInterface.IsValid() && EMultiplayerSessionState::Finding == m_SearchChannel.State )
+	{
+		m_SessionInterface->CancelFindSessions();
+	}
+
+	// 중단 전까지 도착한 결과는 참가 후보로 남으므로 인덱싱한 후 줄여 둔다.
+	if ( m_LastSessionSearch.IsValid() )
+	{
+		IndexNewSearchResults();
+		CompactSearchResults( *m_LastSessionSearch );
+	}
+
+	FinishRequest( m_SearchChannel, false );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 검색 결과 캐시를 무효화합니다. 다음 검색은 항상 백엔드에 요청합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::InvalidateSearchCache()
+{
+	m_LastSearchCompleteTime = 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 검색 결과 캐시 시간을 설정합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::SetSearchCacheTime( float ttl, float staleTime )
+{
+	m_SearchCacheTTL	   = FMath::Max( ttl, 0.f );
+	m_SearchCacheStaleTime = FMath::Max( staleTime, m_SearchCacheTTL );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션에 참가합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::JoinSession( const FOnlineSessionSearchResult& sessionResult )
+{
+	JoinSession( FMultiplayerSessionTarget(), sessionResult );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 대상 세션으로 참가합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::JoinSession( const FMultiplayerSessionTarget& target, const FOnlineSessionSearchResult& sessionResult )
+{
+	FMultiplayerSessionRequest request;
+	request.Op			  = EMultiplayerSessionOp::Join;
+	request.Target		  = target;
+	request.SessionResult = sessionResult;
+
+	QueueRequest( MoveTemp( request ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 마지막 검색 결과의 순위 후보에 차례로 참가를 시도합니다. 시도할 후보가 없으면 false
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::JoinBestSession( FName matchType, int32 maxAttempts, float attemptTimeout )
+{
+	return JoinBestSession( FMultiplayerSessionTarget(), matchType, maxAttempts, attemptTimeout );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 마지막 검색 결과의 순위 후보에 대상 세션으로 차례로 참가를 시도합니다. 시도할 후보가 없으면 false
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::JoinBestSession( const FMultiplayerSessionTarget& target, FName matchType, int32 maxAttempts, float attemptTimeout )
+{
+	// 순위는 실행 시점에 매기고, 여기서는 후보가 있는지만 인덱스로 확인한다.
+	if ( nullptr == FindIndexedSession( matchType ) )
+		return false;
+
+	FMultiplayerSessionRequest request;
+	request.Op				= EMultiplayerSessionOp::Join;
+	request.Target			= target;
+	request.SearchMatchType = matchType;
+	request.MaxAttempts		= maxAttempts;
+	request.AttemptTimeout	= attemptTimeout;
+
+	QueueRequest( MoveTemp( request ) );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 파괴합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::DestroySession()
+{
+	DestroySession( FMultiplayerSessionTarget() );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 대상 세션을 파괴합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::DestroySession( const FMultiplayerSessionTarget& target )
+{
+	FMultiplayerSessionRequest request;
+	request.Op	   = EMultiplayerSessionOp::Destroy;
+	request.Target = target;
+
+	QueueRequest( MoveTemp( request ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 시작합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::StartSession()
+{
+	StartSession( FMultiplayerSessionTarget() );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 대상 세션을 시작합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::StartSession( const FMultiplayerSessionTarget& target )
+{
+	FMultiplayerSessionRequest request;
+	request.Op	   = EMultiplayerSessionOp::Start;
+	request.Target = target;
+
+	QueueRequest( MoveTemp( request ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 호스팅 중인 세션의 빈 슬롯 수를 광고합니다. debounceDelay 안의 변경은 모아서 한 번만 갱신합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::SetOpenSlots( int32 numOpenSlots, FName sessionName, float debounceDelay )
+{
+	FMultiplayerSessionChannel& channel = FindOrAddChannel( sessionName );
+	channel.DesiredOpenSlots = FMath::Max( numOpenSlots, 0 );
+
+	// 로그인이 몰려도 간격마다 백엔드 갱신은 한 번만 한다.
+	if ( channel.BackfillTickerHandle.IsValid() )
+		return;
+
+	channel.BackfillTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject( this, &ThisClass::OnBackfillDebounceElapsed, sessionName ),
+		FMath::Max( debounceDelay, 0.f ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 마지막 검색 결과에서 MatchType 과 빈 슬롯 조건에 맞는 참가 후보를 반환합니다. 없으면 nullptr
+////////////////////////////////////////////////////////////////////////////
+const FOnlineSessionSearchResult* UMultiPlayerSessionsSubsystem::FindIndexedSession( FName matchType, int32 minOpenSlots ) const
+{
+	if ( !m_LastSessionSearch.IsValid() )
+		return nullptr;
+
+	const int32 index = m_LastSearchIndex.FindCandidate( matchType, minOpenSlots );
+	if ( !m_LastSessionSearch->SearchResults.IsValidIndex( index ) )
+		return nullptr;
+
+	return &m_LastSessionSearch->SearchResults[ index ];
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 마지막 검색 결과의 참가 후보들을 점수 순으로 최대 maxCandidates 개 선정합니다. 선정된 후보 수를 반환합니다.
+////////////////////////////////////////////////////////////////////////////
+int32 UMultiPlayerSessionsSubsystem::RankSessions( FName matchType, int32 maxCandidates, int32 minOpenSlots )
+{
+	m_RankedCandidates.Reset();
+
+	if ( !m_LastSessionSearch.IsValid() )
+		return 0;
+
+	// MatchType 과 빈 슬롯 필터는 인덱스로 처리하고, 남은 후보만 점수를 계산한다.
+	TArray< int32 > candidateIndices;
+	m_LastSearchIndex.GatherCandidates( matchType, minOpenSlots, candidateIndices );
+
+	FMultiplayerSessionRanker::SelectTopCandidates(
+		m_LastSessionSearch->SearchResults,
+		candidateIndices,
+		*m_SessionScorer,
+		maxCandidates,
+		m_RankedCandidates );
+
+	return m_RankedCandidates.Num();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 선정된 참가 후보 중 rank 번째 후보를 반환합니다. 없으면 nullptr
+////////////////////////////////////////////////////////////////////////////
+const FOnlineSessionSearchResult* UMultiPlayerSessionsSubsystem::GetRankedSession( int32 rank ) const
+{
+	if ( !m_LastSessionSearch.IsValid() || !m_RankedCandidates.IsValidIndex( rank ) )
+		return nullptr;
+
+	const int32 index = m_RankedCandidates[ rank ].ResultIndex;
+	if ( !m_LastSessionSearch->SearchResults.IsValidIndex( index ) )
+		return nullptr;
+
+	return &m_LastSessionSearch->SearchResults[ index ];
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 참가 후보 점수 계산 방식을 설정합니다. nullptr 이면 기본 핑 점수를 사용합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::SetSessionScorer( TSharedPtr< IMultiplayerSessionScorer > scorer )
+{
+	m_SessionScorer = scorer.IsValid() ? scorer : MakeShared< FMultiplayerPingScorer >();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 백엔드를 바꿉니다. nullptr 이면 온라인 서브시스템을 사용합니다. 진행 중인 작업이 있으면 false
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::SetSessionBackend( TSharedPtr< IMultiplayerSessionBackend > backend )
+{
+	// 진행 중인 작업의 완료는 이전 백엔드에서 오므로 유휴 상태에서만 바꾼다.
+	if ( IsBusy() )
+		return false;
+
+	CancelSearchCacheRefresh();
+	UnbindBackendDelegates();
+
+	m_SessionInterface = backend.IsValid() ? backend : FMultiplayerOnlineSessionBackend::Create();
+
+	BindBackendDelegates();
+
+	// 이전 백엔드의 검색 결과는 다시 쓰지 않는다.
+	ReleaseSessionSearch( m_LastSessionSearch );
+	m_PooledSessionSearch.Reset();
+	m_LastSearchIndex.Reset();
+	m_RankedCandidates.Reset();
+	m_NumIndexedResults = 0;
+	InvalidateSearchCache();
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 참가한 세션의 접속 주소를 얻습니다. 호스트가 광고한 세션 이름이 있으면 ?Session= 접속 옵션을 붙입니다.
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::GetResolvedConnectString( FString& outAddress, FName sessionName ) const
+{
+	if ( !m_SessionInterface.IsValid() || !m_SessionInterface->GetResolvedConnectString( sessionName, outAddress ) )
+		return false;
+
+	// 호스트가 여러 세션을 호스팅하는 경우 같은 주소로 접속하므로, 참가한 세션 이름을 접속 옵션으로 붙인다.
+	const FNamedOnlineSession* joinedSession = m_SessionInterface->GetNamedSession( sessionName );
+
+	FString hostSessionName;
+	if ( joinedSession && joinedSession->SessionSettings.Get( FMultiplayerSessionIndex::HostSessionKey, hostSessionName ) && !hostSessionName.IsEmpty() )
+	{
+		outAddress += FString::Printf( TEXT( "?Session=%s" ), *hostSessionName );
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 이동할 맵 패키지를 비동기로 미리 로드합니다. 해당 맵으로 이동이 끝나면 자동으로 놓아줍니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::PreloadMap( const FString& mapPath )
+{
+	m_MapPreloader->Preload( mapPath );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 맵 패키지가 미리 로드되어 있는지 여부
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::IsMapPreloaded( const FString& mapPath ) const
+{
+	return m_MapPreloader->IsLoaded( mapPath );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션의 최대 접속 수를 반환합니다. 세션이 없으면 0
+////////////////////////////////////////////////////////////////////////////
+int32 UMultiPlayerSessionsSubsystem::GetNumPublicConnections( FName sessionName ) const
+{
+	if ( !m_SessionInterface.IsValid() )
+		return 0;
+
+	const FNamedOnlineSession* existingSession = m_SessionInterface->GetNamedSession( sessionName );
+	if ( nullptr == existingSession )
+		return 0;
+
+	return existingSession->SessionSettings.NumPublicConnections;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션의 백엔드 호출 상태를 반환합니다.
+////////////////////////////////////////////////////////////////////////////
+EMultiplayerSessionState UMultiPlayerSessionsSubsystem::GetSessionState( FName sessionName ) const
+{
+	const FMultiplayerSessionChannel* channel = FindChannel( sessionName );
+	return channel ? channel->State : EMultiplayerSessionState::Idle;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 진행 중이거나 대기 중인 세션 작업이 있는지 여부 ( NAME_None 이면 모든 세션과 검색 )
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::IsBusy( FName sessionName ) const
+{
+	if ( NAME_None != sessionName )
+	{
+		const FMultiplayerSessionChannel* channel = FindChannel( sessionName );
+		return channel && channel->IsBusy();
+	}
+
+	if ( m_SearchChannel.IsBusy() )
+		return true;
+
+	for ( const TPair< FName, TUniquePtr< FMultiplayerSessionChannel > >& channel : m_SessionChannels )
+	{
+		if ( channel.Value->IsBusy() )
+			return true;
+	}
+
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 관리 중인 세션 이름들을 얻습니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::GetSessionNames( TArray< FName >& outSessionNames ) const
+{
+	m_SessionChannels.GetKeys( outSessionNames );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 데디케이티드 서버로 실행 중인지 여부
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::IsDedicatedServer() const
+{
+	if ( IsRunningDedicatedServer() )
+		return true;
+
+	// 에디터에서 데디케이티드 서버로 PIE 를 실행한 경우
+	const UWorld* world = GetWorld();
+	return world && NM_DedicatedServer == world->GetNetMode();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 이 프로세스가 호스팅하는 게임 세션 이름을 반환합니다.
+////////////////////////////////////////////////////////////////////////////
+FName UMultiPlayerSessionsSubsystem::GetHostedSessionName() const
+{
+	// 설정은 데디케이티드 서버에서만 읽으므로 그 외에는 기본값 NAME_GameSession 이다.
+	return m_DedicatedServerConfig.SessionName;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 게임 접속 포트를 반환합니다. 리슨 중이면 넷 드라이버가 연 포트, 아니면 월드 URL 의 포트 ( -port= 반영 )
+////////////////////////////////////////////////////////////////////////////
+int32 UMultiPlayerSessionsSubsystem::GetListenPort() const
+{
+	const UWorld* world = GetWorld();
+	if ( nullptr == world )
+		return 0;
+
+	// 요청한 포트가 사용 중이면 넷 드라이버가 다른 포트를 열 수 있다.
+	const UNetDriver* netDriver = world->GetNetDriver();
+	if ( netDriver && netDriver->GetLocalAddr().IsValid() && netDriver->GetLocalAddr()->GetPort() > 0 )
+		return netDriver->GetLocalAddr()->GetPort();
+
+	return world->URL.Port;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 설정에 따라 데디케이티드 서버 세션을 등록합니다. 로컬 플레이어 없이 bIsDedicated 세션을 만들고, 실패하면 다시 시도합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::RegisterDedicatedServer()
+{
+	UE_LOG( LogMultiplayerSessions, Log, TEXT( "Registering dedicated server session %s : %d connections, %s" ),
+		*m_DedicatedServerConfig.SessionName.ToString(), m_DedicatedServerConfig.NumPublicConnections, *m_DedicatedServerConfig.MatchType );
+
+	GetMultiplayerOnCreateSessionComplete( m_DedicatedServerConfig.SessionName ).AddUniqueDynamic( this, &ThisClass::OnDedicatedServerRegistered );
+
+	CreateSession(
+		FMultiplayerSessionTarget( m_DedicatedServerConfig.SessionName ),
+		m_DedicatedServerConfig.NumPublicConnections,
+		m_DedicatedServerConfig.MatchType );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// Presence 세션 대신 데디케이티드 서버를 검색할지 설정합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::SetSearchDedicatedServers( bool bSearchDedicatedServers )
+{
+	// 쿼리 키가 달라지므로 이전 검색 결과는 캐시로 재사용되지 않는다.
+	m_SearchDedicatedServers = bSearchDedicatedServers;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 이후 호스팅하는 세션에 광고할 지역과 실력 구간을 설정합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::SetHostAdvertisement( uint8 region, uint8 skillBand )
+{
+	m_HostAdvertisement.Region	  = region;
+	m_HostAdvertisement.SkillBand = skillBand;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 이후 호스팅하는 세션에 광고할 맵을 설정합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::SetHostMap( const FString& mapPath )
+{
+	m_HostMapName = FMultiplayerMapPreloader::GetMapPackageName( mapPath );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 백엔드에 보낼 검색 필터를 설정합니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::SetSearchFilters( int32 minOpenSlots, int32 region )
+{
+	// 쿼리 키가 달라지므로 이전 검색 결과는 캐시로 재사용되지 않는다.
+	m_SearchMinOpenSlots = FMath::Max( minOpenSlots, 0 );
+	m_SearchRegion		 = region;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 적응형 검색 결과 수를 설정합니다. initialSearchResults 개부터 찾고, 조건에 맞는 세션이 없을 때만 growth 배씩 넓힙니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::SetAdaptiveSearchLimit( int32 initialSearchResults, int32 growth )
+{
+	m_InitialSearchResults = FMath::Max( initialSearchResults, 0 );
+	m_SearchResultsGrowth  = FMath::Max( growth, 2 );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 참가 후보 QoS 측정 설정을 바꿉니다. 진행 중인 측정에는 적용되지 않습니다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::SetQosConfig( const FMultiplayerQosConfig& config )
+{
+	m_QosConfig = config;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 멀티플레이어 세션 생성 완료 대리자를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerOnCreateSessionComplete& UMultiPlayerSessionsSubsystem::GetMultiplayerOnCreateSessionComplete( FName sessionName )
+{
+	return FindOrAddChannel( sessionName ).OnCreateSessionComplete;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 멀티플레이어 세션 검색 완료 대리자를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerOnFindSessionsComplete& UMultiPlayerSessionsSubsystem::GetMultiplayerOnFindSessionsComplete()
+{
+	return m_MultiplayerOnFindSessionsComplete;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 멀티플레이어 세션 부분 검색 결과 대리자를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerOnFindSessionsPartial& UMultiPlayerSessionsSubsystem::GetMultiplayerOnFindSessionsPartial()
+{
+	return m_MultiplayerOnFindSessionsPartial;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 멀티플레이어 세션 참가 완료 대리자를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerOnJoinSessionComplete& UMultiPlayerSessionsSubsystem::GetMultiplayerOnJoinSessionComplete( FName sessionName )
+{
+	return FindOrAddChannel( sessionName ).OnJoinSessionComplete;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 멀티플레이어 세션 파괴 완료 대리자를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerOnDestroySessionComplete& UMultiPlayerSessionsSubsystem::GetMultiplayerOnDestroySessionComplete( FName sessionName )
+{
+	return FindOrAddChannel( sessionName ).OnDestroySessionComplete;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 멀티플레이어 세션 시작 완료 대리자를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerOnStartSessionComplete& UMultiPlayerSessionsSubsystem::GetMultiplayerOnStartSessionComplete( FName sessionName )
+{
+	return FindOrAddChannel( sessionName ).OnStartSessionComplete;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 생성이 완료되었을 때 처리한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::OnCreateSessionComplete( FName sessionName, bool bWasSuccessful )
+{
+	FMultiplayerSessionChannel* channel = FindChannel( sessionName );
+	if ( nullptr == channel || EMultiplayerSessionState::Creating != channel->State )
+		return;
+
+	++channel->NumCompletions;
+
+	// Broadcast our own custom delegate
+	FinishCreateSession( *channel, bWasSuccessful );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 갱신이 완료되었을 때 처리한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::OnUpdateSessionComplete( FName sessionName, bool bWasSuccessful )
+{
+	FMultiplayerSessionChannel* channel = FindChannel( sessionName );
+	if ( nullptr == channel || EMultiplayerSessionState::Updating != channel->State )
+		return;
+
+	++channel->NumCompletions;
+
+	// 빈 슬롯 갱신은 실패해도 다음 인원 변경 때 다시 갱신한다.
+	if ( EMultiplayerSessionOp::Update == channel->ActiveRequest.Op )
+	{
+		FinishRequest( *channel );
+		return;
+	}
+
+	if ( bWasSuccessful )
+	{
+		// 재호스팅은 생성 완료와 같은 결과로 전달한다.
+		FinishCreateSession( *channel, true );
+		return;
+	}
+
+	// 갱신이 실패하면 기존처럼 파괴 후 다시 생성한다.
+	channel->bCreateSessionOnDestroy = true;
+	if ( !BeginDestroySession( *channel ) )
+	{
+		channel->bCreateSessionOnDestroy = false;
+		FinishCreateSession( *channel, false );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 검색이 완료되었을 때 처리한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::OnFindSessionsComplete( bool bwasSuccessful )
+{
+	// 검색 완료 대리자는 하나이므로, 끝난 검색 객체로 백그라운드 갱신과 일반 검색을 구분한다.
+	if ( m_RefreshSessionSearch.IsValid() && EOnlineAsyncTaskState::InProgress != m_RefreshSessionSearch->SearchState )
+	{
+		OnRefreshSessionsComplete( bwasSuccessful );
+		return;
+	}
+
+	// 중단된 검색의 뒤늦은 완료는 무시한다.
+	if ( EMultiplayerSessionState::Finding != m_SearchChannel.State || !m_LastSessionSearch.IsValid() )
+		return;
+
+	// 백그라운드 갱신을 취소한 직후 새 검색을 시작했으면, 취소된 갱신의 완료가 먼저 올 수 있다.
+	// 백엔드는 완료를 알리기 전에 검색 상태를 바꾸므로, 아직 진행 중인 검색이면 이 완료는 그 검색의 것이 아니다.
+	if ( EOnlineAsyncTaskState::InProgress == m_LastSessionSearch->SearchState )
+		return;
+
+	++m_SearchChannel.NumCompletions;
+
+	StopStreamingSearchTicker();
+
+	m_LastSearchCompleteTime = bwasSuccessful ? FPlatformTime::Seconds() : 0.0;
+
+	if ( m_LastSessionSearch->SearchResults.Num() <= 0 )
+	{
+		// 찾은 세션 정보가 없을경우 실패 처리.
+		FinishFindSessions( TArray<FOnlineSessionSearchResult>(), false );
+		return;
+	}
+
+	// MatchType / 빈 슬롯 기준 인덱스를 한 번만 만들어 둔다. ( 스트리밍 중 반영된 결과는 건너뛴다 )
+	IndexNewSearchResults();
+
+	// 적은 결과 수로 시작했으므로 조건에 맞는 세션이 없을 때만 넓혀서 다시 찾는다.
+	if ( bwasSuccessful && WidenSessionSearch() )
+		return;
+
+	// 다음 검색까지 남겨 둘 결과는 참가에 필요한 정보만 남긴다.
+	CompactSearchResults( *m_LastSessionSearch );
+
+	// Broadcast our own custom delegate
+	FinishFindSessions( m_LastSessionSearch->SearchResults, bwasSuccessful );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 검색 캐시 갱신이 완료되었을 때 처리한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::OnRefreshSessionsComplete( bool bWasSuccessful )
+{
+	TSharedPtr< FOnlineSessionSearch > refreshedSearch = MoveTemp( m_RefreshSessionSearch );
+	m_RefreshSessionSearch.Reset();
+
+	if ( !bWasSuccessful || !refreshedSearch.IsValid() || refreshedSearch->SearchResults.Num() <= 0 )
+		return;
+
+	// 참가 중인 세션은 자기 후보 검색을 따로 들고 있으므로 바로 바꿔도 된다.
+	ReleaseSessionSearch( m_LastSessionSearch );
+	m_LastSessionSearch = refreshedSearch;
+	m_LastSearchIndex.Reset();
+	m_RankedCandidates.Reset();
+	m_NumIndexedResults = 0;
+
+	IndexNewSearchResults();
+	CompactSearchResults( *m_LastSessionSearch );
+
+	m_LastSearchCompleteTime = FPlatformTime::Seconds();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 합류가 완료되었을 때 처리한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::OnJoinSessionComplete( FName sessionName, EOnJoinSessionCompleteResult::Type result )
+{
+	FMultiplayerSessionChannel* channel = FindChannel( sessionName );
+	if ( nullptr == channel || EMultiplayerSessionState::Joining != channel->State )
+		return;
+
+	++channel->NumCompletions;
+
+	StopJoinTimeoutTicker( *channel );
+
+	if ( !channel->bJoinFailover )
+	{
+		channel->OnJoinSessionComplete.Broadcast( result );
+		FinishRequest( *channel );
+		return;
+	}
+
+	// 가득 찼거나 없어졌거나 주소를 얻지 못한 후보는 건너뛰고 다음 후보에 바로 참가를 시도한다.
+	if ( IsRetryableJoinResult( result ) && TryNextJoinCandidate( *channel ) )
+		return;
+
+	FinishJoinFailover( *channel, result );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 파괴가 완료되었을 때 처리한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::OnDestroySessionComplete( FName sessionName, bool bwasSuccessful )
+{
+	FMultiplayerSessionChannel* channel = FindChannel( sessionName );
+	if ( nullptr == channel || EMultiplayerSessionState::Destroying != channel->State )
+		return;
+
+	++channel->NumCompletions;
+
+	// 재생성을 위한 파괴였다면 생성 요청을 이어서 처리한다.
+	if ( channel->bCreateSessionOnDestroy )
+	{
+		channel->bCreateSessionOnDestroy = false;
+
+		if ( bwasSuccessful )
+		{
+			ExecuteCreateSession( *channel, channel->LastNumPublicConnections, channel->LastMatchType );
+		}
+		else
+		{
+			FinishCreateSession( *channel, false );
+		}
+
+		return;
+	}
+
+	// 시간 초과된 참가 시도를 정리했으면 다음 후보로 넘어간다.
+	if ( channel->bJoinNextOnDestroy )
+	{
+		channel->bJoinNextOnDestroy = false;
+
+		if ( !TryNextJoinCandidate( *channel ) )
+		{
+			FinishJoinFailover( *channel, EOnJoinSessionCompleteResult::UnknownError );
+		}
+
+		return;
+	}
+
+	channel->OnDestroySessionComplete.Broadcast( bwasSuccessful );
+	FinishRequest( *channel );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 시작이 완료되었을 때 처리한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::OnStartSessionComplete( FName sessionName, bool bwasSuccessful )
+{
+	FMultiplayerSessionChannel* channel = FindChannel( sessionName );
+	if ( nullptr == channel || EMultiplayerSessionState::Starting != channel->State )
+		return;
+
+	++channel->NumCompletions;
+
+	channel->OnStartSessionComplete.Broadcast( bwasSuccessful );
+
+	FinishRequest( *channel );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 데디케이티드 서버 세션 등록 결과를 처리한다. [ Delegator 로부터 전달받아 호출된 함수 ]
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::OnDedicatedServerRegistered( bool bWasSuccessful )
+{
+	GetMultiplayerOnCreateSessionComplete( m_DedicatedServerConfig.SessionName ).RemoveDynamic( this, &ThisClass::OnDedicatedServerRegistered );
+
+	if ( bWasSuccessful )
+	{
+		UE_LOG( LogMultiplayerSessions, Log, TEXT( "Dedicated server session %s registered" ), *m_DedicatedServerConfig.SessionName.ToString() );
+		m_NumRegisterRetries = 0;
+		return;
+	}
+
+	// 온라인 서비스가 아직 준비되지 않았을 수 있으므로 서버를 내리지 않고 다시 시도한다.
+	const bool bCanRetry = m_DedicatedServerConfig.MaxRetries < 0 || m_NumRegisterRetries < m_DedicatedServerConfig.MaxRetries;
+	if ( !bCanRetry || m_RegisterRetryTickerHandle.IsValid() )
+	{
+		UE_LOG( LogMultiplayerSessions, Error, TEXT( "Dedicated server session %s registration failed" ), *m_DedicatedServerConfig.SessionName.ToString() );
+		return;
+	}
+
+	++m_NumRegisterRetries;
+
+	UE_LOG( LogMultiplayerSessions, Warning, TEXT( "Dedicated server session registration failed. Retry %d in %.1fs" ), m_NumRegisterRetries, m_DedicatedServerConfig.RetryDelay );
+
+	m_RegisterRetryTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject( this, &ThisClass::OnRegisterRetryElapsed ),
+		m_DedicatedServerConfig.RetryDelay );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 백엔드에 완료 대리자를 등록한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::BindBackendDelegates()
+{
+	if ( !m_SessionInterface.IsValid() )
+		return;
+
+	// 완료는 세션 이름으로 채널을 찾아 처리하므로 작업마다 등록 / 해제하지 않는다.
+	m_CreateSessionCompleteDelegateHandle = m_SessionInterface->AddOnCreateSessionCompleteDelegate_Handle(
+		FOnCreateSessionCompleteDelegate::CreateUObject( this, &ThisClass::OnCreateSessionComplete ) );
+
+	m_FindSessionCompleteDelegateHandle = m_SessionInterface->AddOnFindSessionsCompleteDelegate_Handle(
+		FOnFindSessionsCompleteDelegate::CreateUObject( this, &ThisClass::OnFindSessionsComplete ) );
+
+	m_JoinSessionCompleteDelegateHandle = m_SessionInterface->AddOnJoinSessionCompleteDelegate_Handle(
+		FOnJoinSessionCompleteDelegate::CreateUObject( this, &ThisClass::OnJoinSessionComplete ) );
+
+	m_UpdateSessionCompleteDelegateHandle = m_SessionInterface->AddOnUpdateSessionCompleteDelegate_Handle(
+		FOnUpdateSessionCompleteDelegate::CreateUObject( this, &ThisClass::OnUpdateSessionComplete ) );
+
+	m_DestroySessionCompleteDelegateHandle = m_SessionInterface->AddOnDestroySessionCompleteDelegate_Handle(
+		FOnDestroySessionCompleteDelegate::CreateUObject( this, &ThisClass::OnDestroySessionComplete ) );
+
+	m_StartSessionCompleteDelegateHandle = m_SessionInterface->AddOnStartSessionCompleteDelegate_Handle(
+		FOnStartSessionCompleteDelegate::CreateUObject( this, &ThisClass::OnStartSessionComplete ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 백엔드에 등록한 완료 대리자를 해제한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::UnbindBackendDelegates()
+{
+	if ( !m_SessionInterface.IsValid() )
+		return;
+
+	m_SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle( m_CreateSessionCompleteDelegateHandle );
+	m_SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle( m_FindSessionCompleteDelegateHandle );
+	m_SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle( m_JoinSessionCompleteDelegateHandle );
+	m_SessionInterface->ClearOnUpdateSessionCompleteDelegate_Handle( m_UpdateSessionCompleteDelegateHandle );
+	m_SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle( m_DestroySessionCompleteDelegateHandle );
+	m_SessionInterface->ClearOnStartSessionCompleteDelegate_Handle( m_StartSessionCompleteDelegateHandle );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 이름의 채널을 반환한다. 없으면 만든다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerSessionChannel& UMultiPlayerSessionsSubsystem::FindOrAddChannel( FName sessionName )
+{
+	TUniquePtr< FMultiplayerSessionChannel >& channel = m_SessionChannels.FindOrAdd( sessionName );
+	if ( !channel.IsValid() )
+	{
+		// 채널은 힙에 두어 맵이 커져도 완료 콜백이 들고 있는 참조가 유지된다.
+		channel = MakeUnique< FMultiplayerSessionChannel >();
+		channel->SessionName = sessionName;
+	}
+
+	return *channel;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 이름의 채널을 반환한다. 없으면 nullptr
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerSessionChannel* UMultiPlayerSessionsSubsystem::FindChannel( FName sessionName ) const
+{
+	const TUniquePtr< FMultiplayerSessionChannel >* channel = m_SessionChannels.Find( sessionName );
+	return channel ? channel->Get() : nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 요청을 보낼 플레이어를 정한다. 대상에 플레이어가 없으면 첫 번째 로컬 플레이어
+////////////////////////////////////////////////////////////////////////////
+FUniqueNetIdPtr UMultiPlayerSessionsSubsystem::ResolvePlayerId( const FMultiplayerSessionTarget& target ) const
+{
+	if ( target.PlayerId.IsValid() )
+		return target.PlayerId;
+
+	// 월드로부터 로컬플레이어 정보를 가져온다. 각 로컬 플레이어는 고유의 Id값을 가진다.
+	const UWorld* world = GetWorld();
+	const ULocalPlayer* localPlayer = world ? world->GetFirstLocalPlayerFromController() : nullptr;
+	if ( nullptr == localPlayer )
+		return nullptr;
+
+	return localPlayer->GetPreferredUniqueNetId().GetUniqueNetId();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 요청을 대기열에 넣는다. 진행 중이거나 대기 중인 같은 요청이 있으면 합친다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::QueueRequest( FMultiplayerSessionRequest&& request )
+{
+	// 검색은 세션과 무관하게 한 대기열에서, 나머지는 세션 이름별 대기열에서 처리한다.
+	FMultiplayerSessionChannel& channel = EMultiplayerSessionOp::Find == request.Op
+		? m_SearchChannel
+		: FindOrAddChannel( request.Target.SessionName );
+
+	// 진행 중인 작업과 같은 결과를 내는 요청은 그 작업의 완료 대리자로 결과를 받는다.
+	if ( request.IsDuplicateOf( channel.ActiveRequest ) )
+		return;
+
+	// 바로 앞 요청이 아직 시작하지 않은 같은 종류의 요청이면 마지막 요청 내용으로 바꾼다.
+	// 사이에 다른 요청이 끼어 있으면 순서가 바뀌므로 합치지 않는다. ( 생성 → 파괴 → 생성 )
+	if ( channel.PendingRequests.Num() > 0 )
+	{
+		FMultiplayerSessionRequest& lastRequest = channel.PendingRequests.Last();
+		if ( lastRequest.Op == request.Op && lastRequest.Target.IsSamePlayer( request.Target ) )
+		{
+			lastRequest = MoveTemp( request );
+			return;
+		}
+	}
+
+	channel.PendingRequests.Add( MoveTemp( request ) );
+
+	ProcessNextRequest( channel );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 진행 중인 작업이 없으면 대기열의 다음 요청을 실행한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::ProcessNextRequest( FMultiplayerSessionChannel& channel )
+{
+	// 완료 콜백 안에서 다시 불린 경우 바깥 루프가 이어서 처리한다.
+	if ( channel.bIsProcessingRequests )
+		return;
+
+	TGuardValue< bool > processingGuard( channel.bIsProcessingRequests, true );
+
+	while ( EMultiplayerSessionOp::None == channel.ActiveRequest.Op && channel.PendingRequests.Num() > 0 )
+	{
+		channel.ActiveRequest = MoveTemp( channel.PendingRequests[ 0 ] );
+		channel.PendingRequests.RemoveAt( 0 );
+
+		channel.ActiveRequestStartTime = FPlatformTime::Seconds();
+
+		ExecuteRequest( channel );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 진행 중인 요청을 끝내고 다음 요청으로 넘어간다. 취소된 요청은 지연 시간을 기록하지 않는다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::FinishRequest( FMultiplayerSessionChannel& channel, bool bRecordLatency )
+{
+	// 요청 실행부터 완료 대리자 호출까지의 시간 ( 백엔드 왕복과 내부 재시도 포함 )
+	if ( bRecordLatency )
+	{
+		FMultiplayerSessionStats::Get().Record( channel.ActiveRequest.Op, FPlatformTime::Seconds() - channel.ActiveRequestStartTime );
+	}
+
+	channel.ActiveRequest = FMultiplayerSessionRequest();
+	channel.State		  = EMultiplayerSessionState::Idle;
+	channel.PlayerId.Reset();
+
+	ProcessNextRequest( channel );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 요청을 실행한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::ExecuteRequest( FMultiplayerSessionChannel& channel )
+{
+	const FMultiplayerSessionRequest& request = channel.ActiveRequest;
+
+	channel.PlayerId = ResolvePlayerId( request.Target );
+
+	switch ( request.Op )
+	{
+	case EMultiplayerSessionOp::Create:
+		ExecuteCreateSession( channel, request.NumPublicConnections, request.MatchType );
+		break;
+
+	case EMultiplayerSessionOp::Find:
+		ExecuteFindSessions( request.MaxSearchResults, request.SearchMatchType, request.PollInterval );
+		break;
+
+	case EMultiplayerSessionOp::Join:
+		ExecuteJoinSession( channel );
+		break;
+
+	case EMultiplayerSessionOp::Destroy:
+		if ( !BeginDestroySession( channel ) )
+		{
+			channel.OnDestroySessionComplete.Broadcast( false );
+			FinishRequest( channel );
+		}
+		break;
+
+	case EMultiplayerSessionOp::Start:
+		if ( !BeginStartSession( channel ) )
+		{
+			channel.OnStartSessionComplete.Broadcast( false );
+			FinishRequest( channel );
+		}
+		break;
+
+	case EMultiplayerSessionOp::Update:
+		ExecuteUpdateSession( channel );
+		break;
+
+	default:
+		FinishRequest( channel );
+		break;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 생성 요청을 실행한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::ExecuteCreateSession( FMultiplayerSessionChannel& channel, int32 numPublicConnections, const FString& matchType )
+{
+	// 데디케이티드 서버에는 로컬 플레이어가 없으므로 플레이어 없이 세션을 만든다.
+	const bool bIsDedicated = IsDedicatedServer();
+
+	if ( !m_SessionInterface.IsValid() || ( !bIsDedicated && !channel.PlayerId.IsValid() ) )
+	{
+		FinishCreateSession( channel, false );
+		return;
+	}
+
+	// 이미 세션이 존재할 경우 삭제 후 다시 설정.
+	auto existingSession = m_SessionInterface->GetNamedSession( channel.SessionName );
+	if ( nullptr != existingSession )
+	{
+		channel.LastNumPublicConnections = numPublicConnections;
+		channel.LastMatchType = matchType;
+
+		// 접속 수나 MatchType 만 바뀐 경우 세션을 유지한 채 설정만 갱신한다. ( 백엔드 왕복 1 회 )
+		if ( CanUpdateSessionInPlace( *existingSession, numPublicConnections )
+			&& UpdateSessionInPlace( channel, *existingSession, numPublicConnections, matchType ) )
+			return;
+
+		channel.bCreateSessionOnDestroy = true;
+
+		// 세션 파괴 후 생성을 할경우 파괴 요청 시 서버와의 통신 딜레이 시간때문에, 이미 존재하는 세션이라. 문제가 발생함
+		// 세션 파괴 완료 후 세션 시작하도록 처리.
+		if ( !BeginDestroySession( channel ) )
+		{
+			channel.bCreateSessionOnDestroy = false;
+			FinishCreateSession( channel, false );
+		}
+
+		return;
+	}
+
+	channel.LastSessionSettings = MakeShareable( new FOnlineSessionSettings() );
+	
+	// 테스트 용도일경우  SubSystemName == NuLL, 
+	// 테스트 아닐경우 Ex SubSystemName == Steam - ex
+	channel.LastSessionSettings->bIsLANMatch = m_SessionInterface->IsLAN();
+	// Connection Count
+	channel.LastSessionSettings->NumPublicConnections = numPublicConnections;
+
+	channel.LastSessionSettings->bAllowJoinInProgress	= true;
+	channel.LastSessionSettings->bShouldAdvertise		= true;   //광고
+	channel.LastSessionSettings->BuildUniqueId			= m_HostAdvertisement.BuildId;		// 유니크 아이디 설정
+
+	// 데디케이티드 서버는 로그인한 유저가 없으므로 Presence / 로비 대신 게임 서버로 광고한다.
+	channel.LastSessionSettings->bIsDedicated			= bIsDedicated;
+	channel.LastSessionSettings->bAllowJoinViaPresence	= !bIsDedicated;
+	channel.LastSessionSettings->bUsesPresence			= !bIsDedicated;
+	channel.LastSessionSettings->bUseLobbiesIfAvailable	= !bIsDedicated;
+
+	WriteAdvertisement( *channel.LastSessionSettings, matchType, numPublicConnections );
+	channel.LastSessionSettings->Set( FMultiplayerSessionIndex::HostSessionKey, channel.SessionName.ToString(), EOnlineDataAdvertisementType::ViaOnlineService );
+
+	channel.State = EMultiplayerSessionState::Creating;
+
+	const uint32 numCompletions = channel.NumCompletions;
+
+	// 세션 생성 
+	const bool bRequested = bIsDedicated
+		? m_SessionInterface->CreateSession( 0, channel.SessionName, *channel.LastSessionSettings )
+		: m_SessionInterface->CreateSession( *channel.PlayerId, channel.SessionName, *channel.LastSessionSettings );
+
+	if ( !bRequested && numCompletions == channel.NumCompletions )
+	{
+		// 세션 생성이 실패할 경우.
+		// Broadcast our own custom delegate
+		FinishCreateSession( channel, false );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 찾기 요청을 실행한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::ExecuteFindSessions( int32 maxSearchResults, FName matchType, float pollInterval )
+{
+	if ( !m_SessionInterface.IsValid() || !m_SearchChannel.PlayerId.IsValid() )
+	{
+		FinishFindSessions( TArray<FOnlineSessionSearchResult>(), false );
+		return;
+	}
+
+	const FMultiplayerSessionQueryKey queryKey = MakeSearchQueryKey( matchType );
+
+	// 같은 조건으로 최근에 검색한 결과가 있으면 백엔드에 다시 요청하지 않는다.
+	const double cacheAge = GetSearchCacheAge( queryKey, maxSearchResults );
+	if ( cacheAge >= 0.0 && cacheAge < m_SearchCacheStaleTime )
+	{
+		// TTL 이 지났으면 우선 캐시로 응답하고, 다음 요청을 위해 뒤에서 다시 검색해 둔다.
+		if ( cacheAge >= m_SearchCacheTTL )
+		{
+			RefreshSearchCache();
+		}
+
+		// 캐시 응답이 섞이면 Find 지연 시간 백분위가 실제 백엔드 검색보다 낮게 나온다.
+		FinishFindSessions( m_LastSessionSearch->SearchResults, true, false );
+		return;
+	}
+
+	// 새로 검색하므로 진행 중인 백그라운드 검색은 취소한다.
+	CancelSearchCacheRefresh();
+
+	m_LastSearchKey		   = queryKey;
+	m_LastSearchMaxResults = maxSearchResults;
+
+	// 대부분은 처음 받은 결과에서 참가할 세션을 찾으므로 적은 수로 시작한다.
+	const int32 searchResults = m_InitialSearchResults > 0 ? FMath::Min( m_InitialSearchResults, maxSearchResults ) : maxSearchResults;
+
+	BeginSessionSearch( searchResults, pollInterval );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 마지막 검색 조건으로 maxSearchResults 개까지 세션 찾기를 요청한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::BeginSessionSearch( int32 maxSearchResults, float pollInterval )
+{
+	m_LastSearchIndex.Reset();
+	m_RankedCandidates.Reset();
+	m_NumIndexedResults = 0;
+
+	m_LastSearchCompleteTime = 0.0;
+
+	ReleaseSessionSearch( m_LastSessionSearch );
+	m_LastSessionSearch = MakeSessionSearch( maxSearchResults, m_LastSearchKey );
+
+	m_SearchChannel.State = EMultiplayerSessionState::Finding;
+	
+	const uint32 numCompletions = m_SearchChannel.NumCompletions;
+
+	// 세션 찾기
+	if ( !m_SessionInterface->FindSessions( *m_SearchChannel.PlayerId, m_LastSessionSearch.ToSharedRef() ) )
+	{
+		//BroadCast Delegate
+		if ( numCompletions == m_SearchChannel.NumCompletions )
+		{
+			FinishFindSessions( TArray<FOnlineSessionSearchResult>(), false );
+		}
+
+		return;
+	}
+
+	// 완료 대리자가 이미 처리했으면 폴링할 검색이 없다.
+	if ( numCompletions != m_SearchChannel.NumCompletions )
+		return;
+
+	if ( pollInterval > 0.f )
+	{
+		// Null / LAN / 가짜 백엔드는 결과가 도착하는 대로 SearchResults 에 추가하므로,
+		// 완료를 기다리지 않고 주기적으로 새 결과를 확인해서 전달한다.
+		// Steam 은 완료 직전에 한 번에 채우므로 폴링해도 새 결과가 없고, 결과는 완료 대리자로만 받는다.
+		m_StreamingSearchTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateUObject( this, &ThisClass::TickStreamingSearch ),
+			pollInterval );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 조건에 맞는 세션이 없고 결과가 제한에 걸렸다면 결과 수를 넓혀 다시 검색한다. 다시 검색하면 true
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::WidenSessionSearch()
+{
+	const FMultiplayerSessionRequest& request = m_SearchChannel.ActiveRequest;
+
+	const int32 searchResults = m_LastSessionSearch->MaxSearchResults;
+	if ( searchResults >= m_LastSearchMaxResults )
+		return false;
+
+	// 제한보다 적게 받았다면 넓혀도 더 찾을 세션이 없다.
+	if ( m_LastSessionSearch->SearchResults.Num() < searchResults )
+		return false;
+
+	// MatchType 을 지정하지 않은 검색은 받은 결과 중 아무 세션이나 후보가 된다.
+	if ( request.SearchMatchType.IsNone() || INDEX_NONE != m_LastSearchIndex.FindCandidate( request.SearchMatchType, m_SearchMinOpenSlots ) )
+		return false;
+
+	// 백엔드는 이어받기를 지원하지 않아 앞쪽 결과를 다시 받지만, 배율로 넓히므로 전체 전송량은 마지막 검색의 상수 배 이내다.
+	const int32 widenedResults = static_cast< int32 >( FMath::Min< int64 >( static_cast< int64 >( searchResults ) * m_SearchResultsGrowth, m_LastSearchMaxResults ) );
+
+	UE_LOG( LogMultiplayerSessions, Verbose, TEXT( "No joinable session in %d results, widening search to %d" ), searchResults, widenedResults );
+
+	BeginSessionSearch( widenedResults, request.PollInterval );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 참가 요청을 실행한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::ExecuteJoinSession( FMultiplayerSessionChannel& channel )
+{
+	const FMultiplayerSessionRequest& request = channel.ActiveRequest;
+
+	// 지정된 세션 하나에만 참가한다.
+	if ( request.SessionResult.IsSet() )
+	{
+		channel.bJoinFailover = false;
+
+		if ( !BeginJoinSession( channel, request.SessionResult.GetValue() ) )
+		{
+			channel.OnJoinSessionComplete.Broadcast( EOnJoinSessionCompleteResult::UnknownError );
+			FinishRequest( channel );
+		}
+
+		return;
+	}
+
+	// 검색을 다시 하지 않고 남은 후보로 바로 재시도한다.
+	// 후보는 채널에 복사해 두어 다른 세션의 순위 계산이나 캐시 갱신과 섞이지 않게 한다.
+	// 핑을 측정하면 검색이 알려준 핑과 순위가 달라질 수 있으므로 시도 수보다 넓게 뽑아 둔다.
+	RankSessions( request.SearchMatchType, m_QosConfig.bEnabled ? FMath::Max( request.MaxAttempts, m_QosConfig.MaxCandidates ) : request.MaxAttempts );
+
+	channel.bJoinFailover	   = true;
+	channel.JoinSearch		   = m_LastSessionSearch;
+	channel.JoinCandidates	   = m_RankedCandidates;
+	channel.JoinCandidateRank  = INDEX_NONE;
+	channel.JoinAttemptsLeft   = FMath::Min( channel.JoinCandidates.Num(), request.MaxAttempts );
+	channel.JoinAttemptTimeout = request.AttemptTimeout;
+
+	if ( BeginSessionQos( channel ) )
+		return;
+
+	if ( !TryNextJoinCandidate( channel ) )
+	{
+		FinishJoinFailover( channel, EOnJoinSessionCompleteResult::UnknownError );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 파괴를 요청한다. 요청이 실패하면 false
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::BeginDestroySession( FMultiplayerSessionChannel& channel )
+{
+	if ( !m_SessionInterface.IsValid() )
+		return false;
+
+	channel.State = EMultiplayerSessionState::Destroying;
+
+	const uint32 numCompletions = channel.NumCompletions;
+	if ( m_SessionInterface->DestroySession( channel.SessionName ) )
+		return true;
+
+	// 실패를 완료 대리자로 이미 알린 백엔드도 있으므로 두 번 처리하지 않는다.
+	return numCompletions != channel.NumCompletions;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 시작을 요청한다. 요청이 실패하면 false
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::BeginStartSession( FMultiplayerSessionChannel& channel )
+{
+	if ( !m_SessionInterface.IsValid() )
+		return false;
+
+	// 대기 중인 세션만 시작할 수 있다. ( 이미 시작된 세션은 다시 시작하지 않는다 )
+	const FNamedOnlineSession* existingSession = m_SessionInterface->GetNamedSession( channel.SessionName );
+	if ( nullptr == existingSession || EOnlineSessionState::Pending != existingSession->SessionState )
+		return false;
+
+	channel.State = EMultiplayerSessionState::Starting;
+
+	const uint32 numCompletions = channel.NumCompletions;
+	if ( m_SessionInterface->StartSession( channel.SessionName ) )
+		return true;
+
+	return numCompletions != channel.NumCompletions;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 빈 슬롯 갱신 요청을 실행한다.
 ////////////////////////////////////////////////////////////////////////////
-/// 생성자
+void UMultiPlayerSessionsSubsystem::ExecuteUpdateSession( FMultiplayerSessionChannel& channel )
+{
+	FNamedOnlineSession* existingSession = m_SessionInterface.IsValid() ? m_SessionInterface->GetNamedSession( channel.SessionName ) : nullptr;
+	if ( nullptr == existingSession || !existingSession->bHosting )
+	{
+		FinishRequest( channel, false );
+		return;
+	}
+
+	const int32 numOpenSlots		  = FMath::Min( channel.ActiveRequest.NumOpenSlots, existingSession->SessionSettings.NumPublicConnections );
+	const uint8 advertisedOpenSlots	  = static_cast< uint8 >( FMath::Min( numOpenSlots, static_cast< int32 >( MAX_uint8 ) ) );
+	const bool bShouldAdvertise		  = numOpenSlots > 0;
+
+	// 세션 설정은 갱신이 성공해야 바뀌므로, 이 서브시스템이 마지막으로 광고한 값이다.
+	// ( 세션의 NumOpenPublicConnections 는 온라인 서브시스템이 등록된 플레이어로 관리하므로 비교하지 않는다 )
+	FMultiplayerSessionAdvertisement advertisement;
+	const bool bHasAdvertisement = FMultiplayerSessionAdvertisement::Read( existingSession->SessionSettings, advertisement );
+
+	// 광고 내용이 그대로면 백엔드에 보내지 않는다.
+	if ( existingSession->SessionSettings.bShouldAdvertise == bShouldAdvertise
+		&& ( !bHasAdvertisement || advertisement.OpenSlots == advertisedOpenSlots ) )
+	{
+		FinishRequest( channel, false );
+		return;
+	}
+
+	// 가득 찬 로비는 검색에 나오지 않게 해서, 검색하는 쪽이 참가에 실패할 후보를 받지 않도록 한다.
+	channel.LastSessionSettings = MakeShared< FOnlineSessionSettings >( existingSession->SessionSettings );
+	channel.LastSessionSettings->bShouldAdvertise = bShouldAdvertise;
+
+	if ( bHasAdvertisement )
+	{
+		advertisement.OpenSlots = advertisedOpenSlots;
+		advertisement.Write( *channel.LastSessionSettings );
+	}
+
+	channel.State = EMultiplayerSessionState::Updating;
+
+	const uint32 numCompletions = channel.NumCompletions;
+	if ( !m_SessionInterface->UpdateSession( channel.SessionName, *channel.LastSessionSettings )
+		&& numCompletions == channel.NumCompletions )
+	{
+		FinishRequest( channel );
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////
-UMultiPlayerSessionsSubsystem::UMultiPlayerSessionsSubsystem()
-	: m_CreateSessionCompleteDelegate	( FOnCreateSessionCompleteDelegate::CreateUObject( this, &ThisClass::OnCreateSessionComplete	) ),
-	  m_FindSessionCompleteDelegate		( FOnFindSessionsCompleteDelegate::CreateUObject( this, &ThisClass::OnFindSessionsComplete		) ),
-	  m_JoinSessionCompleteDelegate		( FOnJoinSessionCompleteDelegate::CreateUObject( this, &ThisClass::OnJoinSessionComplete		) ),
- 	  m_DestroySessionCompleteDelegate	( FOnDestroySessionCompleteDelegate::CreateUObject( this, &ThisClass::OnDestroySessionComplete  ) ),
- 	  m_StartSessionCompleteDelegate	( FOnStartSessionCompleteDelegate::CreateUObject( this, &ThisClass::OnStartSessionComplete		) )
+/// 빈 슬롯 갱신을 모으는 시간이 지났을 때 처리한다.
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::OnBackfillDebounceElapsed( float deltaTime, FName sessionName )
+{
+	FMultiplayerSessionChannel* channel = FindChannel( sessionName );
+	if ( nullptr == channel )
+		return false;
+
+	channel->BackfillTickerHandle.Reset();
+
+	// 대기 중인 갱신이 있으면 마지막 값으로 바뀐다.
+	FMultiplayerSessionRequest request;
+	request.Op			 = EMultiplayerSessionOp::Update;
+	request.Target		 = FMultiplayerSessionTarget( sessionName );
+	request.NumOpenSlots = channel->DesiredOpenSlots;
+
+	QueueRequest( MoveTemp( request ) );
+
+	// 한 번만 호출되는 티커
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 생성 요청을 끝내고 결과를 전달한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::FinishCreateSession( FMultiplayerSessionChannel& channel, bool bWasSuccessful )
 {
-	IOnlineSubsystem* subSystem = IOnlineSubsystem::Get();
-	if ( subSystem )
+	if ( bWasSuccessful )
 	{
-		// 서브 시스템으로 부터 세션 관리가 가능한 세션 인터페이스 정보를 가져온다.
-		m_SessionInterface = subSystem->GetSessionInterface();
+		StartQosResponder();
 	}
+
+	channel.OnCreateSessionComplete.Broadcast( bWasSuccessful );
+
+	FinishRequest( channel );
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 세션을 생성합니다.
+/// 세션 찾기 요청을 끝내고 결과를 전달한다.
 ////////////////////////////////////////////////////////////////////////////
-void UMultiPlayerSessionsSubsystem::CreateSession( int32 numPublicConnections, FString matchType )
+void UMultiPlayerSessionsSubsystem::FinishFindSessions( const TArray< FOnlineSessionSearchResult >& sessionResults, bool bWasSuccessful, bool bRecordLatency )
 {
-	if ( !m_SessionInterface.IsValid() )
-		return;
+	// 결과를 받은 쪽에서 바로 참가를 요청하면 검색이 끝난 뒤 이어서 처리된다.
+	m_MultiplayerOnFindSessionsComplete.Broadcast( sessionResults, bWasSuccessful );
 
-	// 이미 세션이 존재할 경우 삭제 후 다시 설정.
-	auto existingSession = m_SessionInterface->GetNamedSession( NAME_GameSession );
-	if ( nullptr != existingSession )
+	FinishRequest( m_SearchChannel, bRecordLatency );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 기존 세션을 파괴하지 않고 설정만 갱신할 수 있는지 여부
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::CanUpdateSessionInPlace( const FNamedOnlineSession& existingSession, int32 numPublicConnections ) const
+{
+	// 직접 호스팅 중인 세션만 갱신할 수 있다.
+	if ( !existingSession.bHosting )
+		return false;
+
+	// 파괴 / 종료 중인 세션은 다시 만들어야 한다.
+	if ( EOnlineSessionState::Pending != existingSession.SessionState
+		&& EOnlineSessionState::InProgress != existingSession.SessionState )
+		return false;
+
+	// LAN 여부가 바뀌면 광고 방식 자체가 달라진다.
+	if ( existingSession.SessionSettings.bIsLANMatch != m_SessionInterface->IsLAN() )
+		return false;
+
+	// 이미 접속한 플레이어보다 접속 수를 줄일 수는 없다.
+	return numPublicConnections >= existingSession.RegisteredPlayers.Num();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 설정에 광고를 쓴다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::WriteAdvertisement( FOnlineSessionSettings& settings, const FString& matchType, int32 numOpenSlots ) const
+{
+	FMultiplayerSessionAdvertisement advertisement = m_HostAdvertisement;
+	advertisement.MatchType = FMultiplayerSessionAdvertisement::ParseMatchType( FName( *matchType ) );
+	advertisement.BuildId	= static_cast< uint16 >( settings.BuildUniqueId );
+	advertisement.OpenSlots = static_cast< uint8 >( FMath::Clamp( numOpenSlots, 0, static_cast< int32 >( MAX_uint8 ) ) );
+
+	advertisement.Write( settings );
+
+	// 값이 없는 이름은 MatchType 문자열로도 광고해야 검색 / 인덱싱할 수 있다.
+	if ( EMultiplayerMatchType::None == advertisement.MatchType && !matchType.IsEmpty() )
+	{
+		UE_LOG( LogMultiplayerSessions, Warning, TEXT( "Unknown match type %s is advertised by name. Use a known name or MatchType_<value> for indexed filtering" ), *matchType );
+		settings.Set( FMultiplayerSessionIndex::MatchTypeKey, matchType, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing );
+	}
+	else
 	{
-		m_IsCreateSessionOnDestroy = true;
-		m_LastNumPublicConnections = numPublicConnections;
-		m_LastMatchType = matchType;
+		settings.Remove( FMultiplayerSessionIndex::MatchTypeKey );
+	}
 
-		// 세션 파괴 후 생성을 할경우 파괴 요청 시 서버와의 통신 딜레이 시간때문에, 이미 존재하는 세션이라. 문제가 발생함
-		// 세션 파괴 완료 후 세션 시작하도록 처리.
-		DestroySession();
+	if ( !m_HostMapName.IsNone() )
+	{
+		settings.Set( SETTING_MAPNAME, m_HostMapName.ToString(), EOnlineDataAdvertisementType::ViaOnlineService );
+	}
+
+	// 참가하는 쪽이 게임 포트로 짐작하지 않도록 에코 포트를 함께 광고한다.
+	if ( m_QosConfig.bRunEchoResponder )
+	{
+		settings.Set( FMultiplayerSessionIndex::QosPortKey, GetQosEchoPort(), EOnlineDataAdvertisementType::ViaOnlineServiceAndPing );
 	}
-		
+	else
+	{
+		settings.Remove( FMultiplayerSessionIndex::QosPortKey );
+	}
+}
 
-	// Store the delegate in a FDelegateHandle so We can later remove it for the delegate list
-	m_CreateSessionCompleteDelegateHandle = 
-		m_SessionInterface->AddOnCreateSessionCompleteDelegate_Handle( m_CreateSessionCompleteDelegate );
+////////////////////////////////////////////////////////////////////////////
+/// 기존 세션의 접속 수와 MatchType 을 갱신한다. 요청이 실패하면 false
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::UpdateSessionInPlace( FMultiplayerSessionChannel& channel, FNamedOnlineSession& existingSession, int32 numPublicConnections, const FString& matchType )
+{
+	channel.LastSessionSettings = MakeShared< FOnlineSessionSettings >( existingSession.SessionSettings );
+	channel.LastSessionSettings->NumPublicConnections = numPublicConnections;
 
-	m_LastSessionSettings = MakeShareable( new FOnlineSessionSettings() );
-	
-	// 테스트 용도일경우  SubSystemName == NuLL, 
-	// 테스트 아닐경우 Ex SubSystemName == Steam - ex
-	m_LastSessionSettings->bIsLANMatch = IOnlineSubsystem::Get()->GetSubsystemName() == "NULL" ? true : false;
-	// Connection Count
-	m_LastSessionSettings->NumPublicConnections = numPublicConnections;
+	// 사용 중인 슬롯 수는 유지하고 빈 슬롯만 다시 계산한다. 마지막으로 광고한 빈 슬롯이 있으면 그 값을 기준으로 한다.
+	FMultiplayerSessionAdvertisement advertisement;
+	const int32 advertisedOpenSlots	  = FMultiplayerSessionAdvertisement::Read( existingSession.SessionSettings, advertisement ) ? advertisement.OpenSlots : existingSession.NumOpenPublicConnections;
+	const int32 usedPublicConnections = FMath::Max( existingSession.SessionSettings.NumPublicConnections - advertisedOpenSlots, 0 );
+	const int32 numOpenSlots		  = FMath::Max( numPublicConnections - usedPublicConnections, 0 );
 
-	m_LastSessionSettings->bAllowJoinInProgress	 = true;
-	m_LastSessionSettings->bAllowJoinViaPresence = true;
-	m_LastSessionSettings->bShouldAdvertise		 = true;   //광고
-	m_LastSessionSettings->bUsesPresence		 = true;
-	m_LastSessionSettings->bUseLobbiesIfAvailable= true;
-	m_LastSessionSettings->BuildUniqueId		 = 1;		// 유니크 아이디 설정
+	WriteAdvertisement( *channel.LastSessionSettings, matchType, numOpenSlots );
 
-	m_LastSessionSettings->Set( FName( "MatchType" ), matchType, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing );
+	// 가득 차서 광고를 멈췄던 세션도 접속 수가 늘었으면 다시 광고한다.
+	channel.LastSessionSettings->bShouldAdvertise = numOpenSlots > 0;
 
-	// 월드로부터 로컬플레이어 정보를 가져온다. 각 로컬 플레이어는 고유의 Id값을 가진다.
-	const ULocalPlayer* localPlayer = GetWorld()->GetFirstLocalPlayerFromController();
+	channel.State = EMultiplayerSessionState::Updating;
 
-	// 세션 생성 
-	if ( !m_SessionInterface->CreateSession( *localPlayer->GetPreferredUniqueNetId(), NAME_GameSession, *m_LastSessionSettings ) )
+	const uint32 numCompletions = channel.NumCompletions;
+	if ( m_SessionInterface->UpdateSession( channel.SessionName, *channel.LastSessionSettings ) )
+		return true;
+
+	return numCompletions != channel.NumCompletions;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 검색 쿼리 키를 만든다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerSessionQueryKey UMultiPlayerSessionsSubsystem::MakeSearchQueryKey( FName matchType ) const
+{
+	FMultiplayerSessionQueryKey queryKey;
+	queryKey.bIsLanQuery	 = m_SessionInterface.IsValid() && m_SessionInterface->IsLAN();
+	queryKey.bSearchPresence = !m_SearchDedicatedServers;
+	queryKey.MatchType		 = matchType;
+	queryKey.Region			 = m_SearchRegion;
+	queryKey.BuildId		 = m_HostAdvertisement.BuildId;
+	queryKey.MinOpenSlots	 = m_SearchMinOpenSlots;
+
+	return queryKey;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 쿼리 키로 세션 찾기 객체를 만든다.
+////////////////////////////////////////////////////////////////////////////
+TSharedRef< FOnlineSessionSearch > UMultiPlayerSessionsSubsystem::MakeSessionSearch( int32 maxSearchResults, const FMultiplayerSessionQueryKey& queryKey )
+{
+	TSharedRef< FOnlineSessionSearch > sessionSearch = m_PooledSessionSearch.IsValid() ? m_PooledSessionSearch.ToSharedRef() : MakeShared< FOnlineSessionSearch >();
+	m_PooledSessionSearch.Reset();
+
+	sessionSearch->MaxSearchResults = maxSearchResults;
+	sessionSearch->bIsLanQuery		= queryKey.bIsLanQuery;
+	sessionSearch->QuerySettings.Set( SEARCH_PRESENCE, queryKey.bSearchPresence, EOnlineComparisonOp::Equals ); // 세션 검색 쿼리 세팅 
+
+	// 조건에 맞지 않는 세션은 백엔드에서 걸러서 받지 않는다. 결과 수와 전송량이 맞는 세션 수에 비례한다.
+	FMultiplayerSessionAdvertisement::AddQueryFilters( sessionSearch->QuerySettings, queryKey );
+
+	return sessionSearch;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 더 이상 참조하지 않는 세션 찾기를 다음 검색에 재사용하도록 돌려놓는다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::ReleaseSessionSearch( TSharedPtr< FOnlineSessionSearch >& sessionSearch )
+{
+	// 참가 중인 채널이나 진행 중인 백엔드 검색이 들고 있으면 그대로 놓아준다.
+	if ( sessionSearch.IsValid() && sessionSearch.IsUnique() )
 	{
-		// 세션 생성이 실패할 경우.
-		m_SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle( m_CreateSessionCompleteDelegateHandle );
+		// Reset 은 배열의 할당을 유지하므로 다음 검색 결과가 같은 메모리에 채워진다.
+		sessionSearch->SearchResults.Reset();
+		sessionSearch->QuerySettings.SearchParams.Reset();
+		sessionSearch->SearchState = EOnlineAsyncTaskState::NotStarted;
 
-		// Broadcast our own custom delegate
-		m_MultiplayerOnCreateSessionComplete.Broadcast( false );
+		m_PooledSessionSearch = MoveTemp( sessionSearch );
 	}
+
+	sessionSearch.Reset();
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 세션을 찾습니다.
+/// 검색 결과에서 후보 순위와 참가에 쓰지 않는 세팅을 버린다.
 ////////////////////////////////////////////////////////////////////////////
-void UMultiPlayerSessionsSubsystem::FindSessions( int32 maxSearchResults )
+void UMultiPlayerSessionsSubsystem::CompactSearchResults( FOnlineSessionSearch& sessionSearch ) const
 {
-	if ( !m_SessionInterface.IsValid() )
+	const FOnlineSearchSettings& querySettings = sessionSearch.QuerySettings;
+
+	for ( FOnlineSessionSearchResult& searchResult : sessionSearch.SearchResults )
+	{
+		const bool bMatches = FMultiplayerSessionAdvertisement::MatchesQuery( searchResult.Session.SessionSettings, searchResult.Session.NumOpenPublicConnections, querySettings );
+
+		FMultiplayerSessionIndex::Compact( searchResult, bMatches );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 캐시된 검색 결과의 경과 시간을 반환한다. 재사용할 수 없으면 음수
+////////////////////////////////////////////////////////////////////////////
+double UMultiPlayerSessionsSubsystem::GetSearchCacheAge( const FMultiplayerSessionQueryKey& queryKey, int32 maxSearchResults ) const
+{
+	if ( !m_LastSessionSearch.IsValid() || m_LastSearchCompleteTime <= 0.0 )
+		return -1.0;
+
+	if ( m_LastSearchKey != queryKey || m_LastSearchMaxResults < maxSearchResults )
+		return -1.0;
+
+	// 빈 결과는 캐싱하지 않는다. 새 세션이 생겼을 수 있으므로 다시 검색한다.
+	if ( m_LastSessionSearch->SearchResults.Num() <= 0 )
+		return -1.0;
+
+	return FPlatformTime::Seconds() - m_LastSearchCompleteTime;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 마지막 검색과 같은 조건으로 백그라운드 검색을 시작한다.
+////////////////////////////////////////////////////////////////////////////
+void UMultiPlayerSessionsSubsystem::RefreshSearchCache()
+{
+	// 이미 갱신 중이거나 일반 검색이 진행 중이면 기다린다.
+	if ( m_RefreshSessionSearch.IsValid() || EMultiplayerSessionState::Finding == m_SearchChannel.State )
 		return;
 
-	m_FindSessionCompleteDelegateHandle 
-		= m_SessionInterface->AddOnFindSessionsCompleteDelegate_Handle( m_FindSessionCompleteDelegate );
+	if ( !m_SessionInterface.IsValid() || !m_SearchChannel.PlayerId.IsValid() )
+		return;
 
-	m_LastSessionSearch = MakeShareable( new FOnlineSessionSearch() );
-	m_LastSessionSearch->MaxSearchResults = maxSearchResults;
-	m_LastSessionSearch->bIsLanQuery = IOnlineSubsystem::Get()->GetSubsystemName() == "NULL" ? true : false;
-	m_LastSessionSearch->QuerySettings.Set( SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals ); // 세션 검색 쿼리 세팅 
+	m_RefreshSessionSearch = MakeSessionSearch( m_LastSessionSearch->MaxSearchResults, m_LastSearchKey );
 
-	// 월드로부터 로컬플레이어 정보를 가져온다. 각 로컬 플레이어는 고유의 Id값을 가진다.
-	//Each player that is active on the current client/listen server has a LocalPlayer.
-	const ULocalPlayer* localPlayer = GetWorld()->GetFirstLocalPlayerFromController();
-	
-	// 세션 찾기
-	if ( !m_SessionInterface->FindSessions( *localPlayer->GetPreferredUniqueNetId(), m_LastSessionSearch.ToSharedRef() ) )
+	if ( !m_SessionInterface->FindSessions( *m_SearchChannel.PlayerId, m_RefreshSessionSearch.ToSharedRef() ) )
 	{
-		m_SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle( m_FindSessionCompleteDelegateHandle );
-		
-		//BroadCast Delegate
-		m_MultiplayerOnFindSessionsComplete.Broadcast( TArray<FOnlineSessionSearchResult>(), false );
+		m_RefreshSessionSearch.Reset();
 	}
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 세션에 참가합니다.
+/// 진행 중인 백그라운드 검색을 취소한다.
 ////////////////////////////////////////////////////////////////////////////
-void UMultiPlayerSessionsSubsystem::JoinSession( const FOnlineSessionSearchResult& sessionResult )
+void UMultiPlayerSessionsSubsystem::CancelSearchCacheRefresh()
 {
-	if ( !m_SessionInterface.IsValid() )
-	{
-		m_MultiplayerOnJoinSessionComplete.Broadcast( EOnJoinSessionCompleteResult::UnknownError );
+	if ( !m_RefreshSessionSearch.IsValid() )
 		return;
+
+	m_RefreshSessionSearch.Reset();
+
+	if ( m_SessionInterface.IsValid() )
+	{
+		m_SessionInterface->CancelFindSessions();
 	}
-	
-	m_JoinSessionCompleteDelegateHandle 
-		= m_SessionInterface->AddOnJoinSessionCompleteDelegate_Handle( m_JoinSessionCompleteDelegate );
+}
 
-	// 로컬 플레이어 정보
-	const ULocalPlayer* localPlayer = GetWorld()->GetFirstLocalPlayerFromController();
-	
-	// 세션 참가
-	if ( !m_SessionInterface->JoinSession( *localPlayer->GetPreferredUniqueNetId(), NAME_GameSession, sessionResult ) )
+////////////////////////////////////////////////////////////////////////////
+/// 스트리밍 검색 중 새로 도착한 결과를 확인한다.
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::TickStreamingSearch( float deltaTime )
+{
+	if ( !m_LastSessionSearch.IsValid() )
 	{
-		m_SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle( m_JoinSessionCompleteDelegateHandle );
+		m_StreamingSearchTickerHandle.Reset();
+		return false;
+	}
 
-		m_MultiplayerOnJoinSessionComplete.Broadcast( EOnJoinSessionCompleteResult::UnknownError );
+	const int32 firstNewIndex = IndexNewSearchResults();
+	if ( INDEX_NONE != firstNewIndex )
+	{
+		m_MultiplayerOnFindSessionsPartial.Broadcast( m_LastSessionSearch->SearchResults, firstNewIndex );
 	}
+
+	// 대리자에서 검색을 중단했다면 티커 핸들이 이미 해제되어 있다.
+	return m_StreamingSearchTickerHandle.IsValid();
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 세션을 파괴합니다.
+/// 스트리밍 검색 폴링을 멈춘다.
 ////////////////////////////////////////////////////////////////////////////
-void UMultiPlayerSessionsSubsystem::DestroySession()
+void UMultiPlayerSessionsSubsystem::StopStreamingSearchTicker()
 {
-	if ( !m_SessionInterface.IsValid() )
+	if ( m_StreamingSearchTickerHandle.IsValid() )
 	{
-		m_MultiplayerOnDestroySessionComplete.Broadcast( false );
-		return;
+		FTSTicker::GetCoreTicker().RemoveTicker( m_StreamingSearchTickerHandle );
+		m_StreamingSearchTickerHandle.Reset();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 아직 인덱스에 반영되지 않은 검색 결과를 추가한다. 새 결과의 시작 인덱스를 반환하고 없으면 INDEX_NONE
+////////////////////////////////////////////////////////////////////////////
+int32 UMultiPlayerSessionsSubsystem::IndexNewSearchResults()
+{
+	const TArray< FOnlineSessionSearchResult >& searchResults = m_LastSessionSearch->SearchResults;
+
+	// 온라인 서브시스템이 결과 배열을 다시 채웠다면 처음부터 인덱싱한다.
+	if ( searchResults.Num() < m_NumIndexedResults )
+	{
+		m_LastSearchIndex.Reset();
+		m_NumIndexedResults = 0;
 	}
 
-	m_DestroySessionCompleteDelegateHandle =
-		m_SessionInterface->AddOnDestroySessionCompleteDelegate_Handle( m_DestroySessionCompleteDelegate );
+	if ( searchResults.Num() == m_NumIndexedResults )
+		return INDEX_NONE;
+
+	const int32 firstNewIndex = m_NumIndexedResults;
 
-	if ( !m_SessionInterface->DestroySession( NAME_GameSession ) )
+	const FOnlineSearchSettings& querySettings = m_LastSessionSearch->QuerySettings;
+
+	FString scratch;
+	for ( int32 index = firstNewIndex; index < searchResults.Num(); ++index )
 	{
-		m_SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle( m_DestroySessionCompleteDelegateHandle );
-		m_MultiplayerOnDestroySessionComplete.Broadcast( false );
+		const FOnlineSessionSearchResult& searchResult = searchResults[ index ];
+
+		// 필터를 지원하지 않는 백엔드 ( NULL 서브시스템 LAN 검색 등 ) 의 결과는 인덱싱할 때 거른다.
+		if ( !FMultiplayerSessionAdvertisement::MatchesQuery( searchResult.Session.SessionSettings, searchResult.Session.NumOpenPublicConnections, querySettings ) )
+			continue;
+
+		m_LastSearchIndex.Add( searchResult, index, scratch );
 	}
+
+	m_NumIndexedResults = searchResults.Num();
+
+	return firstNewIndex;
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 세션을 시작합니다.
+/// 세션 참가를 요청한다. 요청이 실패하면 false
 ////////////////////////////////////////////////////////////////////////////
-void UMultiPlayerSessionsSubsystem::StartSession()
+bool UMultiPlayerSessionsSubsystem::BeginJoinSession( FMultiplayerSessionChannel& channel, const FOnlineSessionSearchResult& sessionResult )
 {
+	if ( !m_SessionInterface.IsValid() || !channel.PlayerId.IsValid() )
+		return false;
+
+	channel.State = EMultiplayerSessionState::Joining;
+
+	// 참가 응답과 접속을 기다리는 동안 호스트가 광고한 맵을 미리 로드한다.
+	FString mapName;
+	if ( sessionResult.Session.SessionSettings.Get( SETTING_MAPNAME, mapName ) )
+	{
+		m_MapPreloader->Preload( mapName );
+	}
+
+	// 세션 참가
+	const uint32 numCompletions = channel.NumCompletions;
+	if ( m_SessionInterface->JoinSession( *channel.PlayerId, channel.SessionName, sessionResult ) )
+		return true;
+
+	return numCompletions != channel.NumCompletions;
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 멀티플레이어 세션 생성 완료 대리자를 반환한다.
+/// 다음 순위 후보로 참가를 시도한다. 진행 중인 시도가 없으면 false
 ////////////////////////////////////////////////////////////////////////////
-FMultiplayerOnCreateSessionComplete& UMultiPlayerSessionsSubsystem::GetMultiplayerOnCreateSessionComplete()
+bool UMultiPlayerSessionsSubsystem::TryNextJoinCandidate( FMultiplayerSessionChannel& channel )
 {
-	return m_MultiplayerOnCreateSessionComplete;
+	if ( !channel.JoinSearch.IsValid() )
+		return false;
+
+	const TArray< FOnlineSessionSearchResult >& searchResults = channel.JoinSearch->SearchResults;
+
+	while ( channel.JoinAttemptsLeft > 0 && channel.JoinCandidates.IsValidIndex( channel.JoinCandidateRank + 1 ) )
+	{
+		const int32 index = channel.JoinCandidates[ ++channel.JoinCandidateRank ].ResultIndex;
+		if ( !searchResults.IsValidIndex( index ) )
+			continue;
+
+		--channel.JoinAttemptsLeft;
+
+		const uint32 numCompletions = channel.NumCompletions;
+
+		if ( BeginJoinSession( channel, searchResults[ index ] ) )
+		{
+			// 참가 완료가 바로 처리되었으면 기다릴 시도가 없다.
+			if ( channel.JoinAttemptTimeout > 0.f && numCompletions == channel.NumCompletions )
+			{
+				channel.JoinTimeoutTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+					FTickerDelegate::CreateUObject( this, &ThisClass::OnJoinAttemptTimeout, channel.SessionName ),
+					channel.JoinAttemptTimeout );
+			}
+
+			return true;
+		}
+	}
+
+	return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 멀티플레이어 세션 검색 완료 대리자를 반환한다.
+/// 참가 후보의 핑 측정을 시작한다. 측정하지 않으면 false
+/// 검색이 알려준 핑은 백엔드 / 지역에 따라 없거나 부정확하므로, 후보 호스트에 UDP 에코를 보내 직접 잰다.
 ////////////////////////////////////////////////////////////////////////////
-FMultiplayerOnFindSessionsComplete& UMultiPlayerSessionsSubsystem::GetMultiplayerOnFindSessionsComplete()
+bool UMultiPlayerSessionsSubsystem::BeginSessionQos( FMultiplayerSessionChannel& channel )
 {
-	return m_MultiplayerOnFindSessionsComplete;
+	// 후보가 하나뿐이면 순위가 바뀌지 않으므로 측정하지 않는다.
+	if ( !m_QosConfig.bEnabled || !m_SessionInterface.IsValid() || !channel.JoinSearch.IsValid() || channel.JoinCandidates.Num() <= 1 )
+		return false;
+
+	// 다른 세션이 측정 중이면 검색이 알려준 핑으로 바로 참가한다.
+	if ( m_QosProber.IsValid() && m_QosProber->IsRunning() )
+		return false;
+
+	const TArray< FOnlineSessionSearchResult >& searchResults = channel.JoinSearch->SearchResults;
+
+	TArray< FMultiplayerQosTarget > targets;
+	targets.Reserve( channel.JoinCandidates.Num() );
+
+	for ( const FMultiplayerSessionCandidate& candidate : channel.JoinCandidates )
+	{
+		if ( !searchResults.IsValidIndex( candidate.ResultIndex ) )
+			continue;
+
+		FString connectString;
+		if ( !m_SessionInterface->GetResolvedConnectString( searchResults[ candidate.ResultIndex ], NAME_GamePort, connectString ) )
+			continue;
+
+		FMultiplayerQosTarget target;
+		if ( !FMultiplayerQosTarget::Parse( candidate.ResultIndex, connectString, m_QosConfig.EchoPortOffset, target ) )
+			continue;
+
+		// 호스트가 광고한 에코 포트가 있으면 게임 포트 + EchoPortOffset 대신 쓴다.
+		int32 echoPort = 0;
+		if ( searchResults[ candidate.ResultIndex ].Session.SessionSettings.Get( FMultiplayerSessionIndex::QosPortKey, echoPort ) && echoPort > 0 )
+		{
+			target.Port = echoPort;
+		}
+
+		targets.Add( MoveTemp( target ) );
+	}
+
+	if ( targets.Num() <= 1 )
+		return false;
+
+	// 측정 사이에 설정이 바뀔 수 있으므로 측정마다 새로 만든다.
+	m_QosProber = MakeUnique< FMultiplayerQosProber >( m_QosConfig );
+
+	if ( !m_QosProber->Start( MoveTemp( targets ), FMultiplayerOnQosComplete::CreateUObject( this, &ThisClass::OnSessionQosComplete, channel.SessionName ) ) )
+		return false;
+
+	channel.bMeasuringQos = true;
+	return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 멀티플레이어 세션 참가 완료 대리자를 반환한다.
+/// 측정한 핑으로 참가 후보 순위를 다시 매기고 참가를 시도한다.
+/// 후보만 복사한 결과에 측정한 왕복 시간과 지터를 핑으로 써서, 설정된 점수 계산이 그대로 측정값을 사용한다.
+/// 검색 결과는 캐시로 다른 참가 / 조회와 공유하므로 고치지 않는다.
 ////////////////////////////////////////////////////////////////////////////
-FMultiplayerOnJoinSessionComplete& UMultiPlayerSessionsSubsystem::GetMultiplayerOnJoinSessionComplete()
+void UMultiPlayerSessionsSubsystem::OnSessionQosComplete( const TArray< FMultiplayerQosResult >& results, FName sessionName )
 {
-	return m_MultiplayerOnJoinSessionComplete;
+	FMultiplayerSessionChannel* channel = FindChannel( sessionName );
+	if ( nullptr == channel || !channel->bMeasuringQos )
+		return;
+
+	channel->bMeasuringQos = false;
+
+	if ( channel->JoinSearch.IsValid() )
+	{
+		const TArray< FOnlineSessionSearchResult >& searchResults = channel->JoinSearch->SearchResults;
+
+		// 후보 순서대로 복사한다. ( 복사본 위치 → 검색 결과 위치 )
+		TArray< FOnlineSessionSearchResult > measuredResults;
+		TArray< int32 > resultIndices;
+		measuredResults.Reserve( channel->JoinCandidates.Num() );
+		resultIndices.Reserve( channel->JoinCandidates.Num() );
+
+		for ( const FMultiplayerSessionCandidate& candidate : channel->JoinCandidates )
+		{
+			if ( !searchResults.IsValidIndex( candidate.ResultIndex ) )
+				continue;
+
+			measuredResults.Add( searchResults[ candidate.ResultIndex ] );
+			resultIndices.Add( candidate.ResultIndex );
+		}
+
+		// 응답하지 않은 후보는 방화벽 / 에코 미지원일 수 있으므로 버리지 않고 검색이 알려준 핑으로 남긴다.
+		for ( const FMultiplayerQosResult& result : results )
+		{
+			const int32 measuredIndex = resultIndices.Find( result.ResultIndex );
+			if ( result.IsReachable() && INDEX_NONE != measuredIndex )
+			{
+				measuredResults[ measuredIndex ].PingInMs = FMath::RoundToInt( result.RttMs + m_QosConfig.JitterWeight * result.JitterMs );
+			}
+		}
+
+		TArray< int32 > candidateIndices;
+		candidateIndices.Reserve( measuredResults.Num() );
+
+		for ( int32 measuredIndex = 0; measuredIndex < measuredResults.Num(); ++measuredIndex )
+		{
+			candidateIndices.Add( measuredIndex );
+		}
+
+		FMultiplayerSessionRanker::SelectTopCandidates(
+			measuredResults,
+			candidateIndices,
+			*m_SessionScorer,
+			channel->ActiveRequest.MaxAttempts,
+			channel->JoinCandidates );
+
+		// 순위는 복사본 위치로 나오므로 검색 결과 위치로 되돌린다.
+		for ( FMultiplayerSessionCandidate& candidate : channel->JoinCandidates )
+		{
+			candidate.ResultIndex = resultIndices[ candidate.ResultIndex ];
+		}
+
+		channel->JoinAttemptsLeft = channel->JoinCandidates.Num();
+	}
+
+	if ( !TryNextJoinCandidate( *channel ) )
+	{
+		FinishJoinFailover( *channel, EOnJoinSessionCompleteResult::UnknownError );
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 멀티플레이어 세션 파괴 완료 대리자를 반환한다.
+/// 호스팅한 세션의 QoS 에코 응답을 시작한다. ( 게임 포트 + EchoPortOffset, 이미 응답 중이면 그대로 둔다 )
 ////////////////////////////////////////////////////////////////////////////
-FMultiplayerOnDestroySessionComplete& UMultiPlayerSessionsSubsystem::GetMultiplayerOnDestroySessionComplete()
+void UMultiPlayerSessionsSubsystem::StartQosResponder()
 {
-	return m_MultiplayerOnDestroySessionComplete;
+	if ( !m_QosConfig.bRunEchoResponder )
+		return;
+
+	if ( !m_QosResponder.IsValid() )
+	{
+		m_QosResponder = MakeUnique< FMultiplayerQosEchoResponder >();
+	}
+
+	m_QosResponder->Start( GetQosEchoPort() );
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 멀티플레이어 세션 시작 완료 대리자를 반환한다.
+/// 호스트가 QoS 에코에 응답할 포트를 반환한다. ( 응답 중이면 그 포트, 아니면 -QosEchoPort= 또는 게임 접속 포트 + EchoPortOffset )
 ////////////////////////////////////////////////////////////////////////////
-FMultiplayerOnStartSessionComplete& UMultiPlayerSessionsSubsystem::GetMultiplayerOnStartSessionComplete()
+int32 UMultiPlayerSessionsSubsystem::GetQosEchoPort() const
 {
-	return m_MultiplayerOnStartSessionComplete;
+	if ( m_QosResponder.IsValid() && m_QosResponder->GetPort() > 0 )
+		return m_QosResponder->GetPort();
+
+	if ( m_QosConfig.EchoPort > 0 )
+		return m_QosConfig.EchoPort;
+
+	// -port= 로 바꾼 포트를 따라가도록 기본 포트 대신 월드의 게임 접속 포트를 쓴다.
+	const int32 listenPort = GetListenPort();
+	return ( listenPort > 0 ? listenPort : FURL::UrlConfig.DefaultPort ) + m_QosConfig.EchoPortOffset;
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 세션 생성이 완료되었을 때 처리한다.
+/// 순위 후보 참가를 끝내고 결과를 전달한다.
 ////////////////////////////////////////////////////////////////////////////
-void UMultiPlayerSessionsSubsystem::OnCreateSessionComplete( FName sessionName, bool bWasSuccessful )
+void UMultiPlayerSessionsSubsystem::FinishJoinFailover( FMultiplayerSessionChannel& channel, EOnJoinSessionCompleteResult::Type result )
 {
-	if ( m_SessionInterface )
+	channel.bJoinFailover	  = false;
+	channel.bMeasuringQos	  = false;
+	channel.JoinCandidateRank = INDEX_NONE;
+	channel.JoinAttemptsLeft  = 0;
+	channel.JoinCandidates.Reset();
+
+	// 후보에 모두 참가하지 못했다면 캐시된 결과가 이미 오래된 것이므로 다음엔 새로 검색한다.
+	if ( EOnJoinSessionCompleteResult::Success != result && channel.JoinSearch == m_LastSessionSearch )
 	{
-		m_SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle( m_CreateSessionCompleteDelegateHandle );
+		InvalidateSearchCache();
 	}
 
-	// Broadcast our own custom delegate
-	m_MultiplayerOnCreateSessionComplete.Broadcast( bWasSuccessful );
+	channel.JoinSearch.Reset();
+
+	channel.OnJoinSessionComplete.Broadcast( result );
+
+	FinishRequest( channel );
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 세션 검색이 완료되었을 때 처리한다.
+/// 참가 시도 제한 시간이 지났을 때 처리한다.
 ////////////////////////////////////////////////////////////////////////////
-void UMultiPlayerSessionsSubsystem::OnFindSessionsComplete( bool bwasSuccessful )
+bool UMultiPlayerSessionsSubsystem::OnJoinAttemptTimeout( float deltaTime, FName sessionName )
 {
-	if ( m_SessionInterface )
+	FMultiplayerSessionChannel* channel = FindChannel( sessionName );
+	if ( nullptr == channel )
+		return false;
+
+	channel->JoinTimeoutTickerHandle.Reset();
+
+	if ( m_SessionInterface.IsValid() )
 	{
-		m_SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle( m_FindSessionCompleteDelegateHandle );
+		// 참가 요청은 취소할 수 없으므로, 만들어진 세션을 파괴한 후 다음 후보로 넘어간다.
+		if ( nullptr != m_SessionInterface->GetNamedSession( sessionName ) )
+		{
+			channel->bJoinNextOnDestroy = true;
+
+			if ( BeginDestroySession( *channel ) )
+				return false;
+
+			// 파괴 요청이 바로 실패했다면 완료 콜백이 오지 않는다.
+			channel->bJoinNextOnDestroy = false;
+		}
 	}
 
-	if ( m_LastSessionSearch->SearchResults.Num() <= 0 )
+	if ( !TryNextJoinCandidate( *channel ) )
 	{
-		// 찾은 세션 정보가 없을경우 실패 처리.
-		m_MultiplayerOnFindSessionsComplete.Broadcast( TArray<FOnlineSessionSearchResult>(), false );
-		return;
+		FinishJoinFailover( *channel, EOnJoinSessionCompleteResult::UnknownError );
 	}
 
-	// Broadcast our own custom delegate
-	m_MultiplayerOnFindSessionsComplete.Broadcast( m_LastSessionSearch->SearchResults, bwasSuccessful );
+	// 한 번만 호출되는 티커
+	return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 세션 합류가 완료되었을 때 처리한다.
+/// 참가 시도 제한 시간 티커를 멈춘다.
 ////////////////////////////////////////////////////////////////////////////
-void UMultiPlayerSessionsSubsystem::OnJoinSessionComplete( FName sessionName, EOnJoinSessionCompleteResult::Type result )
+void UMultiPlayerSessionsSubsystem::StopJoinTimeoutTicker( FMultiplayerSessionChannel& channel )
 {
-	if ( m_SessionInterface )
+	if ( channel.JoinTimeoutTickerHandle.IsValid() )
 	{
-		m_SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle( m_JoinSessionCompleteDelegateHandle );
+		FTSTicker::GetCoreTicker().RemoveTicker( channel.JoinTimeoutTickerHandle );
+		channel.JoinTimeoutTickerHandle.Reset();
 	}
-
-	m_MultiplayerOnJoinSessionComplete.Broadcast( result );
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 세션 파괴가 완료되었을 때 처리한다.
+/// 빈 슬롯 갱신 티커를 멈춘다.
 ////////////////////////////////////////////////////////////////////////////
-void UMultiPlayerSessionsSubsystem::OnDestroySessionComplete( FName sessionName, bool bwasSuccessful )
+void UMultiPlayerSessionsSubsystem::StopBackfillTicker( FMultiplayerSessionChannel& channel )
 {
-	if ( m_SessionInterface )
+	if ( channel.BackfillTickerHandle.IsValid() )
 	{
-		m_SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle( m_DestroySessionCompleteDelegateHandle );
+		FTSTicker::GetCoreTicker().RemoveTicker( channel.BackfillTickerHandle );
+		channel.BackfillTickerHandle.Reset();
 	}
+}
 
-	if ( bwasSuccessful && m_IsCreateSessionOnDestroy )
-	{
-		m_IsCreateSessionOnDestroy = false;
-		CreateSession( m_LastNumPublicConnections, m_LastMatchType );
-	}
+////////////////////////////////////////////////////////////////////////////
+/// 데디케이티드 서버 세션 등록을 다시 시도한다.
+////////////////////////////////////////////////////////////////////////////
+bool UMultiPlayerSessionsSubsystem::OnRegisterRetryElapsed( float deltaTime )
+{
+	m_RegisterRetryTickerHandle.Reset();
+
+	RegisterDedicatedServer();
 
-	m_MultiplayerOnDestroySessionComplete.Broadcast( bwasSuccessful );
+	// 한 번만 호출되는 티커
+	return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////
-/// 세션 시작이 완료되었을 때 처리한다.
+/// 다음 후보로 넘어가도 되는 참가 실패인지 여부
 ////////////////////////////////////////////////////////////////////////////
-void UMultiPlayerSessionsSubsystem::OnStartSessionComplete( FName sessionName, bool bwasSuccessful )
+bool UMultiPlayerSessionsSubsystem::IsRetryableJoinResult( EOnJoinSessionCompleteResult::Type result )
 {
-}
\ No newline at end of file
+	// 후보 세션의 문제인 실패만 넘어간다. 원인을 모르는 실패는 다음 후보에서도 반복될 수 있으므로 바로 알린다.
+	switch ( result )
+	{
+	case EOnJoinSessionCompleteResult::SessionIsFull:
+	case EOnJoinSessionCompleteResult::SessionDoesNotExist:
+	case EOnJoinSessionCompleteResult::CouldNotRetrieveAddress:
+		return true;
+
+	default:
+		return false;
+	}
+}
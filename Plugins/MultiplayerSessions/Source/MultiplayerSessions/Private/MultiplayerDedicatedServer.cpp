@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerDedicatedServer.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+
+
+const TCHAR* FMultiplayerDedicatedServerConfig::ConfigSection = TEXT( "MultiplayerSessions.DedicatedServer" );
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 설정 파일과 명령줄에서 설정을 읽는다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerDedicatedServerConfig FMultiplayerDedicatedServerConfig::Load()
+{
+	FMultiplayerDedicatedServerConfig config;
+
+	// 서버 이미지에 함께 배포되는 기본값
+	FString sessionName = config.SessionName.ToString();
+	if ( GConfig )
+	{
+		GConfig->GetBool(	ConfigSection, TEXT( "bAutoRegister" ),			config.bAutoRegister,			GGameIni );
+		GConfig->GetString(	ConfigSection, TEXT( "SessionName" ),			sessionName,					GGameIni );
+		GConfig->GetInt(	ConfigSection, TEXT( "NumPublicConnections" ),	config.NumPublicConnections,	GGameIni );
+		GConfig->GetString(	ConfigSection, TEXT( "MatchType" ),				config.MatchType,				GGameIni );
+		GConfig->GetFloat(	ConfigSection, TEXT( "RetryDelay" ),			config.RetryDelay,				GGameIni );
+		GConfig->GetInt(	ConfigSection, TEXT( "MaxRetries" ),			config.MaxRetries,				GGameIni );
+	}
+
+	// 같은 이미지로 여러 프로세스를 띄울 때 인스턴스마다 바꾸는 값
+	const TCHAR* commandLine = FCommandLine::Get();
+	FParse::Value( commandLine, TEXT( "SessionName=" ),			sessionName );
+	FParse::Value( commandLine, TEXT( "SessionConnections=" ),	config.NumPublicConnections );
+	FParse::Value( commandLine, TEXT( "SessionMatchType=" ),	config.MatchType );
+
+	if ( FParse::Param( commandLine, TEXT( "NoSessionRegister" ) ) )
+	{
+		config.bAutoRegister = false;
+	}
+
+	config.SessionName			= FName( *sessionName );
+	config.NumPublicConnections = FMath::Max( config.NumPublicConnections, 1 );
+	config.RetryDelay			= FMath::Max( config.RetryDelay, 0.f );
+
+	return config;
+}
@@ -0,0 +1,498 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerFakeSessionBackend.h"
+#include "MultiplayerSessionAdvertisement.h"
+#include "MultiplayerSessionBenchmark.h"
+#include "OnlineSessionSettings.h"
+
+
+namespace MultiplayerFakeSessionBackend
+{
+	/// 이벤트 힙 정렬 ( 실행 시간이 빠른 순, 같으면 예약 순 )
+	struct FEarliestFirst
+	{
+		template< typename EventType >
+		bool operator()( const EventType& lhs, const EventType& rhs ) const
+		{
+			return lhs.DueTime != rhs.DueTime ? lhs.DueTime < rhs.DueTime : lhs.Sequence < rhs.Sequence;
+		}
+	};
+
+	/// 가짜 호스트 주소의 시작 포트
+	static constexpr int32 BasePort{ 7777 };
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 생성자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerFakeSessionBackend::FMultiplayerFakeSessionBackend( const FMultiplayerFakeBackendConfig& config )
+{
+	Reset( config );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 소멸자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerFakeSessionBackend::~FMultiplayerFakeSessionBackend()
+{
+	if ( m_TickerHandle.IsValid() )
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker( m_TickerHandle );
+		m_TickerHandle.Reset();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 설정을 바꾸고 광고 세션을 다시 만든다. 예약된 이벤트와 세션은 모두 지운다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerFakeSessionBackend::Reset( const FMultiplayerFakeBackendConfig& config )
+{
+	m_Config = config;
+	m_Random.Initialize( config.Seed );
+
+	m_PendingEvents.Reset();
+	m_NamedSessions.Reset();
+	m_ActiveSearch.Reset();
+
+	BuildAdvertisedSessions();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 현재 시간까지 도달한 이벤트를 처리한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerFakeSessionBackend::Pump( double now )
+{
+	while ( m_PendingEvents.Num() > 0 && m_PendingEvents.HeapTop().DueTime <= now )
+	{
+		// 실행 중에 새 이벤트가 예약될 수 있으므로 먼저 꺼낸다.
+		FPendingEvent pendingEvent;
+		m_PendingEvents.HeapPop( pendingEvent, MultiplayerFakeSessionBackend::FEarliestFirst(), false );
+
+		pendingEvent.Execute();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 예약된 이벤트를 시간과 관계없이 모두 처리한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerFakeSessionBackend::Flush()
+{
+	Pump( TNumericLimits< double >::Max() );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 설정을 반환한다.
+////////////////////////////////////////////////////////////////////////////
+const FMultiplayerFakeBackendConfig& FMultiplayerFakeSessionBackend::GetConfig() const
+{
+	return m_Config;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 광고 중인 세션 수를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+int32 FMultiplayerFakeSessionBackend::GetNumAdvertisedSessions() const
+{
+	return m_AdvertisedSessions.Num();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 생성한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::CreateSession( const FUniqueNetId& hostingPlayerId, FName sessionName, const FOnlineSessionSettings& newSessionSettings )
+{
+	return CreateSession( 0, sessionName, newSessionSettings );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 로컬 플레이어 번호로 세션을 생성한다. ( 가짜 백엔드는 호스트를 구분하지 않는다 )
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::CreateSession( int32 hostingPlayerNum, FName sessionName, const FOnlineSessionSettings& newSessionSettings )
+{
+	if ( m_NamedSessions.Contains( sessionName ) )
+		return false;
+
+	// 온라인 서브시스템처럼 요청 시점에 세션을 만들어 두고, 실패하면 지운다.
+	TSharedRef< FNamedOnlineSession > namedSession = MakeShared< FNamedOnlineSession >( sessionName, newSessionSettings );
+	namedSession->bHosting	   = true;
+	namedSession->SessionState = EOnlineSessionState::Creating;
+	m_NamedSessions.Add( sessionName, namedSession );
+
+	const bool bFailed = Roll( m_Config.CreateFailureRate );
+
+	Schedule( SampleLatency(), [ this, sessionName, bFailed, weakSession = TWeakPtr< FNamedOnlineSession >( namedSession ) ]()
+	{
+		TSharedPtr< FNamedOnlineSession > pinnedSession = weakSession.Pin();
+		if ( pinnedSession.IsValid() )
+		{
+			if ( bFailed )
+			{
+				m_NamedSessions.Remove( sessionName );
+			}
+			else
+			{
+				pinnedSession->SessionState = EOnlineSessionState::Pending;
+			}
+		}
+
+		TriggerOnCreateSessionCompleteDelegates( sessionName, !bFailed && pinnedSession.IsValid() );
+	} );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 시작한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::StartSession( FName sessionName )
+{
+	TSharedRef< FNamedOnlineSession >* namedSession = m_NamedSessions.Find( sessionName );
+	if ( nullptr == namedSession || EOnlineSessionState::Pending != ( *namedSession )->SessionState )
+		return false;
+
+	( *namedSession )->SessionState = EOnlineSessionState::Starting;
+
+	Schedule( SampleLatency(), [ this, sessionName, weakSession = TWeakPtr< FNamedOnlineSession >( *namedSession ) ]()
+	{
+		TSharedPtr< FNamedOnlineSession > pinnedSession = weakSession.Pin();
+		if ( pinnedSession.IsValid() )
+		{
+			pinnedSession->SessionState = EOnlineSessionState::InProgress;
+		}
+
+		TriggerOnStartSessionCompleteDelegates( sessionName, pinnedSession.IsValid() );
+	} );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 설정을 갱신한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::UpdateSession( FName sessionName, FOnlineSessionSettings& updatedSessionSettings )
+{
+	TSharedRef< FNamedOnlineSession >* namedSession = m_NamedSessions.Find( sessionName );
+	if ( nullptr == namedSession )
+		return false;
+
+	Schedule( SampleLatency(), [ this, sessionName, updatedSessionSettings, weakSession = TWeakPtr< FNamedOnlineSession >( *namedSession ) ]()
+	{
+		TSharedPtr< FNamedOnlineSession > pinnedSession = weakSession.Pin();
+		if ( pinnedSession.IsValid() )
+		{
+			pinnedSession->SessionSettings = updatedSessionSettings;
+		}
+
+		TriggerOnUpdateSessionCompleteDelegates( sessionName, pinnedSession.IsValid() );
+	} );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 파괴한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::DestroySession( FName sessionName )
+{
+	TSharedRef< FNamedOnlineSession >* namedSession = m_NamedSessions.Find( sessionName );
+	if ( nullptr == namedSession )
+		return false;
+
+	// 참가를 마친 세션을 나가면 호스트의 슬롯을 돌려준다.
+	const FNamedOnlineSession& session = namedSession->Get();
+	const bool bLeaveSlot = !session.bHosting
+		&& ( EOnlineSessionState::Pending == session.SessionState || EOnlineSessionState::InProgress == session.SessionState );
+	const FString hostName = session.OwningUserName;
+
+	( *namedSession )->SessionState = EOnlineSessionState::Destroying;
+
+	Schedule( SampleLatency(), [ this, sessionName, bLeaveSlot, hostName, weakSession = TWeakPtr< FNamedOnlineSession >( *namedSession ) ]()
+	{
+		// 그 사이 같은 이름으로 다시 만든 세션은 지우지 않는다.
+		TSharedRef< FNamedOnlineSession >* currentSession = m_NamedSessions.Find( sessionName );
+		if ( nullptr != currentSession && weakSession.Pin().Get() == &( *currentSession ).Get() )
+		{
+			m_NamedSessions.Remove( sessionName );
+		}
+
+		const int32* advertisedIndex = bLeaveSlot ? m_AdvertisedSessionIndices.Find( hostName ) : nullptr;
+		if ( nullptr != advertisedIndex )
+		{
+			FOnlineSession& advertisedSession = m_AdvertisedSessions[ *advertisedIndex ].Session;
+			advertisedSession.NumOpenPublicConnections = FMath::Min( advertisedSession.NumOpenPublicConnections + 1, advertisedSession.SessionSettings.NumPublicConnections );
+		}
+
+		TriggerOnDestroySessionCompleteDelegates( sessionName, true );
+	} );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 찾는다. 결과는 NumFindBatches 번에 나눠서 searchSettings->SearchResults 에 추가된다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::FindSessions( const FUniqueNetId& searchingPlayerId, const TSharedRef< FOnlineSessionSearch >& searchSettings )
+{
+	// 온라인 서브시스템처럼 검색은 한 번에 하나만 진행한다.
+	if ( m_ActiveSearch.IsValid() )
+		return false;
+
+	m_ActiveSearch = searchSettings;
+
+	searchSettings->SearchState = EOnlineAsyncTaskState::InProgress;
+	searchSettings->SearchResults.Reset();
+
+	const bool bFailed = Roll( m_Config.FindFailureRate );
+	const double latency = SampleLatency();
+	const int32 numBatches = FMath::Max( m_Config.NumFindBatches, 1 );
+	const int32 maxResults = searchSettings->MaxSearchResults > 0 ? searchSettings->MaxSearchResults : MAX_int32;
+
+	// 온라인 서비스처럼 쿼리 필터는 백엔드에서 적용해서, 조건에 맞는 세션만 전달한다.
+	TSharedRef< TArray< int32 > > matchingIndices = MakeShared< TArray< int32 > >();
+	for ( int32 index = 0; index < m_AdvertisedSessions.Num() && matchingIndices->Num() < maxResults; ++index )
+	{
+		const FOnlineSessionSearchResult& advertisedSession = m_AdvertisedSessions[ index ];
+		if ( FMultiplayerSessionAdvertisement::MatchesQuery( advertisedSession.Session.SessionSettings, advertisedSession.Session.NumOpenPublicConnections, searchSettings->QuerySettings ) )
+		{
+			matchingIndices->Add( index );
+		}
+	}
+
+	const int32 numResults = matchingIndices->Num();
+
+	const TWeakPtr< FOnlineSessionSearch > weakSearch = searchSettings;
+
+	for ( int32 batch = 1; batch <= numBatches; ++batch )
+	{
+		Schedule( latency * batch / numBatches, [ this, weakSearch, batch, numBatches, numResults, matchingIndices, bFailed ]()
+		{
+			TSharedPtr< FOnlineSessionSearch > search = weakSearch.Pin();
+			if ( !search.IsValid() || search != m_ActiveSearch )
+				return;
+
+			// 결과는 요청 시점이 아니라 도착 시점의 광고 상태를 복사한다.
+			if ( !bFailed )
+			{
+				const int32 lastIndex = static_cast< int32 >( static_cast< int64 >( numResults ) * batch / numBatches );
+				for ( int32 index = search->SearchResults.Num(); index < lastIndex; ++index )
+				{
+					search->SearchResults.Add( m_AdvertisedSessions[ ( *matchingIndices )[ index ] ] );
+				}
+			}
+
+			if ( batch < numBatches )
+				return;
+
+			search->SearchState = bFailed ? EOnlineAsyncTaskState::Failed : EOnlineAsyncTaskState::Done;
+			m_ActiveSearch.Reset();
+
+			TriggerOnFindSessionsCompleteDelegates( !bFailed );
+		}, true );
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 진행 중인 세션 찾기를 취소한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::CancelFindSessions()
+{
+	if ( !m_ActiveSearch.IsValid() )
+		return false;
+
+	m_PendingEvents.RemoveAll( []( const FPendingEvent& pendingEvent )
+	{
+		return pendingEvent.bIsFind;
+	} );
+	m_PendingEvents.Heapify( MultiplayerFakeSessionBackend::FEarliestFirst() );
+
+	m_ActiveSearch->SearchState = EOnlineAsyncTaskState::Failed;
+	m_ActiveSearch.Reset();
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션에 참가한다. 빈 슬롯은 도착 시점의 광고 상태로 판단한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::JoinSession( const FUniqueNetId& localPlayerId, FName sessionName, const FOnlineSessionSearchResult& desiredSession )
+{
+	if ( m_NamedSessions.Contains( sessionName ) )
+		return false;
+
+	TSharedRef< FNamedOnlineSession > namedSession = MakeShared< FNamedOnlineSession >( sessionName, desiredSession.Session );
+	namedSession->bHosting	   = false;
+	namedSession->SessionState = EOnlineSessionState::Creating;
+	m_NamedSessions.Add( sessionName, namedSession );
+
+	const bool bFailed = Roll( m_Config.JoinFailureRate );
+	const bool bLostRace = Roll( m_Config.FullLobbyRaceRate );
+
+	Schedule( SampleLatency(), [ this, sessionName, bFailed, bLostRace, hostName = desiredSession.Session.OwningUserName, weakSession = TWeakPtr< FNamedOnlineSession >( namedSession ) ]()
+	{
+		EOnJoinSessionCompleteResult::Type result = EOnJoinSessionCompleteResult::UnknownError;
+
+		const int32* advertisedIndex = m_AdvertisedSessionIndices.Find( hostName );
+		if ( bFailed )
+		{
+			result = EOnJoinSessionCompleteResult::UnknownError;
+		}
+		else if ( nullptr == advertisedIndex )
+		{
+			result = EOnJoinSessionCompleteResult::SessionDoesNotExist;
+		}
+		else
+		{
+			FOnlineSession& advertisedSession = m_AdvertisedSessions[ *advertisedIndex ].Session;
+
+			// 다른 플레이어가 먼저 마지막 슬롯을 차지했다. 그 플레이어가 곧 나갈 수 있으므로 광고 슬롯은 그대로 둔다.
+			if ( bLostRace || advertisedSession.NumOpenPublicConnections <= 0 )
+			{
+				result = EOnJoinSessionCompleteResult::SessionIsFull;
+			}
+			else
+			{
+				--advertisedSession.NumOpenPublicConnections;
+				result = EOnJoinSessionCompleteResult::Success;
+			}
+		}
+
+		TSharedPtr< FNamedOnlineSession > pinnedSession = weakSession.Pin();
+		if ( pinnedSession.IsValid() )
+		{
+			if ( EOnJoinSessionCompleteResult::Success == result )
+			{
+				pinnedSession->SessionState = EOnlineSessionState::Pending;
+			}
+			else
+			{
+				m_NamedSessions.Remove( sessionName );
+			}
+		}
+
+		TriggerOnJoinSessionCompleteDelegates( sessionName, result );
+	} );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 이름으로 세션을 찾는다. 없으면 nullptr
+////////////////////////////////////////////////////////////////////////////
+FNamedOnlineSession* FMultiplayerFakeSessionBackend::GetNamedSession( FName sessionName )
+{
+	TSharedRef< FNamedOnlineSession >* namedSession = m_NamedSessions.Find( sessionName );
+	return nullptr != namedSession ? &namedSession->Get() : nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 참가한 세션의 접속 주소를 얻는다. ( 루프백 주소에 광고 인덱스별 포트 )
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::GetResolvedConnectString( FName sessionName, FString& connectInfo )
+{
+	const FNamedOnlineSession* namedSession = GetNamedSession( sessionName );
+	if ( nullptr == namedSession || namedSession->bHosting )
+		return false;
+
+	const int32* advertisedIndex = m_AdvertisedSessionIndices.Find( namedSession->OwningUserName );
+	if ( nullptr == advertisedIndex )
+		return false;
+
+	connectInfo = FString::Printf( TEXT( "127.0.0.1:%d" ), MultiplayerFakeSessionBackend::BasePort + *advertisedIndex % 20000 );
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 검색 결과의 접속 주소를 얻는다. ( 참가한 세션과 같은 규칙 )
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::GetResolvedConnectString( const FOnlineSessionSearchResult& searchResult, FName portType, FString& connectInfo )
+{
+	const int32* advertisedIndex = m_AdvertisedSessionIndices.Find( searchResult.Session.OwningUserName );
+	if ( nullptr == advertisedIndex )
+		return false;
+
+	connectInfo = FString::Printf( TEXT( "127.0.0.1:%d" ), MultiplayerFakeSessionBackend::BasePort + *advertisedIndex % 20000 );
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// LAN 세션을 사용하는 백엔드인지 여부
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::IsLAN() const
+{
+	return m_Config.bIsLAN;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 지연 시간 후에 실행할 작업을 예약한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerFakeSessionBackend::Schedule( double delaySeconds, TFunction< void() >&& execute, bool bIsFind )
+{
+	FPendingEvent pendingEvent;
+	pendingEvent.DueTime  = FPlatformTime::Seconds() + delaySeconds;
+	pendingEvent.Sequence = m_NextSequence++;
+	pendingEvent.bIsFind  = bIsFind;
+	pendingEvent.Execute  = MoveTemp( execute );
+
+	m_PendingEvents.HeapPush( MoveTemp( pendingEvent ), MultiplayerFakeSessionBackend::FEarliestFirst() );
+
+	if ( !m_TickerHandle.IsValid() )
+	{
+		m_TickerHandle = FTSTicker::GetCoreTicker().AddTicker( FTickerDelegate::CreateRaw( this, &FMultiplayerFakeSessionBackend::Tick ) );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 설정된 분포로 지연 시간 ( 초 ) 을 뽑는다.
+////////////////////////////////////////////////////////////////////////////
+double FMultiplayerFakeSessionBackend::SampleLatency()
+{
+	// 기본 지연에 지수 분포 꼬리를 더해 실제 백엔드처럼 가끔 느린 응답을 만든다.
+	const double jitterMs = -FMath::Loge( 1.0 - m_Random.FRand() ) * FMath::Max( m_Config.LatencyJitterMs, 0.f );
+	return ( FMath::Max( m_Config.LatencyMs, 0.f ) + jitterMs ) / 1000.0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 확률 rate 로 true 를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::Roll( float rate )
+{
+	return rate > 0.f && m_Random.FRand() < rate;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 광고 세션을 만든다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerFakeSessionBackend::BuildAdvertisedSessions()
+{
+	FMultiplayerSessionBenchmark::MakeSyntheticResults( m_Config.NumSessions, m_Config.MatchTypes, m_Config.Seed, m_AdvertisedSessions, m_Config.NumRegions );
+
+	m_AdvertisedSessionIndices.Reset();
+	m_AdvertisedSessionIndices.Reserve( m_AdvertisedSessions.Num() );
+
+	for ( int32 index = 0; index < m_AdvertisedSessions.Num(); ++index )
+	{
+		FOnlineSessionSearchResult& searchResult = m_AdvertisedSessions[ index ];
+		searchResult.Session.OwningUserName = FString::Printf( TEXT( "FakeHost_%d" ), index );
+		searchResult.Session.SessionSettings.bIsLANMatch = m_Config.bIsLAN;
+
+		m_AdvertisedSessionIndices.Add( searchResult.Session.OwningUserName, index );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 코어 티커에서 이벤트를 처리한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerFakeSessionBackend::Tick( float deltaTime )
+{
+	Pump( FPlatformTime::Seconds() );
+
+	if ( m_PendingEvents.Num() > 0 )
+		return true;
+
+	m_TickerHandle.Reset();
+	return false;
+}
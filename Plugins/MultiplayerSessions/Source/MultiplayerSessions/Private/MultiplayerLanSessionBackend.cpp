@@ -0,0 +1,1003 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerLanSessionBackend.h"
+#include "MultiplayerSessions.h"
+#include "MultiplayerSessionAdvertisement.h"
+#include "MultiplayerSessionIndex.h"
+#include "Common/UdpSocketBuilder.h"
+#include "Containers/Queue.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "Tasks/Task.h"
+#include <atomic>
+
+
+const TCHAR* FMultiplayerLanDiscoveryConfig::ConfigSection = TEXT( "MultiplayerSessions.LanDiscovery" );
+
+const FName FMultiplayerLanSessionInfo::SessionIdType( TEXT( "MultiplayerLan" ) );
+
+
+namespace MultiplayerLanSessionBackend
+{
+	/// 탐색 요청 / 응답 패킷 식별자
+	static constexpr uint32 QueryMagic{ 0x4D504C51 };	// MPLQ
+	static constexpr uint32 ReplyMagic{ 0x4D504C52 };	// MPLR
+
+	/// 패킷 버전 ( 버전이 다른 패킷은 무시한다 )
+	static constexpr uint8 ProtocolVersion{ 2 };
+
+	/// 최대 패킷 크기 ( 짧은 문자열 4 개가 모두 가득 차도 들어가고, 한 데이터그램으로 보낼 수 있는 크기 )
+	static constexpr int32 MaxPacketSize{ 1200 };
+
+	/// 한 번에 탐색하는 최대 주소:포트 수
+	static constexpr int32 MaxEndpoints{ 65536 };
+
+	/// 비콘이 한 틱에 처리하는 최대 탐색 요청 수
+	static constexpr int32 MaxQueriesPerTick{ 64 };
+
+	/// 탐색 작업이 취소를 확인하는 간격 ( 초 )
+	static constexpr double CancelPollInterval{ 0.05 };
+
+	/// 세션 응답
+	struct FBeaconReply
+	{
+		/// 탐색 요청 번호
+		uint64 Nonce{ 0 };
+
+		/// 세션 아이디
+		FGuid SessionGuid;
+
+		/// 호스트 세션 이름
+		FString HostSessionName;
+
+		/// 호스트 이름
+		FString OwningUserName;
+
+		/// 게임 접속 포트
+		int32 GamePort{ 0 };
+
+		/// 최대 접속 수
+		int32 NumPublicConnections{ 0 };
+
+		/// 빈 슬롯 수
+		int32 NumOpenSlots{ 0 };
+
+		/// 빌드 아이디
+		int32 BuildUniqueId{ 0 };
+
+		/// 묶은 광고
+		int64 Advertisement{ 0 };
+
+		/// MatchType 문자열 ( 광고 값이 없는 사용자 정의 매치 타입 )
+		FString MatchType;
+
+		/// 광고한 맵 ( 참가하는 쪽이 미리 로드한다 )
+		FString MapName;
+
+		/// QoS 에코 포트 ( 0 이면 응답하지 않는다 )
+		int32 QosPort{ 0 };
+
+		/// 응답한 주소 ( 탐색하는 쪽에서 채운다 )
+		FString HostAddress;
+
+		/// 요청부터 응답까지의 시간 ( ms, 탐색하는 쪽에서 채운다 )
+		int32 PingInMs{ 0 };
+	};
+
+	/// 255 바이트 이하 UTF-8 문자열을 쓴다.
+	static void WriteShortString( FArchive& ar, const FString& value )
+	{
+		FTCHARToUTF8 utf8( *value );
+		uint8 length = static_cast< uint8 >( FMath::Min( utf8.Length(), static_cast< int32 >( MAX_uint8 ) ) );
+
+		ar << length;
+		ar.Serialize( const_cast< void* >( static_cast< const void* >( utf8.Get() ) ), length );
+	}
+
+	/// 255 바이트 이하 UTF-8 문자열을 읽는다.
+	static bool ReadShortString( FArchive& ar, FString& outValue )
+	{
+		uint8 length = 0;
+		ar << length;
+
+		ANSICHAR buffer[ MAX_uint8 + 1 ];
+		ar.Serialize( buffer, length );
+		if ( ar.IsError() )
+			return false;
+
+		FUTF8ToTCHAR converted( buffer, length );
+		outValue = FString( converted.Length(), converted.Get() );
+
+		return true;
+	}
+
+	/// 탐색 요청 패킷을 만든다.
+	static void WriteQuery( uint64 nonce, TArray< uint8 >& outPacket )
+	{
+		FMemoryWriter writer( outPacket );
+
+		uint32 magic   = QueryMagic;
+		uint8  version = ProtocolVersion;
+		writer << magic << version << nonce;
+	}
+
+	/// 탐색 요청 패킷을 읽는다.
+	static bool ReadQuery( const uint8* data, int32 size, uint64& outNonce )
+	{
+		FMemoryReaderView reader( MakeArrayView( data, size ) );
+
+		uint32 magic   = 0;
+		uint8  version = 0;
+		reader << magic << version << outNonce;
+
+		return !reader.IsError() && QueryMagic == magic && ProtocolVersion == version;
+	}
+
+	/// 세션 응답 패킷을 만든다.
+	static void WriteReply( FBeaconReply& reply, TArray< uint8 >& outPacket )
+	{
+		FMemoryWriter writer( outPacket );
+
+		uint32 magic   = ReplyMagic;
+		uint8  version = ProtocolVersion;
+		writer << magic << version << reply.Nonce << reply.SessionGuid;
+
+		WriteShortString( writer, reply.HostSessionName );
+		WriteShortString( writer, reply.OwningUserName );
+
+		writer << reply.GamePort << reply.NumPublicConnections << reply.NumOpenSlots << reply.BuildUniqueId << reply.Advertisement;
+
+		WriteShortString( writer, reply.MatchType );
+		WriteShortString( writer, reply.MapName );
+
+		writer << reply.QosPort;
+	}
+
+	/// 세션 응답 패킷을 읽는다. 다른 탐색의 응답이면 false
+	static bool ReadReply( const uint8* data, int32 size, uint64 nonce, FBeaconReply& outReply )
+	{
+		FMemoryReaderView reader( MakeArrayView( data, size ) );
+
+		uint32 magic   = 0;
+		uint8  version = 0;
+		reader << magic << version << outReply.Nonce;
+
+		if ( reader.IsError() || ReplyMagic != magic || ProtocolVersion != version || nonce != outReply.Nonce )
+			return false;
+
+		reader << outReply.SessionGuid;
+
+		if ( !ReadShortString( reader, outReply.HostSessionName ) || !ReadShortString( reader, outReply.OwningUserName ) )
+			return false;
+
+		reader << outReply.GamePort << outReply.NumPublicConnections << outReply.NumOpenSlots << outReply.BuildUniqueId << outReply.Advertisement;
+
+		if ( !ReadShortString( reader, outReply.MatchType ) || !ReadShortString( reader, outReply.MapName ) )
+			return false;
+
+		reader << outReply.QosPort;
+
+		return !reader.IsError() && outReply.SessionGuid.IsValid();
+	}
+
+	/// 주소 항목을 호스트 주소 목록으로 펼친다. ( 10.0.0.1-254 는 마지막 자리 범위 )
+	static void ExpandProbeAddress( const FString& entry, TArray< FString >& outHosts )
+	{
+		const FString address = entry.TrimStartAndEnd();
+
+		FString first;
+		FString last;
+		if ( !address.Split( TEXT( "-" ), &first, &last ) )
+		{
+			outHosts.Add( address );
+			return;
+		}
+
+		FString prefix;
+		FString firstOctet;
+		if ( !first.Split( TEXT( "." ), &prefix, &firstOctet, ESearchCase::CaseSensitive, ESearchDir::FromEnd ) )
+			return;
+
+		const int32 begin = FMath::Clamp( FCString::Atoi( *firstOctet ), 0, 255 );
+		const int32 end	  = FMath::Clamp( FCString::Atoi( *last ), begin, 255 );
+
+		for ( int32 octet = begin; octet <= end; ++octet )
+		{
+			outHosts.Add( FString::Printf( TEXT( "%s.%d" ), *prefix, octet ) );
+		}
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 워커 작업과 공유하는 탐색 상태
+////////////////////////////////////////////////////////////////////////////
+struct FMultiplayerLanDiscovery
+{
+	/// 탐색 요청 번호 ( 이전 탐색의 늦은 응답을 거른다 )
+	uint64 Nonce{ 0 };
+
+	/// 응답을 기다리는 시간 ( 초 )
+	double ProbeTimeout{ 0.0 };
+
+	/// 도착한 응답 ( 워커 작업 → 게임 스레드 )
+	TQueue< MultiplayerLanSessionBackend::FBeaconReply, EQueueMode::Mpsc > Replies;
+
+	/// 끝난 탐색 작업 수
+	std::atomic< int32 > NumShardsDone{ 0 };
+
+	/// 취소 여부
+	std::atomic< bool > bCancelled{ false };
+};
+
+
+namespace MultiplayerLanSessionBackend
+{
+	/// 샤드의 주소:포트로 탐색 요청을 보내고 제한 시간까지 응답을 모은다. ( 워커 작업 )
+	static void ProbeShard( const TSharedRef< FMultiplayerLanDiscovery, ESPMode::ThreadSafe >& discovery, const TArray< TSharedRef< FInternetAddr > >& shard )
+	{
+		ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get( PLATFORM_SOCKETSUBSYSTEM );
+
+		FSocket* socket = nullptr != socketSubsystem
+			? FUdpSocketBuilder( TEXT( "MultiplayerLanProbe" ) ).AsNonBlocking().WithBroadcast().Build()
+			: nullptr;
+
+		if ( nullptr != socket )
+		{
+			TArray< uint8 > query;
+			WriteQuery( discovery->Nonce, query );
+
+			// 샤드의 요청을 한 번에 보내고 응답은 같은 소켓에서 모은다. 대기 시간은 주소 수와 무관하게 샤드당 한 번이다.
+			const double sendTime = FPlatformTime::Seconds();
+			for ( const TSharedRef< FInternetAddr >& address : shard )
+			{
+				int32 bytesSent = 0;
+				socket->SendTo( query.GetData(), query.Num(), bytesSent, *address );
+			}
+
+			const double deadline = sendTime + discovery->ProbeTimeout;
+
+			TSharedRef< FInternetAddr > fromAddress = socketSubsystem->CreateInternetAddr();
+			uint8 buffer[ MaxPacketSize ];
+
+			while ( !discovery->bCancelled )
+			{
+				const double remaining = deadline - FPlatformTime::Seconds();
+				if ( remaining <= 0.0 )
+					break;
+
+				if ( !socket->Wait( ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds( FMath::Min( remaining, CancelPollInterval ) ) ) )
+					continue;
+
+				int32 bytesRead = 0;
+				while ( socket->RecvFrom( buffer, MaxPacketSize, bytesRead, *fromAddress ) && bytesRead > 0 )
+				{
+					FBeaconReply reply;
+					if ( !ReadReply( buffer, bytesRead, discovery->Nonce, reply ) )
+						continue;
+
+					reply.HostAddress = fromAddress->ToString( false );
+					reply.PingInMs	  = static_cast< int32 >( ( FPlatformTime::Seconds() - sendTime ) * 1000.0 );
+
+					discovery->Replies.Enqueue( MoveTemp( reply ) );
+				}
+			}
+
+			socketSubsystem->DestroySocket( socket );
+		}
+
+		// 응답을 모두 넣은 후에 완료를 알린다. ( 게임 스레드는 완료 수를 먼저 읽고 응답을 꺼낸다 )
+		++discovery->NumShardsDone;
+	}
+
+	/// 응답으로 검색 결과를 만든다.
+	static FOnlineSessionSearchResult MakeSearchResult( const FBeaconReply& reply )
+	{
+		FOnlineSessionSearchResult searchResult;
+		searchResult.PingInMs = reply.PingInMs;
+
+		FOnlineSession& session = searchResult.Session;
+		session.OwningUserName			 = reply.OwningUserName;
+		session.NumOpenPublicConnections = reply.NumOpenSlots;
+		session.SessionInfo				 = MakeShared< FMultiplayerLanSessionInfo >( reply.SessionGuid, reply.HostAddress, reply.GamePort );
+
+		FOnlineSessionSettings& settings = session.SessionSettings;
+		settings.NumPublicConnections = reply.NumPublicConnections;
+		settings.BuildUniqueId		  = reply.BuildUniqueId;
+		settings.bIsLANMatch		  = true;
+		settings.bShouldAdvertise	  = true;
+		settings.bAllowJoinInProgress = true;
+
+		FMultiplayerSessionAdvertisement advertisement;
+		if ( FMultiplayerSessionAdvertisement::Decode( reply.Advertisement, advertisement ) )
+		{
+			advertisement.Write( settings );
+		}
+
+		if ( !reply.HostSessionName.IsEmpty() )
+		{
+			settings.Set( FMultiplayerSessionIndex::HostSessionKey, reply.HostSessionName, EOnlineDataAdvertisementType::ViaOnlineService );
+		}
+
+		// 온라인 서비스가 광고하는 다른 세팅도 그대로 옮겨서, 검색 조건과 참가 준비가 백엔드와 무관하게 같도록 한다.
+		if ( !reply.MatchType.IsEmpty() )
+		{
+			settings.Set( FMultiplayerSessionIndex::MatchTypeKey, reply.MatchType, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing );
+		}
+
+		if ( !reply.MapName.IsEmpty() )
+		{
+			settings.Set( SETTING_MAPNAME, reply.MapName, EOnlineDataAdvertisementType::ViaOnlineService );
+		}
+
+		if ( reply.QosPort > 0 )
+		{
+			settings.Set( FMultiplayerSessionIndex::QosPortKey, reply.QosPort, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing );
+		}
+
+		return searchResult;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 설정 파일과 명령줄에서 설정을 읽는다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerLanDiscoveryConfig FMultiplayerLanDiscoveryConfig::Load()
+{
+	FMultiplayerLanDiscoveryConfig config;
+
+	if ( GConfig )
+	{
+		TArray< FString > probeAddresses;
+		GConfig->GetArray( ConfigSection, TEXT( "ProbeAddresses" ), probeAddresses, GGameIni );
+		if ( probeAddresses.Num() > 0 )
+		{
+			config.ProbeAddresses = MoveTemp( probeAddresses );
+		}
+
+		GConfig->GetBool(	ConfigSection, TEXT( "bEnabled" ),				config.bEnabled,			GGameIni );
+		GConfig->GetInt(	ConfigSection, TEXT( "BasePort" ),				config.BasePort,			GGameIni );
+		GConfig->GetInt(	ConfigSection, TEXT( "NumPorts" ),				config.NumPorts,			GGameIni );
+		GConfig->GetInt(	ConfigSection, TEXT( "ShardSize" ),				config.ShardSize,			GGameIni );
+		GConfig->GetInt(	ConfigSection, TEXT( "MaxConcurrentShards" ),	config.MaxConcurrentShards,	GGameIni );
+		GConfig->GetFloat(	ConfigSection, TEXT( "ProbeTimeout" ),			config.ProbeTimeout,		GGameIni );
+		GConfig->GetInt(	ConfigSection, TEXT( "GamePort" ),				config.GamePort,			GGameIni );
+	}
+
+	// 한 장비에 여러 프로세스를 띄울 때 인스턴스마다 바꾸는 값
+	const TCHAR* commandLine = FCommandLine::Get();
+	FParse::Value( commandLine, TEXT( "LanBeaconPort=" ), config.BeaconPort );
+
+	FString probeAddresses;
+	if ( FParse::Value( commandLine, TEXT( "LanProbe=" ), probeAddresses, false ) )
+	{
+		probeAddresses.ParseIntoArray( config.ProbeAddresses, TEXT( "," ) );
+	}
+
+	config.NumPorts			   = FMath::Max( config.NumPorts, 1 );
+	config.ShardSize		   = FMath::Max( config.ShardSize, 1 );
+	config.MaxConcurrentShards = FMath::Max( config.MaxConcurrentShards, 1 );
+	config.ProbeTimeout		   = FMath::Max( config.ProbeTimeout, 0.01f );
+
+	return config;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 생성자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerLanSessionInfo::FMultiplayerLanSessionInfo( const FGuid& sessionGuid, const FString& hostAddress, int32 gamePort )
+	: SessionGuid( sessionGuid ),
+	  HostAddress( hostAddress ),
+	  GamePort	 ( gamePort ),
+	  m_SessionId( FUniqueNetIdString::Create( sessionGuid.ToString(), SessionIdType ) )
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 접속 주소 ( 주소:포트 ) 를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+FString FMultiplayerLanSessionInfo::GetConnectString() const
+{
+	return FString::Printf( TEXT( "%s:%d" ), *HostAddress, GamePort );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// LAN 탐색으로 찾은 세션 정보이면 반환한다. 아니면 nullptr
+////////////////////////////////////////////////////////////////////////////
+const FMultiplayerLanSessionInfo* FMultiplayerLanSessionInfo::Get( const FOnlineSession& session )
+{
+	if ( !session.SessionInfo.IsValid() || SessionIdType != session.SessionInfo->GetSessionId().GetType() )
+		return nullptr;
+
+	return static_cast< const FMultiplayerLanSessionInfo* >( session.SessionInfo.Get() );
+}
+
+const uint8* FMultiplayerLanSessionInfo::GetBytes() const
+{
+	return nullptr;
+}
+
+int32 FMultiplayerLanSessionInfo::GetSize() const
+{
+	return sizeof( FMultiplayerLanSessionInfo );
+}
+
+bool FMultiplayerLanSessionInfo::IsValid() const
+{
+	return SessionGuid.IsValid() && !HostAddress.IsEmpty();
+}
+
+const FUniqueNetId& FMultiplayerLanSessionInfo::GetSessionId() const
+{
+	return *m_SessionId;
+}
+
+FString FMultiplayerLanSessionInfo::ToString() const
+{
+	return SessionGuid.ToString();
+}
+
+FString FMultiplayerLanSessionInfo::ToDebugString() const
+{
+	return FString::Printf( TEXT( "SessionId: %s Host: %s" ), *SessionGuid.ToString(), *GetConnectString() );
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 생성자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerLanSessionBackend::FMultiplayerLanSessionBackend( const FMultiplayerLanDiscoveryConfig& config )
+	: m_Config( config )
+{
+	m_TickerHandle = FTSTicker::GetCoreTicker().AddTicker( FTickerDelegate::CreateRaw( this, &FMultiplayerLanSessionBackend::Tick ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 소멸자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerLanSessionBackend::~FMultiplayerLanSessionBackend()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker( m_TickerHandle );
+	m_TickerHandle.Reset();
+
+	// 워커 작업은 탐색 상태를 함께 들고 있으므로 취소만 알리고 기다리지 않는다.
+	StopDiscovery();
+	CloseBeacon();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 설정을 반환한다.
+////////////////////////////////////////////////////////////////////////////
+const FMultiplayerLanDiscoveryConfig& FMultiplayerLanSessionBackend::GetConfig() const
+{
+	return m_Config;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 비콘 포트를 반환한다. 호스팅 중이 아니면 0
+////////////////////////////////////////////////////////////////////////////
+int32 FMultiplayerLanSessionBackend::GetBeaconPort() const
+{
+	return m_BeaconPort;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 비콘 응답에 광고할 게임 접속 포트를 얻는 함수를 설정한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerLanSessionBackend::SetGamePortResolver( TFunction< int32() >&& resolver )
+{
+	m_GamePortResolver = MoveTemp( resolver );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 생성한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::CreateSession( const FUniqueNetId& hostingPlayerId, FName sessionName, const FOnlineSessionSettings& newSessionSettings )
+{
+	return CreateSession( 0, sessionName, newSessionSettings );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 로컬 플레이어 번호로 세션을 생성한다. 비콘 포트를 열지 못하면 검색에 나오지 않으므로 실패한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::CreateSession( int32 hostingPlayerNum, FName sessionName, const FOnlineSessionSettings& newSessionSettings )
+{
+	if ( m_NamedSessions.Contains( sessionName ) || !OpenBeacon() )
+		return false;
+
+	TSharedRef< FNamedOnlineSession > namedSession = MakeShared< FNamedOnlineSession >( sessionName, newSessionSettings );
+	namedSession->bHosting	   = true;
+	namedSession->SessionState = EOnlineSessionState::Pending;
+
+	m_NamedSessions.Add( sessionName, namedSession );
+	m_HostedSessionIds.Add( sessionName, FGuid::NewGuid() );
+
+	Defer( [ this, sessionName ]()
+	{
+		TriggerOnCreateSessionCompleteDelegates( sessionName, true );
+	} );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 시작한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::StartSession( FName sessionName )
+{
+	TSharedRef< FNamedOnlineSession >* namedSession = m_NamedSessions.Find( sessionName );
+	if ( nullptr == namedSession )
+		return false;
+
+	( *namedSession )->SessionState = EOnlineSessionState::InProgress;
+
+	Defer( [ this, sessionName ]()
+	{
+		TriggerOnStartSessionCompleteDelegates( sessionName, true );
+	} );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 설정을 갱신한다. 다음 탐색 응답부터 반영된다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::UpdateSession( FName sessionName, FOnlineSessionSettings& updatedSessionSettings )
+{
+	TSharedRef< FNamedOnlineSession >* namedSession = m_NamedSessions.Find( sessionName );
+	if ( nullptr == namedSession )
+		return false;
+
+	( *namedSession )->SessionSettings = updatedSessionSettings;
+
+	Defer( [ this, sessionName ]()
+	{
+		TriggerOnUpdateSessionCompleteDelegates( sessionName, true );
+	} );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 파괴한다. 호스팅 중인 세션이 없으면 비콘을 닫는다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::DestroySession( FName sessionName )
+{
+	if ( 0 == m_NamedSessions.Remove( sessionName ) )
+		return false;
+
+	m_HostedSessionIds.Remove( sessionName );
+	if ( m_HostedSessionIds.Num() <= 0 )
+	{
+		CloseBeacon();
+	}
+
+	Defer( [ this, sessionName ]()
+	{
+		TriggerOnDestroySessionCompleteDelegates( sessionName, true );
+	} );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션을 찾는다. 응답은 도착하는 대로 searchSettings->SearchResults 에 추가된다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::FindSessions( const FUniqueNetId& searchingPlayerId, const TSharedRef< FOnlineSessionSearch >& searchSettings )
+{
+	// 온라인 서브시스템처럼 검색은 한 번에 하나만 진행한다.
+	if ( m_ActiveSearch.IsValid() )
+		return false;
+
+	const FGuid nonce = FGuid::NewGuid();
+
+	m_Discovery = MakeShared< FMultiplayerLanDiscovery, ESPMode::ThreadSafe >();
+	m_Discovery->Nonce		  = ( static_cast< uint64 >( nonce.A ) << 32 ) | nonce.B;
+	m_Discovery->ProbeTimeout = m_Config.ProbeTimeout;
+
+	BuildShards();
+
+	if ( m_Shards.Num() <= 0 )
+	{
+		StopDiscovery();
+		return false;
+	}
+
+	m_ActiveSearch = searchSettings;
+
+	searchSettings->SearchState = EOnlineAsyncTaskState::InProgress;
+	searchSettings->SearchResults.Reset();
+
+	LaunchShards();
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 진행 중인 세션 찾기를 취소한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::CancelFindSessions()
+{
+	if ( !m_ActiveSearch.IsValid() )
+		return false;
+
+	StopDiscovery();
+
+	m_ActiveSearch->SearchState = EOnlineAsyncTaskState::Failed;
+	m_ActiveSearch.Reset();
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션에 참가한다. 빈 슬롯은 접속할 때 호스트가 확인한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::JoinSession( const FUniqueNetId& localPlayerId, FName sessionName, const FOnlineSessionSearchResult& desiredSession )
+{
+	if ( m_NamedSessions.Contains( sessionName ) || nullptr == FMultiplayerLanSessionInfo::Get( desiredSession.Session ) )
+		return false;
+
+	TSharedRef< FNamedOnlineSession > namedSession = MakeShared< FNamedOnlineSession >( sessionName, desiredSession.Session );
+	namedSession->bHosting	   = false;
+	namedSession->SessionState = EOnlineSessionState::Pending;
+
+	m_NamedSessions.Add( sessionName, namedSession );
+
+	Defer( [ this, sessionName ]()
+	{
+		TriggerOnJoinSessionCompleteDelegates( sessionName, EOnJoinSessionCompleteResult::Success );
+	} );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 이름으로 세션을 찾는다. 없으면 nullptr
+////////////////////////////////////////////////////////////////////////////
+FNamedOnlineSession* FMultiplayerLanSessionBackend::GetNamedSession( FName sessionName )
+{
+	TSharedRef< FNamedOnlineSession >* namedSession = m_NamedSessions.Find( sessionName );
+	return nullptr != namedSession ? &namedSession->Get() : nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 참가한 세션의 접속 주소를 얻는다. ( 응답한 주소와 호스트가 광고한 게임 포트 )
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::GetResolvedConnectString( FName sessionName, FString& connectInfo )
+{
+	const FNamedOnlineSession* namedSession = GetNamedSession( sessionName );
+	if ( nullptr == namedSession || namedSession->bHosting )
+		return false;
+
+	const FMultiplayerLanSessionInfo* sessionInfo = FMultiplayerLanSessionInfo::Get( *namedSession );
+	if ( nullptr == sessionInfo || !sessionInfo->IsValid() )
+		return false;
+
+	connectInfo = sessionInfo->GetConnectString();
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 검색 결과의 접속 주소를 얻는다. ( 응답한 주소와 호스트가 광고한 게임 포트 )
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::GetResolvedConnectString( const FOnlineSessionSearchResult& searchResult, FName portType, FString& connectInfo )
+{
+	const FMultiplayerLanSessionInfo* sessionInfo = FMultiplayerLanSessionInfo::Get( searchResult.Session );
+	if ( nullptr == sessionInfo || !sessionInfo->IsValid() )
+		return false;
+
+	connectInfo = sessionInfo->GetConnectString();
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// LAN 세션을 사용하는 백엔드인지 여부
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::IsLAN() const
+{
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 비콘 포트 범위에서 비어 있는 포트로 비콘 소켓을 연다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::OpenBeacon()
+{
+	if ( nullptr != m_BeaconSocket )
+		return true;
+
+	// 포트를 공유하지 않으므로 같은 장비의 다른 호스트가 쓰는 포트는 건너뛴다.
+	const int32 firstPort = m_Config.BeaconPort > 0 ? m_Config.BeaconPort : m_Config.BasePort;
+	const int32 numPorts  = m_Config.BeaconPort > 0 ? 1 : m_Config.NumPorts;
+
+	for ( int32 port = firstPort; port < firstPort + numPorts; ++port )
+	{
+		m_BeaconSocket = FUdpSocketBuilder( TEXT( "MultiplayerLanBeacon" ) ).AsNonBlocking().BoundToPort( port ).Build();
+		if ( nullptr != m_BeaconSocket )
+		{
+			m_BeaconPort = port;
+
+			UE_LOG( LogMultiplayerSessions, Log, TEXT( "LAN beacon listening on port %d" ), port );
+			return true;
+		}
+	}
+
+	UE_LOG( LogMultiplayerSessions, Warning, TEXT( "No free LAN beacon port in %d-%d" ), firstPort, firstPort + numPorts - 1 );
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 비콘 소켓을 닫는다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerLanSessionBackend::CloseBeacon()
+{
+	if ( nullptr == m_BeaconSocket )
+		return;
+
+	if ( ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get( PLATFORM_SOCKETSUBSYSTEM ) )
+	{
+		socketSubsystem->DestroySocket( m_BeaconSocket );
+	}
+
+	m_BeaconSocket = nullptr;
+	m_BeaconPort   = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 광고할 게임 접속 포트를 반환한다. -port= 나 포트 충돌로 바뀐 리슨 포트를 설정 값보다 우선한다.
+////////////////////////////////////////////////////////////////////////////
+int32 FMultiplayerLanSessionBackend::ResolveGamePort() const
+{
+	const int32 listenPort = m_GamePortResolver ? m_GamePortResolver() : 0;
+	return listenPort > 0 ? listenPort : m_Config.GamePort;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 도착한 탐색 요청에 호스팅 중인 세션으로 응답한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerLanSessionBackend::ServeBeacon()
+{
+	using namespace MultiplayerLanSessionBackend;
+
+	if ( nullptr == m_BeaconSocket )
+		return;
+
+	ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get( PLATFORM_SOCKETSUBSYSTEM );
+	if ( nullptr == socketSubsystem )
+		return;
+
+	TSharedRef< FInternetAddr > fromAddress = socketSubsystem->CreateInternetAddr();
+	uint8 buffer[ MaxPacketSize ];
+	TArray< uint8 > packet;
+	int32 gamePort = 0;
+
+	int32 bytesRead = 0;
+	// 받을 것이 없어도 RecvFrom 이 성공하고 0 바이트를 돌려주는 소켓이 있으므로 거기서 멈춘다.
+	for ( int32 numQueries = 0; numQueries < MaxQueriesPerTick && m_BeaconSocket->RecvFrom( buffer, MaxPacketSize, bytesRead, *fromAddress ) && bytesRead > 0; ++numQueries )
+	{
+		FBeaconReply reply;
+		if ( !ReadQuery( buffer, bytesRead, reply.Nonce ) )
+			continue;
+
+		// 포트는 요청이 온 틱에 한 번만 얻는다.
+		if ( 0 == gamePort )
+		{
+			gamePort = ResolveGamePort();
+		}
+
+		// 한 프로세스가 여러 로비를 호스팅하면 세션마다 응답한다.
+		for ( const TPair< FName, FGuid >& hostedSession : m_HostedSessionIds )
+		{
+			const TSharedRef< FNamedOnlineSession >* namedSession = m_NamedSessions.Find( hostedSession.Key );
+			if ( nullptr == namedSession )
+				continue;
+
+			// 가득 찬 로비는 광고를 끄므로 검색에 나오지 않는다.
+			const FNamedOnlineSession& session = namedSession->Get();
+			if ( !session.SessionSettings.bShouldAdvertise )
+				continue;
+
+			FMultiplayerSessionAdvertisement advertisement;
+			const bool bHasAdvertisement = FMultiplayerSessionAdvertisement::Read( session.SessionSettings, advertisement );
+
+			reply.SessionGuid		   = hostedSession.Value;
+			reply.HostSessionName	   = hostedSession.Key.ToString();
+			reply.OwningUserName	   = FPlatformProcess::ComputerName();
+			reply.GamePort			   = gamePort;
+			reply.NumPublicConnections = session.SessionSettings.NumPublicConnections;
+			reply.NumOpenSlots		   = bHasAdvertisement ? advertisement.OpenSlots : session.NumOpenPublicConnections;
+			reply.BuildUniqueId		   = session.SessionSettings.BuildUniqueId;
+			reply.Advertisement		   = bHasAdvertisement ? advertisement.Encode() : 0;
+			reply.QosPort			   = 0;
+
+			reply.MatchType.Reset();
+			reply.MapName.Reset();
+			session.SessionSettings.Get( FMultiplayerSessionIndex::MatchTypeKey, reply.MatchType );
+			session.SessionSettings.Get( SETTING_MAPNAME, reply.MapName );
+			session.SessionSettings.Get( FMultiplayerSessionIndex::QosPortKey, reply.QosPort );
+
+			packet.Reset();
+			WriteReply( reply, packet );
+
+			int32 bytesSent = 0;
+			m_BeaconSocket->SendTo( packet.GetData(), packet.Num(), bytesSent, *fromAddress );
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 탐색할 주소:포트 목록을 샤드로 나눈다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerLanSessionBackend::BuildShards()
+{
+	using namespace MultiplayerLanSessionBackend;
+
+	m_Shards.Reset();
+	m_NextShard = 0;
+
+	ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get( PLATFORM_SOCKETSUBSYSTEM );
+	if ( nullptr == socketSubsystem )
+		return;
+
+	TArray< FString > hosts;
+	for ( const FString& probeAddress : m_Config.ProbeAddresses )
+	{
+		ExpandProbeAddress( probeAddress, hosts );
+	}
+
+	// 같은 주소의 포트끼리 이어서 담아, 샤드 하나가 서브넷 한 구역을 맡도록 한다.
+	int32 numEndpoints = 0;
+	for ( const FString& host : hosts )
+	{
+		bool bIsValid = false;
+		TSharedRef< FInternetAddr > hostAddress = socketSubsystem->CreateInternetAddr();
+		hostAddress->SetIp( *host, bIsValid );
+
+		if ( !bIsValid )
+		{
+			UE_LOG( LogMultiplayerSessions, Warning, TEXT( "Ignoring invalid LAN probe address %s" ), *host );
+			continue;
+		}
+
+		for ( int32 port = m_Config.BasePort; port < m_Config.BasePort + m_Config.NumPorts && numEndpoints < MaxEndpoints; ++port, ++numEndpoints )
+		{
+			if ( m_Shards.Num() <= 0 || m_Shards.Last().Num() >= m_Config.ShardSize )
+			{
+				m_Shards.AddDefaulted_GetRef().Reserve( m_Config.ShardSize );
+			}
+
+			TSharedRef< FInternetAddr > endpoint = hostAddress->Clone();
+			endpoint->SetPort( port );
+
+			m_Shards.Last().Add( endpoint );
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 동시 작업 수 안에서 탐색 작업을 시작한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerLanSessionBackend::LaunchShards()
+{
+	if ( !m_Discovery.IsValid() )
+		return;
+
+	const int32 numInFlight = m_NextShard - m_Discovery->NumShardsDone;
+
+	for ( int32 numLaunched = numInFlight; numLaunched < m_Config.MaxConcurrentShards && m_Shards.IsValidIndex( m_NextShard ); ++numLaunched )
+	{
+		// 작업은 응답을 기다리는 동안 소켓에서 대기하므로 백그라운드 우선순위로 돌린다.
+		UE::Tasks::Launch( UE_SOURCE_LOCATION,
+			[ discovery = m_Discovery.ToSharedRef(), shard = MoveTemp( m_Shards[ m_NextShard ] ) ]()
+			{
+				MultiplayerLanSessionBackend::ProbeShard( discovery, shard );
+			},
+			UE::Tasks::ETaskPriority::BackgroundNormal );
+
+		++m_NextShard;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 도착한 응답을 결과에 추가하고, 모든 작업이 끝났으면 검색을 완료한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerLanSessionBackend::DrainDiscovery()
+{
+	using namespace MultiplayerLanSessionBackend;
+
+	if ( !m_ActiveSearch.IsValid() || !m_Discovery.IsValid() )
+		return;
+
+	// 완료 수를 먼저 읽어야 끝난 작업의 응답을 빠뜨리지 않는다.
+	const int32 numShardsDone = m_Discovery->NumShardsDone;
+
+	FOnlineSessionSearch& search = *m_ActiveSearch;
+	const int32 maxResults = search.MaxSearchResults > 0 ? search.MaxSearchResults : MAX_int32;
+
+	FBeaconReply reply;
+	while ( search.SearchResults.Num() < maxResults && m_Discovery->Replies.Dequeue( reply ) )
+	{
+		// 브로드캐스트와 직접 주소로 같은 세션이 여러 번 응답할 수 있다.
+		bool bAlreadyFound = false;
+		m_FoundSessionIds.Add( reply.SessionGuid, &bAlreadyFound );
+		if ( bAlreadyFound )
+			continue;
+
+		FOnlineSessionSearchResult searchResult = MakeSearchResult( reply );
+
+		// LAN 호스트는 쿼리를 받지 않으므로 검색하는 쪽에서 거른다.
+		if ( !FMultiplayerSessionAdvertisement::MatchesQuery( searchResult.Session.SessionSettings, searchResult.Session.NumOpenPublicConnections, search.QuerySettings ) )
+			continue;
+
+		search.SearchResults.Add( MoveTemp( searchResult ) );
+	}
+
+	if ( search.SearchResults.Num() < maxResults )
+	{
+		LaunchShards();
+
+		if ( m_Shards.IsValidIndex( m_NextShard ) || numShardsDone < m_NextShard )
+			return;
+	}
+
+	// 완료 대리자에서 바로 다음 검색을 요청할 수 있으므로 상태를 먼저 정리한다.
+	TSharedPtr< FOnlineSessionSearch > finishedSearch = MoveTemp( m_ActiveSearch );
+	m_ActiveSearch.Reset();
+
+	StopDiscovery();
+
+	finishedSearch->SearchState = EOnlineAsyncTaskState::Done;
+
+	TriggerOnFindSessionsCompleteDelegates( true );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 진행 중인 탐색을 끝낸다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerLanSessionBackend::StopDiscovery()
+{
+	if ( m_Discovery.IsValid() )
+	{
+		m_Discovery->bCancelled = true;
+		m_Discovery.Reset();
+	}
+
+	m_Shards.Reset();
+	m_NextShard = 0;
+	m_FoundSessionIds.Reset();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 완료 대리자를 다음 틱에 호출한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerLanSessionBackend::Defer( TFunction< void() >&& completion )
+{
+	m_PendingCompletions.Add( MoveTemp( completion ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 코어 티커에서 비콘과 탐색을 처리한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerLanSessionBackend::Tick( float deltaTime )
+{
+	ServeBeacon();
+	DrainDiscovery();
+
+	// 완료 대리자에서 새 요청이 예약될 수 있으므로 꺼낸 후 호출한다.
+	TArray< TFunction< void() > > completions = MoveTemp( m_PendingCompletions );
+	m_PendingCompletions.Reset();
+
+	for ( TFunction< void() >& completion : completions )
+	{
+		completion();
+	}
+
+	return true;
+}
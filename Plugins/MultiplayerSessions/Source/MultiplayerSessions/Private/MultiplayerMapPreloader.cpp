@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerMapPreloader.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "Engine/World.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 생성자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerMapPreloader::FMultiplayerMapPreloader()
+{
+	m_PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw( this, &FMultiplayerMapPreloader::OnPostLoadMap );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 소멸자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerMapPreloader::~FMultiplayerMapPreloader()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove( m_PostLoadMapHandle );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 맵 패키지를 비동기로 미리 로드한다. 경로 뒤의 travel 옵션( ?listen 등 )은 무시한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerMapPreloader::Preload( const FString& mapPath )
+{
+	const FName packageName = GetMapPackageName( mapPath );
+	if ( packageName.IsNone() || m_Packages.Contains( packageName ) )
+		return;
+
+	// 이미 메모리에 있는 맵이면 붙잡아 두기만 한다.
+	if ( UPackage* existingPackage = FindPackage( nullptr, *packageName.ToString() ) )
+	{
+		m_Packages.Add( packageName, existingPackage );
+		return;
+	}
+
+	m_Packages.Add( packageName, nullptr );
+
+	// 로드 중에 서브시스템이 내려가도 ( PIE 종료, 메뉴에서 종료 ) 해제된 로더가 불리지 않도록 약한 참조로 묶는다.
+	LoadPackageAsync(
+		packageName.ToString(),
+		FLoadPackageAsyncDelegate::CreateSP( this, &FMultiplayerMapPreloader::OnPackageLoaded ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 맵 패키지가 로드되어 있는지 여부
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerMapPreloader::IsLoaded( const FString& mapPath ) const
+{
+	const TObjectPtr< UPackage >* package = m_Packages.Find( GetMapPackageName( mapPath ) );
+	return nullptr != package && nullptr != *package;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 붙잡아 둔 패키지를 모두 놓는다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerMapPreloader::Reset()
+{
+	m_Packages.Reset();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// travel URL 에서 맵 패키지 이름을 얻는다. 유효하지 않으면 NAME_None
+////////////////////////////////////////////////////////////////////////////
+FName FMultiplayerMapPreloader::GetMapPackageName( const FString& mapPath )
+{
+	FString packageName;
+	if ( !mapPath.Split( TEXT( "?" ), &packageName, nullptr ) )
+	{
+		packageName = mapPath;
+	}
+
+	// "/Game/Maps/Lobby.Lobby" 형태의 오브젝트 경로도 허용한다.
+	packageName = FPackageName::ObjectPathToPackageName( packageName );
+
+	if ( !FPackageName::IsValidLongPackageName( packageName ) )
+		return NAME_None;
+
+	return FName( *packageName );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// FGCObject
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerMapPreloader::AddReferencedObjects( FReferenceCollector& collector )
+{
+	for ( TPair< FName, TObjectPtr< UPackage > >& package : m_Packages )
+	{
+		collector.AddReferencedObject( package.Value );
+	}
+}
+
+FString FMultiplayerMapPreloader::GetReferencerName() const
+{
+	return TEXT( "FMultiplayerMapPreloader" );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 패키지 비동기 로드가 완료되었을 때 처리한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerMapPreloader::OnPackageLoaded( const FName& packageName, UPackage* loadedPackage, EAsyncLoadingResult::Type result )
+{
+	// 로드 중에 Reset 되었으면 붙잡지 않는다.
+	TObjectPtr< UPackage >* package = m_Packages.Find( packageName );
+	if ( nullptr == package )
+		return;
+
+	if ( EAsyncLoadingResult::Succeeded != result || nullptr == loadedPackage )
+	{
+		m_Packages.Remove( packageName );
+		return;
+	}
+
+	*package = loadedPackage;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 맵 로드가 완료되었을 때 처리한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerMapPreloader::OnPostLoadMap( UWorld* loadedWorld )
+{
+	if ( nullptr == loadedWorld )
+		return;
+
+	// 이동이 끝난 맵은 월드가 패키지를 붙잡고 있으므로 놓아준다.
+	m_Packages.Remove( loadedWorld->GetOutermost()->GetFName() );
+}
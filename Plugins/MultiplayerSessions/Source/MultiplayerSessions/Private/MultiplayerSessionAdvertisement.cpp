@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionAdvertisement.h"
+#include "MultiplayerSessionIndex.h"
+#include "OnlineSessionSettings.h"
+
+
+const FName FMultiplayerSessionAdvertisement::Key( TEXT( "Adv" ) );
+const FName FMultiplayerSessionAdvertisement::MatchTypeKey( TEXT( "MatchTypeId" ) );
+const FName FMultiplayerSessionAdvertisement::RegionKey( TEXT( "RegionId" ) );
+const FName FMultiplayerSessionAdvertisement::BuildKey( TEXT( "BuildId" ) );
+
+
+namespace MultiplayerSessionAdvertisement
+{
+	/// 필드별 비트 위치
+	constexpr int32 VersionShift	= 0;
+	constexpr int32 MatchTypeShift	= 4;
+	constexpr int32 RegionShift		= 12;
+	constexpr int32 BuildShift		= 20;
+	constexpr int32 SkillShift		= 36;
+	constexpr int32 SlotsShift		= 44;
+
+	constexpr uint64 VersionMask	= 0xF;
+	constexpr uint64 ByteMask		= 0xFF;
+	constexpr uint64 BuildMask		= 0xFFFF;
+
+	/// 이름이 있는 매치 타입 ( EMultiplayerMatchType 순서와 같다 )
+	static const FName KnownMatchTypeNames[] =
+	{
+		NAME_None,
+		FName( TEXT( "FreeForAll" ) ),
+		FName( TEXT( "TeamDeathMatch" ) ),
+		FName( TEXT( "CaptureTheFlag" ) ),
+	};
+	static_assert( UE_ARRAY_COUNT( KnownMatchTypeNames ) == static_cast< int32 >( EMultiplayerMatchType::NumKnown ), "Match type names must follow EMultiplayerMatchType" );
+
+	/// 사용자 정의 매치 타입 이름 ( MatchType_<값> )
+	static const FName CustomMatchTypeName( TEXT( "MatchType" ) );
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 광고를 int64 하나로 묶는다.
+////////////////////////////////////////////////////////////////////////////
+int64 FMultiplayerSessionAdvertisement::Encode() const
+{
+	using namespace MultiplayerSessionAdvertisement;
+
+	const uint64 packed =
+		  ( uint64( SchemaVersion ) & VersionMask )					<< VersionShift
+		| ( uint64( static_cast< uint8 >( MatchType ) ) & ByteMask )	<< MatchTypeShift
+		| ( uint64( Region ) & ByteMask )								<< RegionShift
+		| ( uint64( BuildId ) & BuildMask )								<< BuildShift
+		| ( uint64( SkillBand ) & ByteMask )							<< SkillShift
+		| ( uint64( OpenSlots ) & ByteMask )							<< SlotsShift;
+
+	return static_cast< int64 >( packed );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 묶은 광고를 푼다. 스키마 버전이 다르면 false
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerSessionAdvertisement::Decode( int64 packed, FMultiplayerSessionAdvertisement& outAdvertisement )
+{
+	using namespace MultiplayerSessionAdvertisement;
+
+	const uint64 bits = static_cast< uint64 >( packed );
+	if ( ( ( bits >> VersionShift ) & VersionMask ) != SchemaVersion )
+		return false;
+
+	outAdvertisement.MatchType = static_cast< EMultiplayerMatchType >( ( bits >> MatchTypeShift ) & ByteMask );
+	outAdvertisement.Region	   = static_cast< uint8 >( ( bits >> RegionShift ) & ByteMask );
+	outAdvertisement.BuildId   = static_cast< uint16 >( ( bits >> BuildShift ) & BuildMask );
+	outAdvertisement.SkillBand = static_cast< uint8 >( ( bits >> SkillShift ) & ByteMask );
+	outAdvertisement.OpenSlots = static_cast< uint8 >( ( bits >> SlotsShift ) & ByteMask );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 설정에 광고를 쓴다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionAdvertisement::Write( FOnlineSessionSettings& settings ) const
+{
+	settings.Set( Key, Encode(), EOnlineDataAdvertisementType::ViaOnlineServiceAndPing );
+	settings.Set( MatchTypeKey, static_cast< int32 >( MatchType ), EOnlineDataAdvertisementType::ViaOnlineService );
+	settings.Set( RegionKey, static_cast< int32 >( Region ), EOnlineDataAdvertisementType::ViaOnlineService );
+	settings.Set( BuildKey, static_cast< int32 >( BuildId ), EOnlineDataAdvertisementType::ViaOnlineService );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 설정에서 광고를 읽는다. 광고가 없거나 스키마 버전이 다르면 false
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerSessionAdvertisement::Read( const FOnlineSessionSettings& settings, FMultiplayerSessionAdvertisement& outAdvertisement )
+{
+	const FOnlineSessionSetting* setting = settings.Settings.Find( Key );
+	if ( nullptr == setting || EOnlineKeyValuePairDataType::Int64 != setting->Data.GetType() )
+		return false;
+
+	int64 packed = 0;
+	setting->Data.GetValue( packed );
+
+	return Decode( packed, outAdvertisement );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 백엔드가 걸러서 응답하도록 쿼리 키의 조건을 검색 쿼리에 추가한다. ( 매치 타입, 지역, 빌드, 최소 빈 슬롯 )
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionAdvertisement::AddQueryFilters( FOnlineSearchSettings& querySettings, const FMultiplayerSessionQueryKey& queryKey )
+{
+	const EMultiplayerMatchType matchType = ParseMatchType( queryKey.MatchType );
+	if ( EMultiplayerMatchType::None != matchType )
+	{
+		querySettings.Set( MatchTypeKey, static_cast< int32 >( matchType ), EOnlineComparisonOp::Equals );
+	}
+	else if ( !queryKey.MatchType.IsNone() )
+	{
+		// 값이 없는 사용자 정의 이름은 호스트가 함께 광고한 MatchType 문자열로 거른다.
+		querySettings.Set( FMultiplayerSessionIndex::MatchTypeKey, queryKey.MatchType.ToString(), EOnlineComparisonOp::Equals );
+	}
+
+	if ( INDEX_NONE != queryKey.Region )
+	{
+		querySettings.Set( RegionKey, queryKey.Region, EOnlineComparisonOp::Equals );
+	}
+
+	if ( INDEX_NONE != queryKey.BuildId )
+	{
+		querySettings.Set( BuildKey, queryKey.BuildId, EOnlineComparisonOp::Equals );
+	}
+
+	if ( queryKey.MinOpenSlots > 0 )
+	{
+		querySettings.Set( SEARCH_MINSLOTSAVAILABLE, queryKey.MinOpenSlots, EOnlineComparisonOp::GreaterThanEquals );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션이 AddQueryFilters 로 추가한 조건을 만족하는지 여부
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerSessionAdvertisement::MatchesQuery( const FOnlineSessionSettings& settings, int32 numOpenSlots, const FOnlineSearchSettings& querySettings )
+{
+	// 묶은 광고 없이 MatchType 문자열만 있는 세션은 이전 호스트다. ( 거르고 남은 세팅을 비운 결과는 여기에 들지 않는다 )
+	const bool bIsLegacySession = !settings.Settings.Contains( Key ) && settings.Settings.Contains( FMultiplayerSessionIndex::MatchTypeKey );
+
+	for ( const TPair< FName, FOnlineSessionSearchParam >& searchParam : querySettings.SearchParams )
+	{
+		if ( SEARCH_MINSLOTSAVAILABLE == searchParam.Key )
+		{
+			int32 minOpenSlots = 0;
+			searchParam.Value.Data.GetValue( minOpenSlots );
+
+			if ( numOpenSlots < minOpenSlots )
+				return false;
+
+			continue;
+		}
+
+		// Presence 같은 백엔드 조건은 백엔드가 처리한다.
+		if ( MatchTypeKey != searchParam.Key && RegionKey != searchParam.Key && BuildKey != searchParam.Key && FMultiplayerSessionIndex::MatchTypeKey != searchParam.Key )
+			continue;
+
+		if ( bIsLegacySession && FMultiplayerSessionIndex::MatchTypeKey != searchParam.Key )
+		{
+			// 이전 호스트는 지역과 빌드를 광고하지 않으므로 매치 타입만 MatchType 문자열로 비교한다.
+			if ( MatchTypeKey != searchParam.Key )
+				continue;
+
+			int32 matchTypeValue = 0;
+			searchParam.Value.Data.GetValue( matchTypeValue );
+
+			FString legacyMatchType;
+			if ( !settings.Get( FMultiplayerSessionIndex::MatchTypeKey, legacyMatchType )
+				|| FName( *legacyMatchType ) != GetMatchTypeName( static_cast< EMultiplayerMatchType >( matchTypeValue ) ) )
+				return false;
+
+			continue;
+		}
+
+		// 광고 필터는 모두 Equals 이다. 키가 없는 세션은 다른 스키마로 광고한 세션이다.
+		const FOnlineSessionSetting* setting = settings.Settings.Find( searchParam.Key );
+		if ( nullptr == setting || setting->Data != searchParam.Value.Data )
+			return false;
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 매치 타입 이름을 값으로 바꾼다. 모르는 이름이면 None
+////////////////////////////////////////////////////////////////////////////
+EMultiplayerMatchType FMultiplayerSessionAdvertisement::ParseMatchType( FName matchTypeName )
+{
+	using namespace MultiplayerSessionAdvertisement;
+
+	if ( matchTypeName.IsNone() )
+		return EMultiplayerMatchType::None;
+
+	// FName 비교는 정수 비교이므로 문자열을 만들지 않는다.
+	for ( int32 index = 1; index < UE_ARRAY_COUNT( KnownMatchTypeNames ); ++index )
+	{
+		if ( KnownMatchTypeNames[ index ] == matchTypeName )
+			return static_cast< EMultiplayerMatchType >( index );
+	}
+
+	// MatchType_<값> 은 FName 의 번호 부분에 값이 들어 있다.
+	if ( matchTypeName.IsEqual( CustomMatchTypeName, ENameCase::IgnoreCase, false ) )
+	{
+		const int32 value = NAME_INTERNAL_TO_EXTERNAL( matchTypeName.GetNumber() );
+		if ( value >= static_cast< int32 >( EMultiplayerMatchType::NumKnown ) && value <= MAX_uint8 )
+			return static_cast< EMultiplayerMatchType >( value );
+	}
+
+	return EMultiplayerMatchType::None;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 매치 타입 값을 이름으로 바꾼다. None 이면 NAME_None
+////////////////////////////////////////////////////////////////////////////
+FName FMultiplayerSessionAdvertisement::GetMatchTypeName( EMultiplayerMatchType matchType )
+{
+	using namespace MultiplayerSessionAdvertisement;
+
+	const int32 value = static_cast< int32 >( matchType );
+	if ( value < UE_ARRAY_COUNT( KnownMatchTypeNames ) )
+		return KnownMatchTypeNames[ value ];
+
+	return FName( CustomMatchTypeName, NAME_EXTERNAL_TO_INTERNAL( value ) );
+}
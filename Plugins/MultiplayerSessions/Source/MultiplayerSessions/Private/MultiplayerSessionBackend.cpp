@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionBackend.h"
+#include "OnlineSubsystem.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 기본 온라인 서브시스템으로 백엔드를 만든다. 세션 인터페이스가 없으면 nullptr
+////////////////////////////////////////////////////////////////////////////
+TSharedPtr< IMultiplayerSessionBackend > FMultiplayerOnlineSessionBackend::Create()
+{
+	IOnlineSubsystem* subSystem = IOnlineSubsystem::Get();
+	if ( nullptr == subSystem )
+		return nullptr;
+
+	// 서브 시스템으로 부터 세션 관리가 가능한 세션 인터페이스 정보를 가져온다.
+	IOnlineSessionPtr session = subSystem->GetSessionInterface();
+	if ( !session.IsValid() )
+		return nullptr;
+
+	// 테스트 용도일경우  SubSystemName == NuLL
+	const bool bIsLAN = subSystem->GetSubsystemName() == "NULL" ? true : false;
+
+	return MakeShared< FMultiplayerOnlineSessionBackend >( session, bIsLAN );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 생성자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerOnlineSessionBackend::FMultiplayerOnlineSessionBackend( IOnlineSessionPtr session, bool bIsLAN )
+	: m_Session( MoveTemp( session ) ),
+	  m_IsLAN  ( bIsLAN )
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 대리자는 온라인 세션 인터페이스에 직접 등록한다.
+////////////////////////////////////////////////////////////////////////////
+FDelegateHandle FMultiplayerOnlineSessionBackend::AddOnCreateSessionCompleteDelegate_Handle( const FOnCreateSessionCompleteDelegate& delegate )
+{
+	return m_Session->AddOnCreateSessionCompleteDelegate_Handle( delegate );
+}
+
+void FMultiplayerOnlineSessionBackend::ClearOnCreateSessionCompleteDelegate_Handle( FDelegateHandle& handle )
+{
+	m_Session->ClearOnCreateSessionCompleteDelegate_Handle( handle );
+}
+
+FDelegateHandle FMultiplayerOnlineSessionBackend::AddOnStartSessionCompleteDelegate_Handle( const FOnStartSessionCompleteDelegate& delegate )
+{
+	return m_Session->AddOnStartSessionCompleteDelegate_Handle( delegate );
+}
+
+void FMultiplayerOnlineSessionBackend::ClearOnStartSessionCompleteDelegate_Handle( FDelegateHandle& handle )
+{
+	m_Session->ClearOnStartSessionCompleteDelegate_Handle( handle );
+}
+
+FDelegateHandle FMultiplayerOnlineSessionBackend::AddOnUpdateSessionCompleteDelegate_Handle( const FOnUpdateSessionCompleteDelegate& delegate )
+{
+	return m_Session->AddOnUpdateSessionCompleteDelegate_Handle( delegate );
+}
+
+void FMultiplayerOnlineSessionBackend::ClearOnUpdateSessionCompleteDelegate_Handle( FDelegateHandle& handle )
+{
+	m_Session->ClearOnUpdateSessionCompleteDelegate_Handle( handle );
+}
+
+FDelegateHandle FMultiplayerOnlineSessionBackend::AddOnDestroySessionCompleteDelegate_Handle( const FOnDestroySessionCompleteDelegate& delegate )
+{
+	return m_Session->AddOnDestroySessionCompleteDelegate_Handle( delegate );
+}
+
+void FMultiplayerOnlineSessionBackend::ClearOnDestroySessionCompleteDelegate_Handle( FDelegateHandle& handle )
+{
+	m_Session->ClearOnDestroySessionCompleteDelegate_Handle( handle );
+}
+
+FDelegateHandle FMultiplayerOnlineSessionBackend::AddOnFindSessionsCompleteDelegate_Handle( const FOnFindSessionsCompleteDelegate& delegate )
+{
+	return m_Session->AddOnFindSessionsCompleteDelegate_Handle( delegate );
+}
+
+void FMultiplayerOnlineSessionBackend::ClearOnFindSessionsCompleteDelegate_Handle( FDelegateHandle& handle )
+{
+	m_Session->ClearOnFindSessionsCompleteDelegate_Handle( handle );
+}
+
+FDelegateHandle FMultiplayerOnlineSessionBackend::AddOnJoinSessionCompleteDelegate_Handle( const FOnJoinSessionCompleteDelegate& delegate )
+{
+	return m_Session->AddOnJoinSessionCompleteDelegate_Handle( delegate );
+}
+
+void FMultiplayerOnlineSessionBackend::ClearOnJoinSessionCompleteDelegate_Handle( FDelegateHandle& handle )
+{
+	m_Session->ClearOnJoinSessionCompleteDelegate_Handle( handle );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 요청
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerOnlineSessionBackend::CreateSession( const FUniqueNetId& hostingPlayerId, FName sessionName, const FOnlineSessionSettings& newSessionSettings )
+{
+	return m_Session->CreateSession( hostingPlayerId, sessionName, newSessionSettings );
+}
+
+bool FMultiplayerOnlineSessionBackend::CreateSession( int32 hostingPlayerNum, FName sessionName, const FOnlineSessionSettings& newSessionSettings )
+{
+	return m_Session->CreateSession( hostingPlayerNum, sessionName, newSessionSettings );
+}
+
+bool FMultiplayerOnlineSessionBackend::StartSession( FName sessionName )
+{
+	return m_Session->StartSession( sessionName );
+}
+
+bool FMultiplayerOnlineSessionBackend::UpdateSession( FName sessionName, FOnlineSessionSettings& updatedSessionSettings )
+{
+	return m_Session->UpdateSession( sessionName, updatedSessionSettings );
+}
+
+bool FMultiplayerOnlineSessionBackend::DestroySession( FName sessionName )
+{
+	return m_Session->DestroySession( sessionName );
+}
+
+bool FMultiplayerOnlineSessionBackend::FindSessions( const FUniqueNetId& searchingPlayerId, const TSharedRef< FOnlineSessionSearch >& searchSettings )
+{
+	return m_Session->FindSessions( searchingPlayerId, searchSettings );
+}
+
+bool FMultiplayerOnlineSessionBackend::CancelFindSessions()
+{
+	return m_Session->CancelFindSessions();
+}
+
+bool FMultiplayerOnlineSessionBackend::JoinSession( const FUniqueNetId& localPlayerId, FName sessionName, const FOnlineSessionSearchResult& desiredSession )
+{
+	return m_Session->JoinSession( localPlayerId, sessionName, desiredSession );
+}
+
+FNamedOnlineSession* FMultiplayerOnlineSessionBackend::GetNamedSession( FName sessionName )
+{
+	return m_Session->GetNamedSession( sessionName );
+}
+
+bool FMultiplayerOnlineSessionBackend::GetResolvedConnectString( FName sessionName, FString& connectInfo )
+{
+	return m_Session->GetResolvedConnectString( sessionName, connectInfo );
+}
+
+bool FMultiplayerOnlineSessionBackend::GetResolvedConnectString( const FOnlineSessionSearchResult& searchResult, FName portType, FString& connectInfo )
+{
+	return m_Session->GetResolvedConnectString( searchResult, portType, connectInfo );
+}
+
+bool FMultiplayerOnlineSessionBackend::IsLAN() const
+{
+	return m_IsLAN;
+}
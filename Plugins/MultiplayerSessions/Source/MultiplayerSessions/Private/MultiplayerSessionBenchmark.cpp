@@ -0,0 +1,396 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionBenchmark.h"
+#include "MultiPlayerSessionsSubsystem.h"
+#include "MultiplayerFakeSessionBackend.h"
+#include "MultiplayerSessionAdvertisement.h"
+#include "MultiplayerSessionIndex.h"
+#include "MultiplayerSessionRanker.h"
+#include "MultiplayerSessionStats.h"
+#include "OnlineSessionSettings.h"
+#include "OnlineSubsystemTypes.h"
+#include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+namespace MultiplayerSessionBenchmark
+{
+	/// 서브시스템 작업 단계 결과
+	struct FOperationStage
+	{
+		/// 요청 → 완료 지연 시간
+		FMultiplayerLatencyHistogram Latency;
+
+		/// 요청 수 / 성공 수
+		int32 NumRequests{ 0 };
+		int32 NumSucceeded{ 0 };
+
+		/// 요청부터 완료까지 걸린 시간의 합 ( 초 )
+		double TotalSeconds{ 0.0 };
+	};
+
+	/// 서브시스템 작업 단계 결과를 JSON 으로 만든다. ( 작업은 하나씩 실행하므로 처리량은 요청 수 / 걸린 시간 )
+	static FString MakeOperationJson( const TCHAR* name, const FOperationStage& stage, bool bLast )
+	{
+		const FMultiplayerLatencySnapshot snapshot = stage.Latency.MakeSnapshot();
+		const double opsPerSecond = stage.TotalSeconds > 0.0 ? stage.NumRequests / stage.TotalSeconds : 0.0;
+
+		return FString::Printf( TEXT( "\t\t\"%s\": { \"count\": %d, \"succeeded\": %d, \"opsPerSec\": %.1f, \"meanMs\": %.4f, \"p50Ms\": %.4f, \"p95Ms\": %.4f, \"maxMs\": %.4f }%s\n" ),
+			name, stage.NumRequests, stage.NumSucceeded, opsPerSecond, snapshot.MeanMs, snapshot.P50Ms, snapshot.P95Ms, snapshot.MaxMs, bLast ? TEXT( "" ) : TEXT( "," ) );
+	}
+
+	/// 가짜 백엔드로 서브시스템의 세션 작업을 실행하고 단계별 결과를 JSON 으로 만든다.
+	static FString RunOperations( const FMultiplayerSessionBenchmarkConfig& config, const FString& matchType )
+	{
+		FMultiplayerFakeBackendConfig backendConfig;
+		backendConfig.NumSessions	  = config.NumAdvertisedSessions;
+		backendConfig.MatchTypes	  = { matchType };
+		backendConfig.LatencyMs		  = FMath::Max( config.BackendLatencyMs, 0.f );
+		backendConfig.LatencyJitterMs = 0.f;
+		backendConfig.Seed			  = config.Seed;
+
+		TSharedRef< FMultiplayerFakeSessionBackend > backend = MakeShared< FMultiplayerFakeSessionBackend >( backendConfig );
+		TStrongObjectPtr< UMultiPlayerSessionsSubsystem > subsystem = FMultiplayerSessionBenchmark::MakeHeadlessSubsystem( backend );
+
+		const bool bRealTime = config.BackendLatencyMs > 0.f;
+		const FName matchTypeName( *matchType );
+
+		// 호스트와 참가자는 서로 다른 세션 이름을 쓰므로 대기열이 섞이지 않는다.
+		const FUniqueNetIdPtr playerId = FUniqueNetIdString::Create( TEXT( "BenchmarkPlayer" ), FName( TEXT( "MultiplayerBenchmark" ) ) );
+		const FMultiplayerSessionTarget hostTarget( FName( TEXT( "BenchmarkHost" ) ), playerId );
+		const FMultiplayerSessionTarget joinTarget( NAME_GameSession, playerId );
+
+		FOperationStage createStage;
+		FOperationStage findStage;
+		FOperationStage joinStage;
+		FOperationStage destroyStage;
+
+		// 요청부터 서브시스템이 유휴 상태가 될 때까지를 잰다. 시간 안에 끝나지 않으면 false
+		auto measure = [ & ]( FOperationStage& stage, TFunctionRef< void() > request, TFunctionRef< bool() > succeeded )
+		{
+			const double startTime = FPlatformTime::Seconds();
+			request();
+			const bool bFinished = FMultiplayerSessionBenchmark::WaitUntilIdle( *subsystem, *backend, bRealTime, config.OperationTimeout );
+			const double elapsed = FPlatformTime::Seconds() - startTime;
+
+			stage.Latency.Record( elapsed );
+			stage.TotalSeconds += elapsed;
+			++stage.NumRequests;
+
+			if ( bFinished && succeeded() )
+			{
+				++stage.NumSucceeded;
+			}
+
+			return bFinished;
+		};
+
+		bool bFinished = true;
+		for ( int32 operation = 0; operation < config.NumOperations && bFinished; ++operation )
+		{
+			bFinished = measure( createStage,
+				[ & ]() { subsystem->CreateSession( hostTarget, 4, matchType ); },
+				[ & ]() { return nullptr != backend->GetNamedSession( hostTarget.SessionName ); } );
+
+			bFinished = bFinished && measure( destroyStage,
+				[ & ]() { subsystem->DestroySession( hostTarget ); },
+				[ & ]() { return nullptr == backend->GetNamedSession( hostTarget.SessionName ); } );
+
+			// 캐시 응답은 백엔드 왕복이 없으므로 매번 새로 검색한다.
+			bFinished = bFinished && measure( findStage,
+				[ & ]() { subsystem->InvalidateSearchCache(); subsystem->FindSessions( joinTarget, 10000, matchTypeName ); },
+				[ & ]() { return nullptr != subsystem->FindIndexedSession( matchTypeName ); } );
+
+			bFinished = bFinished && measure( joinStage,
+				[ & ]() { subsystem->JoinBestSession( joinTarget, matchTypeName, 3, 0.f ); },
+				[ & ]() { return nullptr != backend->GetNamedSession( joinTarget.SessionName ); } );
+
+			if ( bFinished && nullptr != backend->GetNamedSession( joinTarget.SessionName ) )
+			{
+				bFinished = measure( destroyStage,
+					[ & ]() { subsystem->DestroySession( joinTarget ); },
+					[ & ]() { return nullptr == backend->GetNamedSession( joinTarget.SessionName ); } );
+			}
+		}
+
+		FString json( TEXT( "\t\"operations\": {\n" ) );
+		json += FString::Printf( TEXT( "\t\t\"advertisedSessions\": %d,\n" ), backend->GetNumAdvertisedSessions() );
+		json += FString::Printf( TEXT( "\t\t\"backendLatencyMs\": %.1f,\n" ), backendConfig.LatencyMs );
+		json += FString::Printf( TEXT( "\t\t\"completed\": %s,\n" ), bFinished ? TEXT( "true" ) : TEXT( "false" ) );
+		json += MakeOperationJson( TEXT( "create" ),  createStage,	false );
+		json += MakeOperationJson( TEXT( "find" ),	  findStage,	false );
+		json += MakeOperationJson( TEXT( "join" ),	  joinStage,	false );
+		json += MakeOperationJson( TEXT( "destroy" ), destroyStage, true  );
+		json += TEXT( "\t},\n" );
+
+		return json;
+	}
+
+	/// 단계 결과를 JSON 으로 만든다.
+	static FString MakeStageJson( const TCHAR* name, const FMultiplayerLatencyHistogram& histogram, bool bLast )
+	{
+		const FMultiplayerLatencySnapshot snapshot = histogram.MakeSnapshot();
+
+		return FString::Printf( TEXT( "\t\t\"%s\": { \"count\": %llu, \"meanMs\": %.4f, \"p50Ms\": %.4f, \"p95Ms\": %.4f, \"maxMs\": %.4f }%s\n" ),
+			name, snapshot.Count, snapshot.MeanMs, snapshot.P50Ms, snapshot.P95Ms, snapshot.MaxMs, bLast ? TEXT( "" ) : TEXT( "," ) );
+	}
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice BenchmarkCommand(
+		TEXT( "MultiplayerSessions.Benchmark" ),
+		TEXT( "가짜 백엔드로 세션 작업 처리량 / 지연 시간과 합성 검색 결과 처리 비용을 측정합니다. " )
+		TEXT( "사용법 : MultiplayerSessions.Benchmark [numResults] [iterations] [path] [Ops=] [Sessions=] [LatencyMs=]" ),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda( []( const TArray< FString >& allArgs, UWorld*, FOutputDevice& output )
+		{
+			FMultiplayerSessionBenchmarkConfig config;
+
+			const FString params = FString::Join( allArgs, TEXT( " " ) );
+			FParse::Value( *params, TEXT( "Ops=" ),		  config.NumOperations );
+			FParse::Value( *params, TEXT( "Sessions=" ),  config.NumAdvertisedSessions );
+			FParse::Value( *params, TEXT( "LatencyMs=" ), config.BackendLatencyMs );
+
+			// 이름이 붙은 인자를 빼고 나머지는 순서대로 읽는다.
+			const TArray< FString > args = allArgs.FilterByPredicate( []( const FString& arg )
+			{
+				return !arg.Contains( TEXT( "=" ) );
+			} );
+
+			if ( args.Num() > 0 )
+			{
+				config.NumResults = FMath::Max( FCString::Atoi( *args[ 0 ] ), 1 );
+			}
+
+			if ( args.Num() > 1 )
+			{
+				config.Iterations = FMath::Max( FCString::Atoi( *args[ 1 ] ), 1 );
+			}
+
+			const FString path = args.Num() > 2
+				? args[ 2 ]
+				: FPaths::ProfilingDir() / TEXT( "MultiplayerSessions" ) / FString::Printf( TEXT( "Benchmark-%s.json" ), *FDateTime::Now().ToString() );
+
+			const FString report = FMultiplayerSessionBenchmark::Run( config );
+			output.Log( report );
+
+			if ( FFileHelper::SaveStringToFile( report, *path ) )
+			{
+				output.Logf( TEXT( "MultiplayerSessions benchmark saved to %s" ), *path );
+			}
+		} ) );
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 벤치마크를 실행하고 결과를 JSON 으로 반환한다.
+////////////////////////////////////////////////////////////////////////////
+FString FMultiplayerSessionBenchmark::Run( const FMultiplayerSessionBenchmarkConfig& config )
+{
+	FMultiplayerLatencyHistogram generateTime;
+	FMultiplayerLatencyHistogram indexTime;
+	FMultiplayerLatencyHistogram lookupTime;
+	FMultiplayerLatencyHistogram rankTime;
+
+	TArray< FString > matchTypeStrings;
+	TArray< FName > matchTypes;
+	for ( int32 index = 0; index < FMath::Max( config.NumMatchTypes, 1 ); ++index )
+	{
+		// 광고 스키마로 오가는 이름 ( FreeForAll, ..., MatchType_<값> )
+		matchTypes.Add( FMultiplayerSessionAdvertisement::GetMatchTypeName( static_cast< EMultiplayerMatchType >( index + 1 ) ) );
+		matchTypeStrings.Add( matchTypes.Last().ToString() );
+	}
+
+	// 서브시스템 작업은 하나의 MatchType 으로 광고 / 검색 / 참가한다.
+	const FString operationsJson = config.NumOperations > 0
+		? MultiplayerSessionBenchmark::RunOperations( config, matchTypeStrings[ 0 ] )
+		: FString();
+
+	TArray< FOnlineSessionSearchResult > searchResults;
+
+	double startTime = FPlatformTime::Seconds();
+	MakeSyntheticResults( config.NumResults, matchTypeStrings, config.Seed, searchResults );
+	generateTime.Record( FPlatformTime::Seconds() - startTime );
+
+	const SIZE_T resultBytes = GetAllocatedSize( searchResults );
+
+	FMultiplayerSessionIndex searchIndex;
+	FMultiplayerPingScorer scorer;
+	TArray< int32 > candidateIndices;
+	TArray< FMultiplayerSessionCandidate > candidates;
+	FRandomStream random( config.Seed );
+
+	// 최적화로 조회가 제거되지 않도록 결과를 모아 둔다.
+	int64 checksum = 0;
+
+	for ( int32 iteration = 0; iteration < config.Iterations; ++iteration )
+	{
+		startTime = FPlatformTime::Seconds();
+		searchIndex.Build( searchResults );
+		indexTime.Record( FPlatformTime::Seconds() - startTime );
+
+		startTime = FPlatformTime::Seconds();
+		for ( int32 lookup = 0; lookup < config.LookupsPerIteration; ++lookup )
+		{
+			const FName matchType = matchTypes[ random.RandHelper( matchTypes.Num() ) ];
+			checksum += searchIndex.FindCandidate( matchType, 1 + random.RandHelper( 4 ) );
+		}
+		lookupTime.Record( FPlatformTime::Seconds() - startTime );
+
+		startTime = FPlatformTime::Seconds();
+		searchIndex.GatherCandidates( matchTypes[ iteration % matchTypes.Num() ], 1, candidateIndices );
+		FMultiplayerSessionRanker::SelectTopCandidates( searchResults, candidateIndices, scorer, 8, candidates );
+		rankTime.Record( FPlatformTime::Seconds() - startTime );
+
+		checksum += candidates.Num() > 0 ? candidates[ 0 ].ResultIndex : 0;
+	}
+
+	FString json( TEXT( "{\n" ) );
+	json += FString::Printf( TEXT( "\t\"numResults\": %d,\n" ), config.NumResults );
+	json += FString::Printf( TEXT( "\t\"iterations\": %d,\n" ), config.Iterations );
+	json += FString::Printf( TEXT( "\t\"lookupsPerIteration\": %d,\n" ), config.LookupsPerIteration );
+	json += FString::Printf( TEXT( "\t\"numMatchTypes\": %d,\n" ), config.NumMatchTypes );
+	json += FString::Printf( TEXT( "\t\"seed\": %d,\n" ), config.Seed );
+	json += FString::Printf( TEXT( "\t\"resultBytes\": %llu,\n" ), static_cast< uint64 >( resultBytes ) );
+	json += FString::Printf( TEXT( "\t\"bytesPerResult\": %.1f,\n" ), config.NumResults > 0 ? static_cast< double >( resultBytes ) / config.NumResults : 0.0 );
+	json += FString::Printf( TEXT( "\t\"checksum\": %lld,\n" ), checksum );
+	json += operationsJson;
+	json += TEXT( "\t\"stages\": {\n" );
+	json += MultiplayerSessionBenchmark::MakeStageJson( TEXT( "generate" ),		 generateTime, false );
+	json += MultiplayerSessionBenchmark::MakeStageJson( TEXT( "indexBuild" ),	 indexTime,	   false );
+	json += MultiplayerSessionBenchmark::MakeStageJson( TEXT( "findCandidate" ), lookupTime,   false );
+	json += MultiplayerSessionBenchmark::MakeStageJson( TEXT( "rankTop8" ),		 rankTime,	   true	 );
+	json += TEXT( "\t}\n" );
+	json += TEXT( "}\n" );
+
+	return json;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 합성 검색 결과를 만든다. MatchType 은 matchTypes 중에서 고르고, 지역은 numRegions 개에 고르게 나눈다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionBenchmark::MakeSyntheticResults( int32 numResults, const TArray< FString >& matchTypes, int32 seed, TArray< FOnlineSessionSearchResult >& outResults, int32 numRegions )
+{
+	FRandomStream random( seed );
+
+	// 이름은 한 번만 값으로 바꾼다.
+	TArray< EMultiplayerMatchType > matchTypeValues;
+	matchTypeValues.Reserve( matchTypes.Num() );
+	for ( const FString& matchType : matchTypes )
+	{
+		matchTypeValues.Add( FMultiplayerSessionAdvertisement::ParseMatchType( FName( *matchType ) ) );
+	}
+
+	outResults.Reset( numResults );
+
+	for ( int32 index = 0; index < numResults; ++index )
+	{
+		FOnlineSessionSearchResult& searchResult = outResults.AddDefaulted_GetRef();
+
+		const int32 numPublicConnections = 2 + random.RandHelper( 15 );
+
+		FOnlineSessionSettings& sessionSettings = searchResult.Session.SessionSettings;
+		sessionSettings.NumPublicConnections = numPublicConnections;
+		sessionSettings.bShouldAdvertise	 = true;
+		sessionSettings.bUsesPresence		 = true;
+		sessionSettings.BuildUniqueId		 = 1;
+
+		// 같은 시드면 이전과 같은 결과가 나오도록 난수를 뽑는 순서는 유지한다.
+		const int32 matchTypeIndex = matchTypeValues.Num() > 0 ? random.RandHelper( matchTypeValues.Num() ) : INDEX_NONE;
+		const EMultiplayerMatchType matchType = INDEX_NONE != matchTypeIndex ? matchTypeValues[ matchTypeIndex ] : EMultiplayerMatchType::None;
+
+		// 일부는 가득 찬 세션, 일부는 핑을 모르는 세션으로 만든다.
+		searchResult.Session.NumOpenPublicConnections = random.RandHelper( numPublicConnections + 1 );
+		searchResult.PingInMs = random.FRand() < 0.1f ? MAX_QUERY_PING : 5 + random.RandHelper( 300 );
+
+		if ( EMultiplayerMatchType::None != matchType )
+		{
+			FMultiplayerSessionAdvertisement advertisement;
+			advertisement.MatchType = matchType;
+			advertisement.Region	= static_cast< uint8 >( index % FMath::Clamp( numRegions, 1, MAX_uint8 + 1 ) );
+			advertisement.BuildId	= static_cast< uint16 >( sessionSettings.BuildUniqueId );
+			advertisement.OpenSlots = static_cast< uint8 >( searchResult.Session.NumOpenPublicConnections );
+			advertisement.Write( sessionSettings );
+		}
+		else if ( INDEX_NONE != matchTypeIndex && !matchTypes[ matchTypeIndex ].IsEmpty() )
+		{
+			// 값이 없는 사용자 정의 이름은 호스트처럼 MatchType 문자열로 광고한다.
+			sessionSettings.Set( FMultiplayerSessionIndex::MatchTypeKey, matchTypes[ matchTypeIndex ], EOnlineDataAdvertisementType::ViaOnlineServiceAndPing );
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 검색 결과가 차지하는 대략적인 힙 메모리 ( byte )
+////////////////////////////////////////////////////////////////////////////
+SIZE_T FMultiplayerSessionBenchmark::GetAllocatedSize( const TArray< FOnlineSessionSearchResult >& searchResults )
+{
+	SIZE_T allocatedSize = searchResults.GetAllocatedSize();
+
+	for ( const FOnlineSessionSearchResult& searchResult : searchResults )
+	{
+		const FSessionSettings& settings = searchResult.Session.SessionSettings.Settings;
+		allocatedSize += settings.GetAllocatedSize();
+
+		for ( const TPair< FName, FOnlineSessionSetting >& setting : settings )
+		{
+			if ( EOnlineKeyValuePairDataType::String == setting.Value.Data.GetType() )
+			{
+				FString value;
+				setting.Value.Data.GetValue( value );
+				allocatedSize += value.GetAllocatedSize();
+			}
+		}
+	}
+
+	return allocatedSize;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 게임 인스턴스 / 로컬 플레이어 없이 가짜 백엔드를 쓰는 서브시스템을 만든다. ( QoS 측정과 검색 캐시는 끈다 )
+////////////////////////////////////////////////////////////////////////////
+TStrongObjectPtr< UMultiPlayerSessionsSubsystem > FMultiplayerSessionBenchmark::MakeHeadlessSubsystem( const TSharedRef< FMultiplayerFakeSessionBackend >& backend )
+{
+	// 서브시스템 컬렉션 없이 만들므로 Initialize 는 호출되지 않는다. ( 설정 파일과 온라인 서브시스템을 읽지 않는다 )
+	UGameInstance* gameInstance = NewObject< UGameInstance >( GetTransientPackage() );
+	TStrongObjectPtr< UMultiPlayerSessionsSubsystem > subsystem( NewObject< UMultiPlayerSessionsSubsystem >( gameInstance ) );
+
+	subsystem->SetSessionBackend( backend );
+	subsystem->SetSearchCacheTime( 0.f, 0.f );
+
+	// 가짜 호스트에는 에코 응답이 없으므로 측정하면 제한 시간만큼 참가가 늦어진다.
+	FMultiplayerQosConfig qosConfig;
+	qosConfig.bEnabled			= false;
+	qosConfig.bRunEchoResponder = false;
+	subsystem->SetQosConfig( qosConfig );
+
+	return subsystem;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 서브시스템의 작업이 모두 끝날 때까지 가짜 백엔드 이벤트를 처리한다. timeout 안에 끝나지 않으면 false
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerSessionBenchmark::WaitUntilIdle( UMultiPlayerSessionsSubsystem& subsystem, FMultiplayerFakeSessionBackend& backend, bool bRealTime, double timeout )
+{
+	const double deadline = FPlatformTime::Seconds() + timeout;
+
+	while ( subsystem.IsBusy() )
+	{
+		if ( FPlatformTime::Seconds() > deadline )
+			return false;
+
+		if ( bRealTime )
+		{
+			FPlatformProcess::SleepNoStats( 0.f );
+			backend.Pump( FPlatformTime::Seconds() );
+		}
+		else
+		{
+			backend.Flush();
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,201 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionIndex.h"
+#include "MultiplayerSessionAdvertisement.h"
+#include "OnlineSessionSettings.h"
+
+
+const FName FMultiplayerSessionIndex::MatchTypeKey( TEXT( "MatchType" ) );
+const FName FMultiplayerSessionIndex::HostSessionKey( TEXT( "HostSession" ) );
+const FName FMultiplayerSessionIndex::QosPortKey( TEXT( "QosPort" ) );
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 검색 결과로 인덱스를 빌드한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionIndex::Build( const TArray< FOnlineSessionSearchResult >& searchResults )
+{
+	Reset();
+
+	// 결과마다 새 문자열을 만들지 않도록 버퍼를 재사용한다.
+	FString scratch;
+
+	for ( int32 index = 0; index < searchResults.Num(); ++index )
+	{
+		Add( searchResults[ index ], index, scratch );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 검색 결과 하나를 인덱스에 추가한다. index 는 검색 결과 배열상의 위치
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionIndex::Add( const FOnlineSessionSearchResult& searchResult, int32 index, FString& scratch )
+{
+	m_NumResults = FMath::Max( m_NumResults, index + 1 );
+
+	const FName matchType = ReadMatchType( searchResult, scratch );
+	if ( matchType.IsNone() )
+		return;
+
+	const int32 openSlots = FMath::Clamp( searchResult.Session.NumOpenPublicConnections, 0, MaxSlotBucket );
+
+	FMatchTypeBucket& bucket = m_Buckets.FindOrAdd( matchType );
+	if ( bucket.BySlots.Num() <= openSlots )
+	{
+		bucket.BySlots.SetNum( openSlots + 1 );
+	}
+
+	bucket.BySlots[ openSlots ].Add( index );
+
+	if ( openSlots > 0 && ( INDEX_NONE == bucket.FirstJoinable || index < bucket.FirstJoinable ) )
+	{
+		bucket.FirstJoinable = index;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 인덱스를 비운다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionIndex::Reset()
+{
+	m_Buckets.Reset();
+	m_NumResults = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 조건에 맞는 참가 후보의 검색 결과 인덱스를 반환한다. 없으면 INDEX_NONE
+////////////////////////////////////////////////////////////////////////////
+int32 FMultiplayerSessionIndex::FindCandidate( FName matchType, int32 minOpenSlots ) const
+{
+	const FMatchTypeBucket* bucket = m_Buckets.Find( matchType );
+	if ( nullptr == bucket )
+		return INDEX_NONE;
+
+	// 일반적인 1 명 참가는 빌드 시 캐싱해둔 후보를 바로 반환한다.
+	if ( minOpenSlots <= 1 )
+		return bucket->FirstJoinable;
+
+	// 파티 참가처럼 여러 슬롯이 필요한 경우 슬롯 버킷만 훑는다. ( 최대 MaxSlotBucket 개 )
+	int32 candidate = INDEX_NONE;
+	for ( int32 slots = FMath::Min( minOpenSlots, MaxSlotBucket ); slots < bucket->BySlots.Num(); ++slots )
+	{
+		const TArray< int32 >& indices = bucket->BySlots[ slots ];
+		if ( indices.Num() > 0 && ( INDEX_NONE == candidate || indices[ 0 ] < candidate ) )
+		{
+			candidate = indices[ 0 ];
+		}
+	}
+
+	return candidate;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 빈 슬롯이 minOpenSlots 이상인 검색 결과 인덱스를 모두 모은다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionIndex::GatherCandidates( FName matchType, int32 minOpenSlots, TArray< int32 >& outIndices ) const
+{
+	outIndices.Reset();
+
+	const FMatchTypeBucket* bucket = m_Buckets.Find( matchType );
+	if ( nullptr == bucket )
+		return;
+
+	for ( int32 slots = FMath::Clamp( minOpenSlots, 1, MaxSlotBucket ); slots < bucket->BySlots.Num(); ++slots )
+	{
+		outIndices.Append( bucket->BySlots[ slots ] );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 빈 슬롯 수가 정확히 일치하는 검색 결과 인덱스 목록을 반환한다.
+////////////////////////////////////////////////////////////////////////////
+const TArray< int32 >* FMultiplayerSessionIndex::FindBySlots( FName matchType, int32 openSlots ) const
+{
+	const FMatchTypeBucket* bucket = m_Buckets.Find( matchType );
+	if ( nullptr == bucket || !bucket->BySlots.IsValidIndex( openSlots ) )
+		return nullptr;
+
+	return &bucket->BySlots[ openSlots ];
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 인덱싱된 검색 결과 수를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+int32 FMultiplayerSessionIndex::Num() const
+{
+	return m_NumResults;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// MatchType 을 FName 으로 읽는다. 묶은 광고에 매치 타입이 있으면 문자열 없이 읽고, 없으면 MatchType 문자열을 읽는다.
+////////////////////////////////////////////////////////////////////////////
+FName FMultiplayerSessionIndex::ReadMatchType( const FOnlineSessionSearchResult& searchResult, FString& scratch )
+{
+	FMultiplayerSessionAdvertisement advertisement;
+	if ( FMultiplayerSessionAdvertisement::Read( searchResult.Session.SessionSettings, advertisement )
+		&& EMultiplayerMatchType::None != advertisement.MatchType )
+		return FMultiplayerSessionAdvertisement::GetMatchTypeName( advertisement.MatchType );
+
+	// 이전 스키마로 광고한 호스트, 또는 값이 없는 사용자 정의 매치 타입
+	const FOnlineSessionSetting* setting = searchResult.Session.SessionSettings.Settings.Find( MatchTypeKey );
+	if ( nullptr == setting || EOnlineKeyValuePairDataType::String != setting->Data.GetType() )
+		return NAME_None;
+
+	setting->Data.GetValue( scratch );
+
+	return FName( *scratch );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 검색 결과에서 참가, 순위와 인덱싱에 쓰지 않는 세팅을 버린다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionIndex::Compact( FOnlineSessionSearchResult& searchResult, bool bKeepAdvertisement )
+{
+	FOnlineSessionSettings& settings = searchResult.Session.SessionSettings;
+
+	settings.MemberSettings.Empty();
+
+	if ( !bKeepAdvertisement )
+	{
+		settings.Settings.Empty();
+		return;
+	}
+
+	// 검색 필터 키는 다시 걸러도 같은 결과가 나오도록 남긴다. 묶은 광고로 매치 타입을 읽을 수 없는 세션만 MatchType 문자열을 남긴다.
+	static const FName RetainedKeys[] =
+	{
+		FMultiplayerSessionAdvertisement::Key,
+		FMultiplayerSessionAdvertisement::MatchTypeKey,
+		FMultiplayerSessionAdvertisement::RegionKey,
+		FMultiplayerSessionAdvertisement::BuildKey,
+		HostSessionKey,
+		QosPortKey,
+		SETTING_MAPNAME,
+		MatchTypeKey,
+	};
+
+	FMultiplayerSessionAdvertisement advertisement;
+	const bool bHasAdvertisement = FMultiplayerSessionAdvertisement::Read( settings, advertisement )
+		&& EMultiplayerMatchType::None != advertisement.MatchType;
+
+	FSessionSettings retained;
+	retained.Reserve( UE_ARRAY_COUNT( RetainedKeys ) );
+
+	for ( const FName& key : RetainedKeys )
+	{
+		if ( bHasAdvertisement && MatchTypeKey == key )
+			continue;
+
+		if ( const FOnlineSessionSetting* setting = settings.Settings.Find( key ) )
+		{
+			retained.Add( key, *setting );
+		}
+	}
+
+	// 이미 줄인 결과는 다시 할당하지 않는다.
+	if ( retained.Num() == settings.Settings.Num() )
+		return;
+
+	settings.Settings = MoveTemp( retained );
+}
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionOperation.h"
+#include "Engine/LocalPlayer.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 로컬 플레이어의 대상을 만든다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerSessionTarget FMultiplayerSessionTarget::ForLocalPlayer( const ULocalPlayer* localPlayer, FName sessionName )
+{
+	FMultiplayerSessionTarget target( sessionName );
+
+	if ( nullptr != localPlayer )
+	{
+		target.PlayerId = localPlayer->GetPreferredUniqueNetId().GetUniqueNetId();
+	}
+
+	return target;
+}
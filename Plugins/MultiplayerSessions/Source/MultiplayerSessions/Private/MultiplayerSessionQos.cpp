@@ -0,0 +1,503 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionQos.h"
+#include "MultiplayerSessions.h"
+#include "Common/UdpSocketBuilder.h"
+#include "Containers/Queue.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "Tasks/Task.h"
+
+
+const TCHAR* FMultiplayerQosConfig::ConfigSection = TEXT( "MultiplayerSessions.Qos" );
+
+
+namespace MultiplayerSessionQos
+{
+	/// 에코 패킷 식별자
+	static constexpr uint32 EchoMagic{ 0x4D505145 };	// MPQE
+
+	/// 에코 패킷 크기 ( 식별자 + 측정 번호 + 순번 )
+	static constexpr int32 EchoPacketSize{ sizeof( uint32 ) + sizeof( uint64 ) + sizeof( uint16 ) };
+
+	/// 수신 버퍼 크기
+	static constexpr int32 MaxPacketSize{ 64 };
+
+	/// 응답 스레드가 중단을 확인하는 간격 ( 초 )
+	static constexpr double StopPollInterval{ 0.05 };
+
+	/// 에코 패킷을 만든다.
+	static void WriteEcho( uint64 nonce, uint16 sequence, TArray< uint8 >& outPacket )
+	{
+		outPacket.Reset( EchoPacketSize );
+		FMemoryWriter writer( outPacket );
+
+		uint32 magic = EchoMagic;
+		writer << magic << nonce << sequence;
+	}
+
+	/// 에코 패킷을 읽는다. 식별자나 크기가 다르면 false
+	static bool ReadEcho( const uint8* data, int32 size, uint64& outNonce, uint16& outSequence )
+	{
+		if ( EchoPacketSize != size )
+			return false;
+
+		FMemoryReaderView reader( MakeArrayView( data, size ) );
+
+		uint32 magic = 0;
+		reader << magic << outNonce << outSequence;
+
+		return !reader.IsError() && EchoMagic == magic;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 워커 작업과 공유하는 측정 상태
+////////////////////////////////////////////////////////////////////////////
+struct FMultiplayerQosProbeState
+{
+	/// 측정 번호 ( 이전 측정의 늦은 응답을 거른다 )
+	uint64 Nonce{ 0 };
+
+	/// 후보당 에코 요청 수
+	int32 NumProbes{ 0 };
+
+	/// 에코 요청 하나의 제한 시간 ( 초 )
+	double ProbeTimeout{ 0.0 };
+
+	/// 끝난 측정 ( 워커 작업 → 게임 스레드 )
+	TQueue< FMultiplayerQosResult, EQueueMode::Mpsc > Results;
+
+	/// 끝난 측정 작업 수
+	std::atomic< int32 > NumTargetsDone{ 0 };
+
+	/// 취소 여부
+	std::atomic< bool > bCancelled{ false };
+};
+
+
+namespace MultiplayerSessionQos
+{
+	/// 왕복 시간 목록으로 중앙값과 지터를 채운다. ( 지터는 보낸 순서대로 이웃한 값의 차이 평균 )
+	static void Summarize( const TArray< double >& rttMs, FMultiplayerQosResult& outResult )
+	{
+		outResult.NumReceived = rttMs.Num();
+		if ( rttMs.Num() <= 0 )
+			return;
+
+		double jitter = 0.0;
+		for ( int32 index = 1; index < rttMs.Num(); ++index )
+		{
+			jitter += FMath::Abs( rttMs[ index ] - rttMs[ index - 1 ] );
+		}
+
+		outResult.JitterMs = rttMs.Num() > 1 ? static_cast< float >( jitter / ( rttMs.Num() - 1 ) ) : 0.f;
+
+		// 한 번 튄 값이 순위를 뒤집지 않도록 평균 대신 중앙값을 쓴다.
+		TArray< double > sorted = rttMs;
+		sorted.Sort();
+
+		const int32 middle = sorted.Num() / 2;
+		outResult.RttMs = static_cast< float >( 0 == sorted.Num() % 2 ? ( sorted[ middle - 1 ] + sorted[ middle ] ) * 0.5 : sorted[ middle ] );
+	}
+
+	/// 대상에 에코 요청을 차례로 보내고 왕복 시간을 잰다. ( 워커 작업 )
+	static void ProbeTarget( const TSharedRef< FMultiplayerQosProbeState, ESPMode::ThreadSafe >& state, const FMultiplayerQosTarget& target )
+	{
+		FMultiplayerQosResult result;
+		result.ResultIndex = target.ResultIndex;
+
+		ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get( PLATFORM_SOCKETSUBSYSTEM );
+
+		FSocket* socket = nullptr != socketSubsystem
+			? FUdpSocketBuilder( TEXT( "MultiplayerQosProbe" ) ).AsNonBlocking().Build()
+			: nullptr;
+
+		if ( nullptr != socket )
+		{
+			bool bIsValid = false;
+			TSharedRef< FInternetAddr > address = socketSubsystem->CreateInternetAddr();
+			address->SetIp( *target.Host, bIsValid );
+			address->SetPort( target.Port );
+
+			TSharedRef< FInternetAddr > fromAddress = socketSubsystem->CreateInternetAddr();
+			TArray< uint8 > packet;
+			TArray< double > rttMs;
+			uint8 buffer[ MaxPacketSize ];
+
+			// 요청을 겹쳐 보내면 앞선 응답의 지연이 다음 측정에 섞이므로 하나씩 보낸다.
+			for ( uint16 sequence = 0; bIsValid && sequence < state->NumProbes && !state->bCancelled; ++sequence )
+			{
+				WriteEcho( state->Nonce, sequence, packet );
+
+				int32 bytesSent = 0;
+				const double sendTime = FPlatformTime::Seconds();
+				if ( !socket->SendTo( packet.GetData(), packet.Num(), bytesSent, *address ) )
+					break;
+
+				++result.NumSent;
+
+				const double deadline = sendTime + state->ProbeTimeout;
+				bool bReceived = false;
+
+				while ( !bReceived && !state->bCancelled )
+				{
+					const double remaining = deadline - FPlatformTime::Seconds();
+					if ( remaining <= 0.0 || !socket->Wait( ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds( remaining ) ) )
+						break;
+
+					int32 bytesRead = 0;
+					while ( socket->RecvFrom( buffer, MaxPacketSize, bytesRead, *fromAddress ) && bytesRead > 0 )
+					{
+						// 제한 시간을 넘겨 도착한 이전 순번의 응답은 버린다.
+						uint64 nonce	= 0;
+						uint16 received = 0;
+						if ( !ReadEcho( buffer, bytesRead, nonce, received ) || state->Nonce != nonce || sequence != received )
+							continue;
+
+						rttMs.Add( ( FPlatformTime::Seconds() - sendTime ) * 1000.0 );
+						bReceived = true;
+						break;
+					}
+				}
+			}
+
+			Summarize( rttMs, result );
+
+			socketSubsystem->DestroySocket( socket );
+		}
+
+		// 결과를 넣은 후에 완료를 알린다. ( 게임 스레드는 완료 수를 먼저 읽고 결과를 꺼낸다 )
+		state->Results.Enqueue( result );
+		++state->NumTargetsDone;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 설정 파일과 명령줄에서 설정을 읽는다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerQosConfig FMultiplayerQosConfig::Load()
+{
+	FMultiplayerQosConfig config;
+
+	if ( GConfig )
+	{
+		GConfig->GetBool(	ConfigSection, TEXT( "bEnabled" ),			config.bEnabled,			GGameIni );
+		GConfig->GetBool(	ConfigSection, TEXT( "bRunEchoResponder" ),	config.bRunEchoResponder,	GGameIni );
+		GConfig->GetInt(	ConfigSection, TEXT( "MaxCandidates" ),		config.MaxCandidates,		GGameIni );
+		GConfig->GetInt(	ConfigSection, TEXT( "MaxInFlight" ),		config.MaxInFlight,			GGameIni );
+		GConfig->GetInt(	ConfigSection, TEXT( "NumProbes" ),			config.NumProbes,			GGameIni );
+		GConfig->GetFloat(	ConfigSection, TEXT( "ProbeTimeout" ),		config.ProbeTimeout,		GGameIni );
+		GConfig->GetInt(	ConfigSection, TEXT( "EchoPortOffset" ),	config.EchoPortOffset,		GGameIni );
+		GConfig->GetFloat(	ConfigSection, TEXT( "JitterWeight" ),		config.JitterWeight,		GGameIni );
+	}
+
+	// 한 장비에 여러 호스트를 띄울 때 인스턴스마다 바꾸는 값
+	FParse::Value( FCommandLine::Get(), TEXT( "QosEchoPort=" ), config.EchoPort );
+
+	config.MaxCandidates = FMath::Max( config.MaxCandidates, 1 );
+	config.MaxInFlight	 = FMath::Max( config.MaxInFlight, 1 );
+	config.NumProbes	 = FMath::Clamp( config.NumProbes, 1, static_cast< int32 >( MAX_uint16 ) );
+	config.ProbeTimeout	 = FMath::Max( config.ProbeTimeout, 0.01f );
+	config.JitterWeight	 = FMath::Max( config.JitterWeight, 0.f );
+
+	return config;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 접속 주소 ( 주소:포트 ) 로 대상을 만든다. 주소를 해석할 수 없으면 false
+/// 플랫폼 아이디처럼 IP 가 아닌 접속 주소는 측정하지 않는다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerQosTarget::Parse( int32 resultIndex, const FString& connectString, int32 portOffset, FMultiplayerQosTarget& outTarget )
+{
+	FString host;
+	FString port;
+	if ( !connectString.Split( TEXT( ":" ), &host, &port, ESearchCase::CaseSensitive, ESearchDir::FromEnd ) )
+		return false;
+
+	host.RemoveFromStart( TEXT( "[" ) );
+	host.RemoveFromEnd( TEXT( "]" ) );
+
+	const int32 echoPort = FCString::Atoi( *port ) + portOffset;
+	if ( host.IsEmpty() || echoPort <= 0 || echoPort > MAX_uint16 )
+		return false;
+
+	ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get( PLATFORM_SOCKETSUBSYSTEM );
+	if ( nullptr == socketSubsystem )
+		return false;
+
+	bool bIsValid = false;
+	socketSubsystem->CreateInternetAddr()->SetIp( *host, bIsValid );
+	if ( !bIsValid )
+		return false;
+
+	outTarget.ResultIndex = resultIndex;
+	outTarget.Host		  = MoveTemp( host );
+	outTarget.Port		  = echoPort;
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 생성자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerQosProber::FMultiplayerQosProber( const FMultiplayerQosConfig& config )
+	: m_Config( config )
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 소멸자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerQosProber::~FMultiplayerQosProber()
+{
+	// 워커 작업은 측정 상태를 함께 들고 있으므로 취소만 알리고 기다리지 않는다.
+	Cancel();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 측정을 시작한다. 이미 측정 중이거나 대상이 없으면 false
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerQosProber::Start( TArray< FMultiplayerQosTarget >&& targets, FMultiplayerOnQosComplete&& onComplete )
+{
+	if ( IsRunning() || targets.Num() <= 0 )
+		return false;
+
+	const FGuid nonce = FGuid::NewGuid();
+
+	m_State = MakeShared< FMultiplayerQosProbeState, ESPMode::ThreadSafe >();
+	m_State->Nonce		  = ( static_cast< uint64 >( nonce.A ) << 32 ) | nonce.B;
+	m_State->NumProbes	  = m_Config.NumProbes;
+	m_State->ProbeTimeout = m_Config.ProbeTimeout;
+
+	m_Targets	 = MoveTemp( targets );
+	m_NextTarget = 0;
+	m_OnComplete = MoveTemp( onComplete );
+
+	m_Results.Reset( m_Targets.Num() );
+
+	m_TickerHandle = FTSTicker::GetCoreTicker().AddTicker( FTickerDelegate::CreateRaw( this, &FMultiplayerQosProber::Tick ) );
+
+	LaunchProbes();
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 측정을 중단한다. 완료 대리자는 호출되지 않는다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerQosProber::Cancel()
+{
+	if ( m_TickerHandle.IsValid() )
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker( m_TickerHandle );
+		m_TickerHandle.Reset();
+	}
+
+	if ( m_State.IsValid() )
+	{
+		m_State->bCancelled = true;
+		m_State.Reset();
+	}
+
+	m_Targets.Reset();
+	m_NextTarget = 0;
+	m_Results.Reset();
+	m_OnComplete.Unbind();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 측정 중인지 여부
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerQosProber::IsRunning() const
+{
+	return m_State.IsValid();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 동시 측정 수 안에서 측정 작업을 시작한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerQosProber::LaunchProbes()
+{
+	if ( !m_State.IsValid() )
+		return;
+
+	const int32 numInFlight = m_NextTarget - m_State->NumTargetsDone;
+
+	for ( int32 numLaunched = numInFlight; numLaunched < m_Config.MaxInFlight && m_Targets.IsValidIndex( m_NextTarget ); ++numLaunched )
+	{
+		// 작업은 응답을 기다리는 동안 소켓에서 대기하므로 백그라운드 우선순위로 돌린다.
+		UE::Tasks::Launch( UE_SOURCE_LOCATION,
+			[ state = m_State.ToSharedRef(), target = m_Targets[ m_NextTarget ] ]()
+			{
+				MultiplayerSessionQos::ProbeTarget( state, target );
+			},
+			UE::Tasks::ETaskPriority::BackgroundNormal );
+
+		++m_NextTarget;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 코어 티커에서 결과를 모은다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerQosProber::Tick( float deltaTime )
+{
+	if ( !m_State.IsValid() )
+		return false;
+
+	// 완료 수를 먼저 읽어야 끝난 작업의 결과를 빠뜨리지 않는다.
+	const int32 numTargetsDone = m_State->NumTargetsDone;
+
+	FMultiplayerQosResult result;
+	while ( m_State->Results.Dequeue( result ) )
+	{
+		m_Results.Add( result );
+	}
+
+	LaunchProbes();
+
+	if ( m_Targets.IsValidIndex( m_NextTarget ) || numTargetsDone < m_NextTarget )
+		return true;
+
+	// 완료 대리자에서 바로 다음 측정을 요청할 수 있으므로 상태를 먼저 정리한다.
+	TArray< FMultiplayerQosResult > results	   = MoveTemp( m_Results );
+	FMultiplayerOnQosComplete		onComplete = MoveTemp( m_OnComplete );
+
+	m_TickerHandle.Reset();
+	m_State.Reset();
+	m_Targets.Reset();
+	m_NextTarget = 0;
+	m_Results.Reset();
+	m_OnComplete.Unbind();
+
+	onComplete.ExecuteIfBound( results );
+
+	// 완료 대리자에서 새 측정을 시작했으면 그 측정의 티커가 따로 등록되어 있다.
+	return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 소멸자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerQosEchoResponder::~FMultiplayerQosEchoResponder()
+{
+	Shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 포트를 열고 응답을 시작한다. 이미 응답 중이면 true
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerQosEchoResponder::Start( int32 port )
+{
+	if ( nullptr != m_Thread )
+		return true;
+
+	m_Socket = FUdpSocketBuilder( TEXT( "MultiplayerQosEcho" ) ).AsNonBlocking().BoundToPort( port ).Build();
+	if ( nullptr == m_Socket )
+	{
+		UE_LOG( LogMultiplayerSessions, Warning, TEXT( "Failed to open QoS echo port %d" ), port );
+		return false;
+	}
+
+	m_Port		= port;
+	m_bStopping = false;
+	m_Thread	= FRunnableThread::Create( this, TEXT( "MultiplayerQosEcho" ), 0, TPri_AboveNormal );
+
+	if ( nullptr == m_Thread )
+	{
+		Shutdown();
+		return false;
+	}
+
+	UE_LOG( LogMultiplayerSessions, Log, TEXT( "QoS echo listening on port %d" ), port );
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 응답을 멈추고 포트를 닫는다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerQosEchoResponder::Shutdown()
+{
+	if ( nullptr != m_Thread )
+	{
+		m_Thread->Kill( true );
+		delete m_Thread;
+		m_Thread = nullptr;
+	}
+
+	if ( nullptr != m_Socket )
+	{
+		if ( ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get( PLATFORM_SOCKETSUBSYSTEM ) )
+		{
+			socketSubsystem->DestroySocket( m_Socket );
+		}
+
+		m_Socket = nullptr;
+	}
+
+	m_Port = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 응답 포트를 반환한다. 응답 중이 아니면 0
+////////////////////////////////////////////////////////////////////////////
+int32 FMultiplayerQosEchoResponder::GetPort() const
+{
+	return m_Port;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 도착한 에코 요청을 보낸 쪽으로 그대로 돌려보낸다. ( 응답 스레드 )
+////////////////////////////////////////////////////////////////////////////
+uint32 FMultiplayerQosEchoResponder::Run()
+{
+	using namespace MultiplayerSessionQos;
+
+	ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get( PLATFORM_SOCKETSUBSYSTEM );
+	if ( nullptr == socketSubsystem || nullptr == m_Socket )
+		return 1;
+
+	TSharedRef< FInternetAddr > fromAddress = socketSubsystem->CreateInternetAddr();
+	uint8 buffer[ MaxPacketSize ];
+
+	while ( !m_bStopping )
+	{
+		if ( !m_Socket->Wait( ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds( StopPollInterval ) ) )
+			continue;
+
+		int32 bytesRead = 0;
+		while ( m_Socket->RecvFrom( buffer, MaxPacketSize, bytesRead, *fromAddress ) && bytesRead > 0 )
+		{
+			// 응답 크기를 요청 크기로 고정해 반사 증폭에 쓰이지 않도록 한다.
+			uint64 nonce	= 0;
+			uint16 sequence = 0;
+			if ( !ReadEcho( buffer, bytesRead, nonce, sequence ) )
+				continue;
+
+			int32 bytesSent = 0;
+			m_Socket->SendTo( buffer, bytesRead, bytesSent, *fromAddress );
+		}
+	}
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 응답 스레드에 중단을 요청한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerQosEchoResponder::Stop()
+{
+	m_bStopping = true;
+}
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionRanker.h"
+#include "OnlineSessionSettings.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 후보 점수를 계산한다. ( 낮을수록 좋은 후보 ) 참가 대상이 아니면 false 를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerPingScorer::Score( const FOnlineSessionSearchResult& searchResult, float& outScore ) const
+{
+	const int32 openSlots = searchResult.Session.NumOpenPublicConnections;
+	if ( openSlots <= 0 )
+		return false;
+
+	// 백엔드가 핑을 채우지 못한 경우 MAX_QUERY_PING 이 들어온다.
+	const bool bUnknownPing = searchResult.PingInMs <= 0 || searchResult.PingInMs >= MAX_QUERY_PING;
+	const int32 pingMs = bUnknownPing ? UnknownPingMs : searchResult.PingInMs;
+
+	if ( MaxPingMs > 0 && !bUnknownPing && pingMs > MaxPingMs )
+		return false;
+
+	outScore = static_cast< float >( pingMs ) - OpenSlotBonusMs * FMath::Min( openSlots, MaxOpenSlotBonus );
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 후보 인덱스 중 점수가 낮은 순으로 최대 maxCandidates 개를 선택한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionRanker::SelectTopCandidates(
+	const TArray< FOnlineSessionSearchResult >& searchResults,
+	const TArray< int32 >& candidateIndices,
+	const IMultiplayerSessionScorer& scorer,
+	int32 maxCandidates,
+	TArray< FMultiplayerSessionCandidate >& outCandidates )
+{
+	outCandidates.Reset();
+
+	if ( maxCandidates <= 0 )
+		return;
+
+	// 힙의 top 이 가장 나쁜 후보가 되도록 유지한다.
+	auto worstFirst = []( const FMultiplayerSessionCandidate& lhs, const FMultiplayerSessionCandidate& rhs )
+	{
+		return lhs.Score > rhs.Score;
+	};
+
+	outCandidates.Reserve( maxCandidates );
+
+	for ( const int32 index : candidateIndices )
+	{
+		if ( !searchResults.IsValidIndex( index ) )
+			continue;
+
+		float score = 0.f;
+		if ( !scorer.Score( searchResults[ index ], score ) )
+			continue;
+
+		if ( outCandidates.Num() < maxCandidates )
+		{
+			outCandidates.HeapPush( FMultiplayerSessionCandidate{ index, score }, worstFirst );
+		}
+		else if ( score < outCandidates.HeapTop().Score )
+		{
+			outCandidates.HeapPopDiscard( worstFirst, false );
+			outCandidates.HeapPush( FMultiplayerSessionCandidate{ index, score }, worstFirst );
+		}
+	}
+
+	// 남은 k 개만 정렬한다. 점수가 같으면 검색 순서를 유지한다.
+	outCandidates.Sort( []( const FMultiplayerSessionCandidate& lhs, const FMultiplayerSessionCandidate& rhs )
+	{
+		return lhs.Score != rhs.Score ? lhs.Score < rhs.Score : lhs.ResultIndex < rhs.ResultIndex;
+	} );
+}
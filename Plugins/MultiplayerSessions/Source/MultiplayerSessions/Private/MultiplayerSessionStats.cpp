@@ -0,0 +1,345 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Stats/Stats.h"
+
+
+DECLARE_STATS_GROUP( TEXT( "MultiplayerSessions" ), STATGROUP_MultiplayerSessions, STATCAT_Advanced );
+
+DECLARE_FLOAT_ACCUMULATOR_STAT( TEXT( "Create Latency (ms)" ),	STAT_MultiplayerSessions_CreateMs,	STATGROUP_MultiplayerSessions );
+DECLARE_FLOAT_ACCUMULATOR_STAT( TEXT( "Find Latency (ms)" ),	STAT_MultiplayerSessions_FindMs,	STATGROUP_MultiplayerSessions );
+DECLARE_FLOAT_ACCUMULATOR_STAT( TEXT( "Join Latency (ms)" ),	STAT_MultiplayerSessions_JoinMs,	STATGROUP_MultiplayerSessions );
+DECLARE_FLOAT_ACCUMULATOR_STAT( TEXT( "Destroy Latency (ms)" ),	STAT_MultiplayerSessions_DestroyMs,	STATGROUP_MultiplayerSessions );
+DECLARE_FLOAT_ACCUMULATOR_STAT( TEXT( "Start Latency (ms)" ),	STAT_MultiplayerSessions_StartMs,	STATGROUP_MultiplayerSessions );
+DECLARE_FLOAT_ACCUMULATOR_STAT( TEXT( "Update Latency (ms)" ),	STAT_MultiplayerSessions_UpdateMs,	STATGROUP_MultiplayerSessions );
+DECLARE_DWORD_ACCUMULATOR_STAT( TEXT( "Completed Requests" ),	STAT_MultiplayerSessions_Requests,	STATGROUP_MultiplayerSessions );
+
+
+namespace MultiplayerSessionStats
+{
+	/// 작업 인덱스 ( None 제외 ), 범위 밖이면 INDEX_NONE
+	static int32 GetOpIndex( EMultiplayerSessionOp op )
+	{
+		const int32 index = static_cast< int32 >( op ) - 1;
+		return ( index >= 0 && index < FMultiplayerSessionStats::NumOps ) ? index : INDEX_NONE;
+	}
+
+	/// 버킷 중앙값 ( ms )
+	static double GetBucketMidMs( int32 bucketIndex )
+	{
+		const uint64 lower = FMultiplayerLatencyHistogram::GetBucketLowerBound( bucketIndex );
+		const uint64 upper = FMultiplayerLatencyHistogram::GetBucketLowerBound( bucketIndex + 1 );
+		return ( lower + upper ) * 0.5 / 1000.0;
+	}
+
+	/// 마지막 지연 시간을 stat 그룹에 반영한다.
+	static void SetLatencyStat( EMultiplayerSessionOp op, double ms )
+	{
+		switch ( op )
+		{
+		case EMultiplayerSessionOp::Create:		SET_FLOAT_STAT( STAT_MultiplayerSessions_CreateMs, ms );	break;
+		case EMultiplayerSessionOp::Find:		SET_FLOAT_STAT( STAT_MultiplayerSessions_FindMs, ms );		break;
+		case EMultiplayerSessionOp::Join:		SET_FLOAT_STAT( STAT_MultiplayerSessions_JoinMs, ms );		break;
+		case EMultiplayerSessionOp::Destroy:	SET_FLOAT_STAT( STAT_MultiplayerSessions_DestroyMs, ms );	break;
+		case EMultiplayerSessionOp::Start:		SET_FLOAT_STAT( STAT_MultiplayerSessions_StartMs, ms );		break;
+		case EMultiplayerSessionOp::Update:		SET_FLOAT_STAT( STAT_MultiplayerSessions_UpdateMs, ms );	break;
+		default:																							break;
+		}
+
+		INC_DWORD_STAT( STAT_MultiplayerSessions_Requests );
+	}
+
+	static FAutoConsoleCommandWithOutputDevice DumpCommand(
+		TEXT( "MultiplayerSessions.Latency.Dump" ),
+		TEXT( "세션 작업별 지연 시간 ( p50 / p95 / p99 ) 을 출력합니다." ),
+		FConsoleCommandWithOutputDeviceDelegate::CreateLambda( []( FOutputDevice& output )
+		{
+			FMultiplayerSessionStats::Get().Dump( output );
+		} ) );
+
+	static FAutoConsoleCommand ResetCommand(
+		TEXT( "MultiplayerSessions.Latency.Reset" ),
+		TEXT( "세션 작업별 지연 시간 기록을 지웁니다." ),
+		FConsoleCommandDelegate::CreateLambda( []()
+		{
+			FMultiplayerSessionStats::Get().Reset();
+		} ) );
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice ExportCommand(
+		TEXT( "MultiplayerSessions.Latency.Export" ),
+		TEXT( "세션 작업별 지연 시간을 파일로 저장합니다. 사용법 : MultiplayerSessions.Latency.Export [csv|json] [path]" ),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda( []( const TArray< FString >& args, UWorld*, FOutputDevice& output )
+		{
+			const bool bJson = args.Num() > 0 && args[ 0 ].Equals( TEXT( "json" ), ESearchCase::IgnoreCase );
+			const FString path = args.Num() > 1 ? args[ 1 ] : FString();
+
+			FString savedPath;
+			if ( FMultiplayerSessionStats::Get().SaveToFile( bJson, path, &savedPath ) )
+			{
+				output.Logf( TEXT( "MultiplayerSessions latency saved to %s" ), *savedPath );
+			}
+			else
+			{
+				output.Logf( TEXT( "Failed to save MultiplayerSessions latency to %s" ), *savedPath );
+			}
+		} ) );
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 생성자
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerLatencyHistogram::FMultiplayerLatencyHistogram()
+{
+	for ( std::atomic< uint32 >& bucket : m_Buckets )
+	{
+		bucket.store( 0, std::memory_order_relaxed );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 지연 시간을 기록한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerLatencyHistogram::Record( double seconds )
+{
+	const uint32 valueUs = static_cast< uint32 >( FMath::Clamp( seconds * 1000000.0, 0.0, static_cast< double >( MAX_uint32 ) ) );
+
+	m_Buckets[ GetBucketIndex( valueUs ) ].fetch_add( 1, std::memory_order_relaxed );
+	m_Count.fetch_add( 1, std::memory_order_relaxed );
+	m_SumUs.fetch_add( valueUs, std::memory_order_relaxed );
+
+	uint32 maxUs = m_MaxUs.load( std::memory_order_relaxed );
+	while ( valueUs > maxUs && !m_MaxUs.compare_exchange_weak( maxUs, valueUs, std::memory_order_relaxed ) )
+	{
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 기록을 모두 지운다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerLatencyHistogram::Reset()
+{
+	for ( std::atomic< uint32 >& bucket : m_Buckets )
+	{
+		bucket.store( 0, std::memory_order_relaxed );
+	}
+
+	m_Count.store( 0, std::memory_order_relaxed );
+	m_SumUs.store( 0, std::memory_order_relaxed );
+	m_MaxUs.store( 0, std::memory_order_relaxed );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 현재 기록을 요약한다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerLatencySnapshot FMultiplayerLatencyHistogram::MakeSnapshot() const
+{
+	// 기록 중에도 읽을 수 있도록 버킷을 먼저 복사하고, 복사본 기준으로 백분위를 계산한다.
+	uint32 buckets[ NumBuckets ];
+	uint64 count = 0;
+
+	for ( int32 index = 0; index < NumBuckets; ++index )
+	{
+		buckets[ index ] = m_Buckets[ index ].load( std::memory_order_relaxed );
+		count += buckets[ index ];
+	}
+
+	FMultiplayerLatencySnapshot snapshot;
+	if ( 0 == count )
+		return snapshot;
+
+	snapshot.Count	= count;
+	snapshot.MeanMs = m_SumUs.load( std::memory_order_relaxed ) / 1000.0 / FMath::Max< uint64 >( m_Count.load( std::memory_order_relaxed ), 1 );
+	snapshot.MaxMs	= m_MaxUs.load( std::memory_order_relaxed ) / 1000.0;
+
+	constexpr int32 numPercentiles = 3;
+	const double percentiles[ numPercentiles ] = { 0.50, 0.95, 0.99 };
+	double* results[ numPercentiles ] = { &snapshot.P50Ms, &snapshot.P95Ms, &snapshot.P99Ms };
+
+	uint64 cumulative = 0;
+	int32 percentileIndex = 0;
+
+	for ( int32 index = 0; index < NumBuckets && percentileIndex < numPercentiles; ++index )
+	{
+		cumulative += buckets[ index ];
+
+		while ( percentileIndex < numPercentiles
+			&& cumulative >= static_cast< uint64 >( FMath::CeilToInt64( percentiles[ percentileIndex ] * count ) ) )
+		{
+			// 버킷 중앙값이 최대값보다 크게 나오지 않도록 한다.
+			*results[ percentileIndex ] = FMath::Min( MultiplayerSessionStats::GetBucketMidMs( index ), snapshot.MaxMs );
+			++percentileIndex;
+		}
+	}
+
+	return snapshot;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 값이 들어갈 버킷 인덱스를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+int32 FMultiplayerLatencyHistogram::GetBucketIndex( uint32 valueUs )
+{
+	if ( valueUs < NumSubBuckets )
+		return static_cast< int32 >( valueUs );
+
+	// 최상위 비트 아래 SubBucketBits 비트로 구간 안의 버킷을 고른다.
+	const int32 shift = static_cast< int32 >( FMath::FloorLog2( valueUs ) ) - SubBucketBits;
+	return ( shift + 1 ) * NumSubBuckets + static_cast< int32 >( ( valueUs >> shift ) & ( NumSubBuckets - 1 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 버킷의 하한 ( us, 포함 ) 을 반환한다.
+////////////////////////////////////////////////////////////////////////////
+uint64 FMultiplayerLatencyHistogram::GetBucketLowerBound( int32 bucketIndex )
+{
+	if ( bucketIndex < NumSubBuckets )
+		return static_cast< uint64 >( bucketIndex );
+
+	const int32 shift = bucketIndex / NumSubBuckets - 1;
+	const int32 subBucket = bucketIndex % NumSubBuckets;
+	return static_cast< uint64 >( NumSubBuckets + subBucket ) << shift;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 프로세스 전역 통계를 반환한다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerSessionStats& FMultiplayerSessionStats::Get()
+{
+	static FMultiplayerSessionStats stats;
+	return stats;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 작업의 지연 시간을 기록한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionStats::Record( EMultiplayerSessionOp op, double seconds )
+{
+	const int32 index = MultiplayerSessionStats::GetOpIndex( op );
+	if ( INDEX_NONE == index )
+		return;
+
+	m_Histograms[ index ].Record( seconds );
+
+	MultiplayerSessionStats::SetLatencyStat( op, seconds * 1000.0 );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 기록을 모두 지운다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionStats::Reset()
+{
+	for ( FMultiplayerLatencyHistogram& histogram : m_Histograms )
+	{
+		histogram.Reset();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 작업의 지연 시간 요약을 반환한다.
+////////////////////////////////////////////////////////////////////////////
+FMultiplayerLatencySnapshot FMultiplayerSessionStats::MakeSnapshot( EMultiplayerSessionOp op ) const
+{
+	const int32 index = MultiplayerSessionStats::GetOpIndex( op );
+	if ( INDEX_NONE == index )
+		return FMultiplayerLatencySnapshot();
+
+	return m_Histograms[ index ].MakeSnapshot();
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 요약을 로그에 출력한다.
+////////////////////////////////////////////////////////////////////////////
+void FMultiplayerSessionStats::Dump( FOutputDevice& output ) const
+{
+	output.Logf( TEXT( "%-8s %8s %10s %10s %10s %10s %10s" ), TEXT( "Op" ), TEXT( "Count" ), TEXT( "Mean" ), TEXT( "P50" ), TEXT( "P95" ), TEXT( "P99" ), TEXT( "Max" ) );
+
+	for ( int32 index = 0; index < NumOps; ++index )
+	{
+		const EMultiplayerSessionOp op = static_cast< EMultiplayerSessionOp >( index + 1 );
+		const FMultiplayerLatencySnapshot snapshot = MakeSnapshot( op );
+
+		output.Logf( TEXT( "%-8s %8llu %8.2fms %8.2fms %8.2fms %8.2fms %8.2fms" ),
+			GetOpName( op ), snapshot.Count, snapshot.MeanMs, snapshot.P50Ms, snapshot.P95Ms, snapshot.P99Ms, snapshot.MaxMs );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 요약을 CSV 로 만든다.
+////////////////////////////////////////////////////////////////////////////
+FString FMultiplayerSessionStats::ExportCsv() const
+{
+	FString csv( TEXT( "Op,Count,MeanMs,P50Ms,P95Ms,P99Ms,MaxMs\n" ) );
+
+	for ( int32 index = 0; index < NumOps; ++index )
+	{
+		const EMultiplayerSessionOp op = static_cast< EMultiplayerSessionOp >( index + 1 );
+		const FMultiplayerLatencySnapshot snapshot = MakeSnapshot( op );
+
+		csv += FString::Printf( TEXT( "%s,%llu,%.3f,%.3f,%.3f,%.3f,%.3f\n" ),
+			GetOpName( op ), snapshot.Count, snapshot.MeanMs, snapshot.P50Ms, snapshot.P95Ms, snapshot.P99Ms, snapshot.MaxMs );
+	}
+
+	return csv;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 요약을 JSON 으로 만든다.
+////////////////////////////////////////////////////////////////////////////
+FString FMultiplayerSessionStats::ExportJson() const
+{
+	FString json( TEXT( "{\n" ) );
+
+	for ( int32 index = 0; index < NumOps; ++index )
+	{
+		const EMultiplayerSessionOp op = static_cast< EMultiplayerSessionOp >( index + 1 );
+		const FMultiplayerLatencySnapshot snapshot = MakeSnapshot( op );
+
+		json += FString::Printf( TEXT( "\t\"%s\": { \"count\": %llu, \"meanMs\": %.3f, \"p50Ms\": %.3f, \"p95Ms\": %.3f, \"p99Ms\": %.3f, \"maxMs\": %.3f }%s\n" ),
+			GetOpName( op ), snapshot.Count, snapshot.MeanMs, snapshot.P50Ms, snapshot.P95Ms, snapshot.P99Ms, snapshot.MaxMs,
+			index + 1 < NumOps ? TEXT( "," ) : TEXT( "" ) );
+	}
+
+	json += TEXT( "}\n" );
+
+	return json;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 요약을 파일로 저장한다. path 가 비어 있으면 Saved/Profiling/MultiplayerSessions 아래에 저장한다.
+////////////////////////////////////////////////////////////////////////////
+bool FMultiplayerSessionStats::SaveToFile( bool bJson, const FString& path, FString* outPath ) const
+{
+	const FString filePath = path.IsEmpty()
+		? FPaths::ProfilingDir() / TEXT( "MultiplayerSessions" ) / FString::Printf( TEXT( "Latency-%s.%s" ), *FDateTime::Now().ToString(), bJson ? TEXT( "json" ) : TEXT( "csv" ) )
+		: path;
+
+	if ( outPath )
+	{
+		*outPath = filePath;
+	}
+
+	return FFileHelper::SaveStringToFile( bJson ? ExportJson() : ExportCsv(), *filePath );
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// 작업 이름을 반환한다.
+////////////////////////////////////////////////////////////////////////////
+const TCHAR* FMultiplayerSessionStats::GetOpName( EMultiplayerSessionOp op )
+{
+	switch ( op )
+	{
+	case EMultiplayerSessionOp::Create:		return TEXT( "Create" );
+	case EMultiplayerSessionOp::Find:		return TEXT( "Find" );
+	case EMultiplayerSessionOp::Join:		return TEXT( "Join" );
+	case EMultiplayerSessionOp::Destroy:	return TEXT( "Destroy" );
+	case EMultiplayerSessionOp::Start:		return TEXT( "Start" );
+	case EMultiplayerSessionOp::Update:		return TEXT( "Update" );
+	default:								return TEXT( "None" );
+	}
+}
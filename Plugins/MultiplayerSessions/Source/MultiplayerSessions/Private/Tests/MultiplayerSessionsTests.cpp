@@ -0,0 +1,472 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiPlayerSessionsSubsystem.h"
+#include "MultiplayerFakeSessionBackend.h"
+#include "MultiplayerLanSessionBackend.h"
+#include "MultiplayerSessionAdvertisement.h"
+#include "MultiplayerSessionBenchmark.h"
+#include "MultiplayerSessionIndex.h"
+#include "MultiplayerSessionQos.h"
+#include "MultiplayerSessionRanker.h"
+#include "MultiplayerSessionStats.h"
+#include "OnlineSessionSettings.h"
+#include "OnlineSubsystemTypes.h"
+#include "Misc/AutomationTest.h"
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+namespace MultiplayerSessionsTests
+{
+	/// 테스트 플래그
+	static constexpr EAutomationTestFlags::Type TestFlags = static_cast< EAutomationTestFlags::Type >( EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter );
+
+	/// 광고가 붙은 검색 결과를 추가한다.
+	static void AddResult( TArray< FOnlineSessionSearchResult >& results, EMultiplayerMatchType matchType, int32 openSlots, int32 pingMs )
+	{
+		FOnlineSessionSearchResult& searchResult = results.AddDefaulted_GetRef();
+		searchResult.PingInMs = pingMs;
+		searchResult.Session.NumOpenPublicConnections = openSlots;
+		searchResult.Session.SessionSettings.NumPublicConnections = 8;
+		searchResult.Session.SessionSettings.BuildUniqueId = 1;
+
+		FMultiplayerSessionAdvertisement advertisement;
+		advertisement.MatchType = matchType;
+		advertisement.BuildId	= 1;
+		advertisement.OpenSlots = static_cast< uint8 >( openSlots );
+		advertisement.Write( searchResult.Session.SessionSettings );
+	}
+
+	/// 가짜 백엔드를 쓰는 헤드리스 서브시스템을 만든다. ( 지연 없이 Flush 로 처리 )
+	static TStrongObjectPtr< UMultiPlayerSessionsSubsystem > MakeSubsystem( TSharedPtr< FMultiplayerFakeSessionBackend >& outBackend, int32 numSessions = 16 )
+	{
+		FMultiplayerFakeBackendConfig backendConfig;
+		backendConfig.NumSessions	  = numSessions;
+		backendConfig.LatencyMs		  = 0.f;
+		backendConfig.LatencyJitterMs = 0.f;
+
+		TSharedRef< FMultiplayerFakeSessionBackend > backend = MakeShared< FMultiplayerFakeSessionBackend >( backendConfig );
+		outBackend = backend;
+
+		return FMultiplayerSessionBenchmark::MakeHeadlessSubsystem( backend );
+	}
+
+	/// 테스트용 호스트 대상
+	static FMultiplayerSessionTarget MakeTarget( FName sessionName )
+	{
+		return FMultiplayerSessionTarget( sessionName, FUniqueNetIdString::Create( TEXT( "TestPlayer" ), FName( TEXT( "MultiplayerSessionsTests" ) ) ) );
+	}
+
+	/// 루프백 LAN 탐색 설정 ( 게임이 쓰는 비콘 포트 범위와 겹치지 않게 한다 )
+	static FMultiplayerLanDiscoveryConfig MakeLanConfig()
+	{
+		FMultiplayerLanDiscoveryConfig config;
+
+		// 같은 주소를 두 번 탐색해서 한 세션이 여러 번 응답하게 한다.
+		config.ProbeAddresses	   = { TEXT( "127.0.0.1" ), TEXT( "127.0.0.1" ) };
+		config.BasePort			   = 14900;
+		config.NumPorts			   = 4;
+		config.ShardSize		   = 2;
+		config.MaxConcurrentShards = 2;
+		config.ProbeTimeout		   = 0.2f;
+
+		return config;
+	}
+
+	/// 코어 티커에서 끝나는 작업을 기다리는 상태 ( 엔진이 틱하는 동안 잠복 명령으로 확인한다 )
+	struct FAsyncWaitState
+	{
+		/// 완료 여부
+		bool bComplete{ false };
+
+		/// 기다리는 마감 시간
+		double Deadline{ 0.0 };
+
+		explicit FAsyncWaitState( double timeout )
+			: Deadline( FPlatformTime::Seconds() + timeout )
+		{}
+
+		/// 아직 기다려야 하는지 여부
+		bool IsWaiting() const { return !bComplete && FPlatformTime::Seconds() < Deadline; }
+	};
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 인덱스 : 매치 타입별 후보, 최소 빈 슬롯, 가득 찬 세션 제외
+////////////////////////////////////////////////////////////////////////////
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMultiplayerSessionIndexTest, "MultiplayerSessions.Index", MultiplayerSessionsTests::TestFlags )
+bool FMultiplayerSessionIndexTest::RunTest( const FString& parameters )
+{
+	using namespace MultiplayerSessionsTests;
+
+	TArray< FOnlineSessionSearchResult > results;
+	AddResult( results, EMultiplayerMatchType::FreeForAll,	   0, 30 );
+	AddResult( results, EMultiplayerMatchType::TeamDeathMatch, 3, 30 );
+	AddResult( results, EMultiplayerMatchType::FreeForAll,	   1, 30 );
+	AddResult( results, EMultiplayerMatchType::FreeForAll,	   4, 30 );
+
+	FMultiplayerSessionIndex searchIndex;
+	searchIndex.Build( results );
+
+	const FName freeForAll		= FMultiplayerSessionAdvertisement::GetMatchTypeName( EMultiplayerMatchType::FreeForAll );
+	const FName teamDeathMatch	= FMultiplayerSessionAdvertisement::GetMatchTypeName( EMultiplayerMatchType::TeamDeathMatch );
+	const FName captureTheFlag	= FMultiplayerSessionAdvertisement::GetMatchTypeName( EMultiplayerMatchType::CaptureTheFlag );
+
+	TestEqual( TEXT( "Num" ), searchIndex.Num(), 4 );
+	TestEqual( TEXT( "가득 찬 세션은 후보가 아니다" ), searchIndex.FindCandidate( freeForAll ), 2 );
+	TestEqual( TEXT( "최소 빈 슬롯" ), searchIndex.FindCandidate( freeForAll, 2 ), 3 );
+	TestEqual( TEXT( "빈 슬롯이 부족하면 없음" ), searchIndex.FindCandidate( freeForAll, 5 ), INDEX_NONE );
+	TestEqual( TEXT( "다른 매치 타입" ), searchIndex.FindCandidate( teamDeathMatch ), 1 );
+	TestEqual( TEXT( "광고되지 않은 매치 타입" ), searchIndex.FindCandidate( captureTheFlag ), INDEX_NONE );
+
+	TArray< int32 > candidateIndices;
+	searchIndex.GatherCandidates( freeForAll, 1, candidateIndices );
+	candidateIndices.Sort();
+	TestEqual( TEXT( "GatherCandidates" ), candidateIndices, TArray< int32 >{ 2, 3 } );
+
+	// 값이 없는 사용자 정의 이름은 MatchType 문자열로 인덱싱한다.
+	const FName arena( TEXT( "Arena" ) );
+	AddResult( results, EMultiplayerMatchType::None, 2, 30 );
+	results.Last().Session.SessionSettings.Set( FMultiplayerSessionIndex::MatchTypeKey, arena.ToString(), EOnlineDataAdvertisementType::ViaOnlineServiceAndPing );
+	searchIndex.Build( results );
+	TestEqual( TEXT( "사용자 정의 매치 타입" ), searchIndex.FindCandidate( arena ), 4 );
+
+	FOnlineSearchSettings querySettings;
+	FMultiplayerSessionQueryKey queryKey;
+	queryKey.MatchType = arena;
+	FMultiplayerSessionAdvertisement::AddQueryFilters( querySettings, queryKey );
+	TestTrue( TEXT( "사용자 정의 매치 타입 필터" ), FMultiplayerSessionAdvertisement::MatchesQuery( results[ 4 ].Session.SessionSettings, 2, querySettings ) );
+	TestFalse( TEXT( "다른 매치 타입 제외" ), FMultiplayerSessionAdvertisement::MatchesQuery( results[ 3 ].Session.SessionSettings, 4, querySettings ) );
+
+	// 묶은 광고 없이 MatchType 문자열만 광고하는 이전 호스트도 빌드 / 매치 타입 필터를 통과한다.
+	FOnlineSessionSettings legacySettings;
+	legacySettings.Set( FMultiplayerSessionIndex::MatchTypeKey, freeForAll.ToString(), EOnlineDataAdvertisementType::ViaOnlineServiceAndPing );
+
+	FOnlineSearchSettings legacyQuerySettings;
+	queryKey.MatchType = freeForAll;
+	queryKey.BuildId   = 1;
+	FMultiplayerSessionAdvertisement::AddQueryFilters( legacyQuerySettings, queryKey );
+	TestTrue( TEXT( "이전 호스트" ), FMultiplayerSessionAdvertisement::MatchesQuery( legacySettings, 2, legacyQuerySettings ) );
+	TestFalse( TEXT( "이전 호스트 다른 매치 타입 제외" ), FMultiplayerSessionAdvertisement::MatchesQuery( results[ 4 ].Session.SessionSettings, 2, legacyQuerySettings ) );
+	TestFalse( TEXT( "세팅을 비운 결과 제외" ), FMultiplayerSessionAdvertisement::MatchesQuery( FOnlineSessionSettings(), 2, legacyQuerySettings ) );
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 랭커 : 핑 순서, 후보 수 제한, 가득 찬 세션 제외
+////////////////////////////////////////////////////////////////////////////
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMultiplayerSessionRankerTest, "MultiplayerSessions.Ranker", MultiplayerSessionsTests::TestFlags )
+bool FMultiplayerSessionRankerTest::RunTest( const FString& parameters )
+{
+	using namespace MultiplayerSessionsTests;
+
+	TArray< FOnlineSessionSearchResult > results;
+	AddResult( results, EMultiplayerMatchType::FreeForAll, 2, 200 );
+	AddResult( results, EMultiplayerMatchType::FreeForAll, 2, 10 );
+	AddResult( results, EMultiplayerMatchType::FreeForAll, 0, 1 );
+	AddResult( results, EMultiplayerMatchType::FreeForAll, 2, 50 );
+
+	const TArray< int32 > candidateIndices{ 0, 1, 2, 3 };
+	FMultiplayerPingScorer scorer;
+	TArray< FMultiplayerSessionCandidate > candidates;
+
+	FMultiplayerSessionRanker::SelectTopCandidates( results, candidateIndices, scorer, 8, candidates );
+	if ( TestEqual( TEXT( "가득 찬 세션 제외" ), candidates.Num(), 3 ) )
+	{
+		TestEqual( TEXT( "1 순위" ), candidates[ 0 ].ResultIndex, 1 );
+		TestEqual( TEXT( "2 순위" ), candidates[ 1 ].ResultIndex, 3 );
+		TestEqual( TEXT( "3 순위" ), candidates[ 2 ].ResultIndex, 0 );
+	}
+
+	FMultiplayerSessionRanker::SelectTopCandidates( results, candidateIndices, scorer, 2, candidates );
+	if ( TestEqual( TEXT( "후보 수 제한" ), candidates.Num(), 2 ) )
+	{
+		TestEqual( TEXT( "제한 후 1 순위" ), candidates[ 0 ].ResultIndex, 1 );
+		TestEqual( TEXT( "제한 후 2 순위" ), candidates[ 1 ].ResultIndex, 3 );
+	}
+
+	scorer.MaxPingMs = 100;
+	FMultiplayerSessionRanker::SelectTopCandidates( results, candidateIndices, scorer, 8, candidates );
+	TestEqual( TEXT( "최대 핑 초과 제외" ), candidates.Num(), 2 );
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 대기열 : 같은 세션의 요청은 차례로 실행하고, 중복 생성 요청은 한 번만 실행한다.
+////////////////////////////////////////////////////////////////////////////
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMultiplayerSessionQueueTest, "MultiplayerSessions.Queue", MultiplayerSessionsTests::TestFlags )
+bool FMultiplayerSessionQueueTest::RunTest( const FString& parameters )
+{
+	using namespace MultiplayerSessionsTests;
+
+	TSharedPtr< FMultiplayerFakeSessionBackend > backend;
+	TStrongObjectPtr< UMultiPlayerSessionsSubsystem > subsystem = MakeSubsystem( backend );
+	const FMultiplayerSessionTarget target = MakeTarget( FName( TEXT( "QueueTest" ) ) );
+
+	// 생성이 끝나기 전에 시작을 요청해도 생성 후에 실행된다.
+	subsystem->CreateSession( target, 4, TEXT( "FreeForAll" ) );
+	subsystem->StartSession( target );
+	TestTrue( TEXT( "요청 대기 중" ), subsystem->IsBusy( target.SessionName ) );
+	TestTrue( TEXT( "생성 / 시작 완료" ), FMultiplayerSessionBenchmark::WaitUntilIdle( *subsystem, *backend, false, 1.0 ) );
+
+	const FNamedOnlineSession* namedSession = backend->GetNamedSession( target.SessionName );
+	if ( TestNotNull( TEXT( "세션 생성" ), namedSession ) )
+	{
+		TestEqual( TEXT( "세션 시작" ), namedSession->SessionState, EOnlineSessionState::InProgress );
+	}
+
+	subsystem->DestroySession( target );
+	TestTrue( TEXT( "파괴 완료" ), FMultiplayerSessionBenchmark::WaitUntilIdle( *subsystem, *backend, false, 1.0 ) );
+	TestNull( TEXT( "세션 파괴" ), backend->GetNamedSession( target.SessionName ) );
+
+	// 대기 중인 같은 생성 요청은 하나로 합쳐진다.
+	const uint64 numCreates = FMultiplayerSessionStats::Get().MakeSnapshot( EMultiplayerSessionOp::Create ).Count;
+	subsystem->CreateSession( target, 4, TEXT( "FreeForAll" ) );
+	subsystem->CreateSession( target, 4, TEXT( "FreeForAll" ) );
+	TestTrue( TEXT( "중복 생성 완료" ), FMultiplayerSessionBenchmark::WaitUntilIdle( *subsystem, *backend, false, 1.0 ) );
+	TestEqual( TEXT( "중복 생성은 한 번만 실행" ), FMultiplayerSessionStats::Get().MakeSnapshot( EMultiplayerSessionOp::Create ).Count, numCreates + 1 );
+
+	// 사이에 다른 요청이 있으면 합치지 않고 요청한 순서대로 실행한다.
+	subsystem->DestroySession( target );
+	subsystem->CreateSession( target, 2, TEXT( "FreeForAll" ) );
+	subsystem->DestroySession( target );
+	subsystem->CreateSession( target, 6, TEXT( "FreeForAll" ) );
+	TestTrue( TEXT( "생성 / 파괴 / 생성 완료" ), FMultiplayerSessionBenchmark::WaitUntilIdle( *subsystem, *backend, false, 1.0 ) );
+
+	namedSession = backend->GetNamedSession( target.SessionName );
+	if ( TestNotNull( TEXT( "마지막 생성 요청의 세션" ), namedSession ) )
+	{
+		TestEqual( TEXT( "마지막 생성 요청의 접속 수" ), namedSession->SessionSettings.NumPublicConnections, 6 );
+	}
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 가짜 백엔드로 생성 / 찾기 / 참가를 끝까지 실행한다.
+////////////////////////////////////////////////////////////////////////////
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMultiplayerSessionFlowTest, "MultiplayerSessions.Flow", MultiplayerSessionsTests::TestFlags )
+bool FMultiplayerSessionFlowTest::RunTest( const FString& parameters )
+{
+	using namespace MultiplayerSessionsTests;
+
+	TSharedPtr< FMultiplayerFakeSessionBackend > backend;
+	TStrongObjectPtr< UMultiPlayerSessionsSubsystem > subsystem = MakeSubsystem( backend );
+	const FMultiplayerSessionTarget target = MakeTarget( NAME_GameSession );
+	const FName matchType( TEXT( "FreeForAll" ) );
+
+	subsystem->FindSessions( target, 100, matchType );
+	TestTrue( TEXT( "찾기 완료" ), FMultiplayerSessionBenchmark::WaitUntilIdle( *subsystem, *backend, false, 1.0 ) );
+	TestNotNull( TEXT( "인덱스 후보" ), subsystem->FindIndexedSession( matchType ) );
+
+	TestTrue( TEXT( "최적 세션 참가 요청" ), subsystem->JoinBestSession( target, matchType, 3, 0.f ) );
+	TestTrue( TEXT( "참가 완료" ), FMultiplayerSessionBenchmark::WaitUntilIdle( *subsystem, *backend, false, 1.0 ) );
+	TestNotNull( TEXT( "참가한 세션" ), backend->GetNamedSession( target.SessionName ) );
+
+	// 벤치마크 보고서에 서브시스템 작업 결과가 들어 있어야 한다.
+	FMultiplayerSessionBenchmarkConfig config;
+	config.NumResults			 = 256;
+	config.Iterations			 = 2;
+	config.NumOperations		 = 4;
+	config.NumAdvertisedSessions = 64;
+
+	const FString report = FMultiplayerSessionBenchmark::Run( config );
+	TestTrue( TEXT( "벤치마크 작업 완료" ), report.Contains( TEXT( "\"completed\": true" ) ) );
+	TestTrue( TEXT( "벤치마크 참가 성공" ), report.Contains( TEXT( "\"join\": { \"count\": 4, \"succeeded\": 4" ) ) );
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// LAN 탐색 : 루프백 비콘 응답, 세션 아이디로 중복 제거, 광고한 세팅 전달
+////////////////////////////////////////////////////////////////////////////
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMultiplayerSessionLanDiscoveryTest, "MultiplayerSessions.LanDiscovery", MultiplayerSessionsTests::TestFlags )
+bool FMultiplayerSessionLanDiscoveryTest::RunTest( const FString& parameters )
+{
+	using namespace MultiplayerSessionsTests;
+
+	const FMultiplayerLanDiscoveryConfig config = MakeLanConfig();
+	TSharedRef< FMultiplayerLanSessionBackend > hostA	 = MakeShared< FMultiplayerLanSessionBackend >( config );
+	TSharedRef< FMultiplayerLanSessionBackend > hostB	 = MakeShared< FMultiplayerLanSessionBackend >( config );
+	TSharedRef< FMultiplayerLanSessionBackend > searcher = MakeShared< FMultiplayerLanSessionBackend >( config );
+
+	hostA->SetGamePortResolver( []() { return 7788; } );
+
+	// 호스트 A 는 값이 없는 사용자 정의 매치 타입, 맵, QoS 포트를 광고한다.
+	const FString arena( TEXT( "Arena" ) );
+	const FString mapPath( TEXT( "/Game/Maps/Arena" ) );
+
+	FOnlineSessionSettings settingsA;
+	settingsA.NumPublicConnections = 4;
+	settingsA.BuildUniqueId		   = 1;
+	{
+		FMultiplayerSessionAdvertisement advertisement;
+		advertisement.BuildId	= 1;
+		advertisement.OpenSlots = 3;
+		advertisement.Write( settingsA );
+	}
+	settingsA.Set( FMultiplayerSessionIndex::MatchTypeKey, arena, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing );
+	settingsA.Set( SETTING_MAPNAME, mapPath, EOnlineDataAdvertisementType::ViaOnlineService );
+	settingsA.Set( FMultiplayerSessionIndex::QosPortKey, 8788, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing );
+
+	FOnlineSessionSettings settingsB;
+	settingsB.NumPublicConnections = 4;
+	settingsB.BuildUniqueId		   = 1;
+	{
+		FMultiplayerSessionAdvertisement advertisement;
+		advertisement.MatchType = EMultiplayerMatchType::FreeForAll;
+		advertisement.BuildId	= 1;
+		advertisement.OpenSlots = 4;
+		advertisement.Write( settingsB );
+	}
+
+	if ( !TestTrue( TEXT( "호스트 A 비콘" ), hostA->CreateSession( 0, FName( TEXT( "LanHostA" ) ), settingsA ) )
+		|| !TestTrue( TEXT( "호스트 B 비콘" ), hostB->CreateSession( 0, FName( TEXT( "LanHostB" ) ), settingsB ) ) )
+		return false;
+
+	TestNotEqual( TEXT( "호스트마다 다른 비콘 포트" ), hostA->GetBeaconPort(), hostB->GetBeaconPort() );
+
+	// 사용자 정의 매치 타입으로 거르면 호스트 B 는 빠지고, 두 번 응답한 호스트 A 는 하나만 남아야 한다.
+	TSharedRef< FOnlineSessionSearch > search = MakeShared< FOnlineSessionSearch >();
+	search->MaxSearchResults = 16;
+
+	FMultiplayerSessionQueryKey queryKey;
+	queryKey.MatchType = FName( *arena );
+	FMultiplayerSessionAdvertisement::AddQueryFilters( search->QuerySettings, queryKey );
+
+	TSharedRef< FAsyncWaitState > waitState = MakeShared< FAsyncWaitState >( 5.0 );
+	const FDelegateHandle findHandle = searcher->AddOnFindSessionsCompleteDelegate_Handle(
+		FOnFindSessionsCompleteDelegate::CreateLambda( [ waitState ]( bool bWasSuccessful ) { waitState->bComplete = true; } ) );
+
+	TestTrue( TEXT( "탐색 시작" ), searcher->FindSessions( *MakeTarget( NAME_GameSession ).PlayerId, search ) );
+
+	// 호스트는 비콘이 티커에서 응답하도록 탐색이 끝날 때까지 잡아 둔다.
+	ADD_LATENT_AUTOMATION_COMMAND( FFunctionLatentCommand( [ this, hostA, hostB, searcher, search, waitState, findHandle, arena, mapPath ]()
+	{
+		if ( waitState->IsWaiting() )
+			return false;
+
+		searcher->ClearOnFindSessionsCompleteDelegate_Handle( findHandle );
+
+		TestTrue( TEXT( "탐색 완료" ), waitState->bComplete );
+		if ( !TestEqual( TEXT( "중복 제거 후 조건에 맞는 세션 하나" ), search->SearchResults.Num(), 1 ) )
+			return true;
+
+		const FOnlineSession& session = search->SearchResults[ 0 ].Session;
+
+		FString hostSessionName;
+		FString matchType;
+		FString mapName;
+		int32 qosPort = 0;
+		session.SessionSettings.Get( FMultiplayerSessionIndex::HostSessionKey, hostSessionName );
+		session.SessionSettings.Get( FMultiplayerSessionIndex::MatchTypeKey, matchType );
+		session.SessionSettings.Get( SETTING_MAPNAME, mapName );
+		session.SessionSettings.Get( FMultiplayerSessionIndex::QosPortKey, qosPort );
+
+		TestEqual( TEXT( "호스트 세션 이름" ), hostSessionName, FString( TEXT( "LanHostA" ) ) );
+		TestEqual( TEXT( "MatchType 문자열" ), matchType, arena );
+		TestEqual( TEXT( "맵" ), mapName, mapPath );
+		TestEqual( TEXT( "QoS 포트" ), qosPort, 8788 );
+		TestEqual( TEXT( "광고한 빈 슬롯" ), session.NumOpenPublicConnections, 3 );
+
+		const FMultiplayerLanSessionInfo* sessionInfo = FMultiplayerLanSessionInfo::Get( session );
+		if ( TestNotNull( TEXT( "세션 정보" ), sessionInfo ) )
+		{
+			TestEqual( TEXT( "접속 주소" ), sessionInfo->GetConnectString(), FString( TEXT( "127.0.0.1:7788" ) ) );
+		}
+
+		return true;
+	} ) );
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+/// QoS : 루프백 에코 왕복, 응답 없는 대상, IP 가 아닌 접속 주소
+////////////////////////////////////////////////////////////////////////////
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FMultiplayerSessionQosTest, "MultiplayerSessions.Qos", MultiplayerSessionsTests::TestFlags )
+bool FMultiplayerSessionQosTest::RunTest( const FString& parameters )
+{
+	using namespace MultiplayerSessionsTests;
+
+	constexpr int32 echoPort = 14950;
+
+	TSharedRef< FMultiplayerQosEchoResponder > responder = MakeShared< FMultiplayerQosEchoResponder >();
+	if ( !TestTrue( TEXT( "에코 포트 열기" ), responder->Start( echoPort ) ) )
+		return false;
+
+	// 게임 포트 + 간격으로 에코 포트를 찾는다. 두 번째 대상은 아무도 응답하지 않는 포트다.
+	TArray< FMultiplayerQosTarget > targets;
+	FMultiplayerQosTarget target;
+	if ( TestTrue( TEXT( "대상 해석" ), FMultiplayerQosTarget::Parse( 0, FString::Printf( TEXT( "127.0.0.1:%d" ), echoPort - 1000 ), 1000, target ) ) )
+	{
+		TestEqual( TEXT( "에코 포트" ), target.Port, echoPort );
+		targets.Add( target );
+	}
+
+	if ( TestTrue( TEXT( "응답 없는 대상 해석" ), FMultiplayerQosTarget::Parse( 1, FString::Printf( TEXT( "127.0.0.1:%d" ), echoPort + 1 ), 0, target ) ) )
+	{
+		targets.Add( target );
+	}
+
+	TestFalse( TEXT( "Steam 접속 주소는 측정할 수 없다" ), FMultiplayerQosTarget::Parse( 2, TEXT( "steam.76561197960287930:7777" ), 0, target ) );
+
+	FMultiplayerQosConfig config;
+	config.bEnabled		= true;
+	config.NumProbes	= 3;
+	config.MaxInFlight	= 2;
+	config.ProbeTimeout = 0.2f;
+
+	TSharedRef< FMultiplayerQosProber > prober = MakeShared< FMultiplayerQosProber >( config );
+	TSharedRef< TArray< FMultiplayerQosResult > > results = MakeShared< TArray< FMultiplayerQosResult > >();
+	TSharedRef< FAsyncWaitState > waitState = MakeShared< FAsyncWaitState >( 5.0 );
+
+	TestTrue( TEXT( "측정 시작" ), prober->Start( MoveTemp( targets ), FMultiplayerOnQosComplete::CreateLambda( [ waitState, results ]( const TArray< FMultiplayerQosResult >& qosResults )
+	{
+		*results = qosResults;
+		waitState->bComplete = true;
+	} ) ) );
+
+	ADD_LATENT_AUTOMATION_COMMAND( FFunctionLatentCommand( [ this, responder, prober, results, waitState, config ]()
+	{
+		if ( waitState->IsWaiting() )
+			return false;
+
+		prober->Cancel();
+		responder->Shutdown();
+
+		TestTrue( TEXT( "측정 완료" ), waitState->bComplete );
+		TestEqual( TEXT( "대상마다 결과" ), results->Num(), 2 );
+
+		const FMultiplayerQosResult* reachable = results->FindByPredicate( []( const FMultiplayerQosResult& result ) { return 0 == result.ResultIndex; } );
+		if ( TestNotNull( TEXT( "응답한 대상 결과" ), reachable ) )
+		{
+			TestTrue( TEXT( "에코 응답" ), reachable->IsReachable() );
+			TestEqual( TEXT( "보낸 에코 수" ), reachable->NumSent, config.NumProbes );
+			TestTrue( TEXT( "왕복 시간" ), reachable->RttMs >= 0.f && reachable->RttMs < config.ProbeTimeout * 1000.f );
+		}
+
+		const FMultiplayerQosResult* unreachable = results->FindByPredicate( []( const FMultiplayerQosResult& result ) { return 1 == result.ResultIndex; } );
+		if ( TestNotNull( TEXT( "응답 없는 대상 결과" ), unreachable ) )
+		{
+			TestFalse( TEXT( "응답 없음" ), unreachable->IsReachable() );
+		}
+
+		return true;
+	} ) );
+
+	return true;
+}
+
+
+#endif // WITH_DEV_AUTOMATION_TESTS
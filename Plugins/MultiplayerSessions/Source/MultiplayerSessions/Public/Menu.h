@@ -7,6 +7,8 @@
 #include "Interfaces/OnlineSessionInterface.h"
 #include "Menu.generated.h"
 
+struct FMultiplayerSessionTarget;
+
 
 class UButton;
 class UMultiPlayerSessionsSubsystem;
@@ -31,6 +33,9 @@ private:
 	/// MatchType 정의
 	FString m_MatchType{ TEXT( "FreeForAll" ) };
 
+	/// MatchType 검색 키 ( 검색 결과 인덱스 조회용 )
+	FName m_MatchTypeName{ TEXT( "FreeForAll" ) };
+
 	/// 로비 패스 정의
 	FString m_PathToLobby{ TEXT( "" ) };
 
@@ -75,6 +80,9 @@ protected:
 
 	/// 세션 찾기 결과를 처리한다. [ Delegator 로부터 전달받아 호출된 함수 ]
 	void OnFindSessions( const TArray<FOnlineSessionSearchResult>& sessionResults, bool bWasSuccessful );
+
+	/// 세션 부분 검색 결과를 처리한다. [ Delegator 로부터 전달받아 호출된 함수 ]
+	void OnFindSessionsPartial( const TArray<FOnlineSessionSearchResult>& sessionResults, int32 firstNewIndex );
 	
 	/// 세션 합류 결과를 처리한다. [ Delegator 로부터 전달받아 호출된 함수 ]
 	void OnJoinSession( EOnJoinSessionCompleteResult::Type result );
@@ -99,4 +107,7 @@ private:
 
 	/// 메뉴 키조작을 합니다.
 	void MenuTearDown();
+
+	/// 메뉴를 소유한 로컬 플레이어의 세션 대상을 반환합니다.
+	FMultiplayerSessionTarget GetSessionTarget() const;
 };
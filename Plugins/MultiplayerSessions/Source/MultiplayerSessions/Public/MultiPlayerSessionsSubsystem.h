@@ -3,8 +3,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Ticker.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "Interfaces/OnlineSessionInterface.h"
+#include "MultiplayerDedicatedServer.h"
+#include "MultiplayerSessionAdvertisement.h"
+#include "MultiplayerMapPreloader.h"
+#include "MultiplayerSessionBackend.h"
+#include "MultiplayerSessionIndex.h"
+#include "MultiplayerSessionOperation.h"
+#include "MultiplayerSessionQos.h"
+#include "MultiplayerSessionQuery.h"
+#include "MultiplayerSessionRanker.h"
+#include "MultiplayerSessionStats.h"
 #include "MultiPlayerSessionsSubsystem.generated.h"
 
 
@@ -13,11 +24,103 @@
 ////////////////////////////////////////////////////////////////////////////
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FMultiplayerOnCreateSessionComplete, bool, bWasSuccessful );
 DECLARE_MULTICAST_DELEGATE_TwoParams( FMultiplayerOnFindSessionsComplete, const TArray<FOnlineSessionSearchResult>& sessionResult, bool bWasSuccessful );
+DECLARE_MULTICAST_DELEGATE_TwoParams( FMultiplayerOnFindSessionsPartial, const TArray<FOnlineSessionSearchResult>& sessionResult, int32 firstNewIndex );
 DECLARE_MULTICAST_DELEGATE_OneParam( FMultiplayerOnJoinSessionComplete, EOnJoinSessionCompleteResult::Type result );
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FMultiplayerOnDestroySessionComplete, bool, bWasSuccessful );
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FMultiplayerOnStartSessionComplete, bool, bWasSuccessful );
 
 
+////////////////////////////////////////////////////////////////////////////
+/// 이름별로 관리되는 세션 ( 세션마다 요청 대기열과 상태, 완료 대리자를 따로 가진다 )
+////////////////////////////////////////////////////////////////////////////
+struct FMultiplayerSessionChannel
+{
+	/// 세션 이름 ( 검색 채널은 NAME_None )
+	FName SessionName{ NAME_None };
+
+	/// 세션 백엔드 호출 상태
+	EMultiplayerSessionState State{ EMultiplayerSessionState::Idle };
+
+	/// 진행 중인 세션 작업 요청
+	FMultiplayerSessionRequest ActiveRequest;
+
+	/// 진행 중인 세션 작업을 시작한 시간 ( 지연 시간 기록용 )
+	double ActiveRequestStartTime{ 0.0 };
+
+	/// 대기 중인 세션 작업 요청 ( FIFO )
+	TArray< FMultiplayerSessionRequest > PendingRequests;
+
+	/// 대기열을 처리 중인지 여부 ( 완료 콜백에서 재진입 방지 )
+	bool bIsProcessingRequests{ false };
+
+	/// 처리한 백엔드 완료 수 ( 요청 실패를 완료 대리자로도 알리는 백엔드에서 중복 처리 방지 )
+	uint32 NumCompletions{ 0 };
+
+	/// 진행 중인 요청을 보낸 플레이어
+	FUniqueNetIdPtr PlayerId;
+
+	/// 마지막 세션 세팅 정의
+	TSharedPtr< FOnlineSessionSettings > LastSessionSettings;
+
+	/// 마지막 커넥션 요청 수
+	int32 LastNumPublicConnections{ 0 };
+
+	/// 마지막 매치 타입
+	FString LastMatchType;
+
+	/// 세션 파괴 후 다시 생성할지 여부
+	bool bCreateSessionOnDestroy{ false };
+
+	/// 세션 파괴 후 다음 참가 후보로 넘어갈지 여부
+	bool bJoinNextOnDestroy{ false };
+
+	/// 순위 후보를 차례로 참가 시도 중인지 여부
+	bool bJoinFailover{ false };
+
+	/// 참가 후보가 속한 검색 ( 참가 중 검색 캐시가 갱신되어도 후보 인덱스가 유지된다 )
+	TSharedPtr< FOnlineSessionSearch > JoinSearch;
+
+	/// 참가 후보 ( 점수가 낮은 순 )
+	TArray< FMultiplayerSessionCandidate > JoinCandidates;
+
+	/// 참가 전에 후보의 핑을 측정 중인지 여부
+	bool bMeasuringQos{ false };
+
+	/// 참가 시도 중인 후보 순위
+	int32 JoinCandidateRank{ INDEX_NONE };
+
+	/// 남은 참가 시도 수
+	int32 JoinAttemptsLeft{ 0 };
+
+	/// 참가 시도당 제한 시간 ( 초 ), 0 이면 제한 없음
+	float JoinAttemptTimeout{ 0.f };
+
+	/// 참가 시도 제한 시간 티커 핸들
+	FTSTicker::FDelegateHandle JoinTimeoutTickerHandle;
+
+	/// 광고할 빈 슬롯 수 ( 모아서 갱신하는 동안 마지막 값만 유지한다 )
+	int32 DesiredOpenSlots{ 0 };
+
+	/// 빈 슬롯 갱신을 모으는 티커 핸들
+	FTSTicker::FDelegateHandle BackfillTickerHandle;
+
+	/// 세션 생성 완료 대리자
+	FMultiplayerOnCreateSessionComplete OnCreateSessionComplete;
+
+	/// 세션 참가 완료 대리자
+	FMultiplayerOnJoinSessionComplete OnJoinSessionComplete;
+
+	/// 세션 파괴 완료 대리자
+	FMultiplayerOnDestroySessionComplete OnDestroySessionComplete;
+
+	/// 세션 시작 완료 대리자
+	FMultiplayerOnStartSessionComplete OnStartSessionComplete;
+
+	/// 진행 중이거나 대기 중인 작업이 있는지 여부
+	bool IsBusy() const { return EMultiplayerSessionOp::None != ActiveRequest.Op || PendingRequests.Num() > 0; }
+};
+
+
 /**
  * 
  */
@@ -27,114 +130,272 @@ class MULTIPLAYERSESSIONS_API UMultiPlayerSessionsSubsystem : public UGameInstan
 	GENERATED_BODY()
 	
 private:
-	/// 온라인 세션 인터페이스
-	IOnlineSessionPtr m_SessionInterface;
+	/// 세션 백엔드 ( 기본은 온라인 서브시스템 )
+	TSharedPtr< IMultiplayerSessionBackend > m_SessionInterface;
 
-	/// 마지막 세션 세팅 정의
-	TSharedPtr< FOnlineSessionSettings > m_LastSessionSettings;
+	/// 이름별 세션 ( 생성 / 참가 / 파괴 / 시작 )
+	TMap< FName, TUniquePtr< FMultiplayerSessionChannel > > m_SessionChannels;
+
+	/// 세션 찾기 요청 대기열 ( 백엔드는 한 번에 검색 하나만 진행하므로 세션과 무관하게 하나만 둔다 )
+	FMultiplayerSessionChannel m_SearchChannel;
 
 	/// 마지막 세션 찾기
 	TSharedPtr< FOnlineSessionSearch > m_LastSessionSearch;
 
+	/// 마지막 세션 찾기 결과 인덱스
+	FMultiplayerSessionIndex m_LastSearchIndex;
+
+	/// 인덱스에 반영된 검색 결과 수 ( 스트리밍 검색 시 새 결과 판별용 )
+	int32 m_NumIndexedResults{ 0 };
+
+	/// 마지막 세션 찾기 쿼리 키
+	FMultiplayerSessionQueryKey m_LastSearchKey;
+
+	/// 마지막 세션 찾기에 요청된 최대 검색 결과 수 ( 적응형 검색은 이보다 적은 수로 끝날 수 있다 )
+	int32 m_LastSearchMaxResults{ 0 };
+
+	/// 적응형 검색의 첫 검색 결과 수 ( 0 이면 요청된 최대 수로 한 번에 검색 )
+	int32 m_InitialSearchResults{ 50 };
+
+	/// 조건에 맞는 세션이 없을 때 검색 결과 수를 넓히는 배율
+	int32 m_SearchResultsGrowth{ 4 };
+
+	/// 다음 검색에 재사용할 세션 찾기 ( 결과 배열의 할당을 검색마다 다시 하지 않는다 )
+	TSharedPtr< FOnlineSessionSearch > m_PooledSessionSearch;
+
+	/// 마지막 세션 찾기가 완료된 시간 ( 0 이면 캐시로 사용할 수 없음 )
+	double m_LastSearchCompleteTime{ 0.0 };
+
+	/// 검색 결과를 그대로 재사용하는 시간 ( 초 )
+	float m_SearchCacheTTL{ 10.f };
+
+	/// TTL 이 지난 검색 결과로 응답하면서 백그라운드 갱신을 하는 최대 시간 ( 초 )
+	float m_SearchCacheStaleTime{ 30.f };
+
+	/// 백그라운드 갱신 중인 세션 찾기
+	TSharedPtr< FOnlineSessionSearch > m_RefreshSessionSearch;
+
+	/// 참가 후보 점수 계산
+	TSharedPtr< IMultiplayerSessionScorer > m_SessionScorer;
+
+	/// 마지막으로 순위를 매긴 참가 후보 ( 점수가 낮은 순 )
+	TArray< FMultiplayerSessionCandidate > m_RankedCandidates;
+
+	/// 참가 후보 QoS 측정 설정
+	FMultiplayerQosConfig m_QosConfig;
+
+	/// 참가 후보 QoS 측정 ( 한 번에 한 세션의 후보만 측정한다 )
+	TUniquePtr< FMultiplayerQosProber > m_QosProber;
+
+	/// 호스팅하는 동안 QoS 에코 요청에 응답
+	TUniquePtr< FMultiplayerQosEchoResponder > m_QosResponder;
+
+	/// 스트리밍 검색 폴링 티커 핸들
+	FTSTicker::FDelegateHandle m_StreamingSearchTickerHandle;
+
+	/// 이동할 맵 패키지 미리 로드 ( 게임 인스턴스와 수명을 같이 하므로 travel 후에도 유지된다. 로드 완료 대리자가 약한 참조로 묶도록 공유 포인터로 둔다 )
+	TSharedPtr< FMultiplayerMapPreloader > m_MapPreloader;
+
+	/// 데디케이티드 서버 세션 등록 설정
+	FMultiplayerDedicatedServerConfig m_DedicatedServerConfig;
+
+	/// 데디케이티드 서버 세션 등록 재시도 횟수
+	int32 m_NumRegisterRetries{ 0 };
+
+	/// 데디케이티드 서버 세션 등록 재시도 티커 핸들
+	FTSTicker::FDelegateHandle m_RegisterRetryTickerHandle;
+
+	/// Presence 세션 대신 데디케이티드 서버를 검색할지 여부
+	bool m_SearchDedicatedServers{ false };
+
+	/// 호스팅하는 세션에 광고할 지역 / 빌드 / 실력 구간 ( 매치 타입과 빈 슬롯은 세션마다 채운다 )
+	FMultiplayerSessionAdvertisement m_HostAdvertisement;
+
+	/// 호스팅하는 세션에 광고할 맵 패키지 이름 ( 참가하는 쪽이 미리 로드한다 )
+	FName m_HostMapName;
+
+	/// 검색할 지역 ( INDEX_NONE 이면 모든 지역 )
+	int32 m_SearchRegion{ INDEX_NONE };
+
+	/// 검색할 세션의 최소 빈 슬롯 수
+	int32 m_SearchMinOpenSlots{ 1 };
+
 /// To add to the Online Session Interface delegate list.
-/// We`ll bind our MultiPlayerSessionsSubsystem internal callbacks to these.
+/// 여러 세션의 작업이 동시에 진행되므로 백엔드마다 한 번만 등록하고 세션 이름으로 나눠 처리한다.
 private:
-	/// 세션 생성 완료 대리자
-	FOnCreateSessionCompleteDelegate m_CreateSessionCompleteDelegate;
-
 	/// 세션 생성 완료 대리자 핸들
 	FDelegateHandle m_CreateSessionCompleteDelegateHandle;
 
-	/// 세션 검색 완료 대리자
-	FOnFindSessionsCompleteDelegate m_FindSessionCompleteDelegate;
-
-	//// 세션 검색 완료 대리자 핸들
+	/// 세션 검색 완료 대리자 핸들
 	FDelegateHandle m_FindSessionCompleteDelegateHandle;
 
-	/// 세션 참가 완료 대리자
-	FOnJoinSessionCompleteDelegate m_JoinSessionCompleteDelegate;
-
 	/// 세션 참가 완료 대리자 핸들
 	FDelegateHandle m_JoinSessionCompleteDelegateHandle;
 
-	/// 세션 파괴 완료 대리자
-	FOnDestroySessionCompleteDelegate m_DestroySessionCompleteDelegate;
+	/// 세션 갱신 완료 대리자 핸들
+	FDelegateHandle m_UpdateSessionCompleteDelegateHandle;
 
 	/// 세션 파괴 완료 대리자 핸들
 	FDelegateHandle m_DestroySessionCompleteDelegateHandle;
 
-	/// 세션 시작 완료 대리자
-	FOnStartSessionCompleteDelegate m_StartSessionCompleteDelegate;
-
 	/// 세션 시작 완료 대리자 핸들
 	FDelegateHandle m_StartSessionCompleteDelegateHandle;
 
-	/// 세션 파괴 여부 정의
-	bool m_IsCreateSessionOnDestroy{ false };
-
-	/// 마지막 커넥션 요청 수
-	int32 m_LastNumPublicConnections;
-
-	/// 마지막 매치 타입
-	FString m_LastMatchType;
-
 /// Own custom delegates for the Menu class to bind callbacks to
 public:
-	/// 멀티플레이어 세션 생성 완료 대리자
-	FMultiplayerOnCreateSessionComplete m_MultiplayerOnCreateSessionComplete;
-
 	/// 멀티플레이어 세션 검색 완료 대리자
 	FMultiplayerOnFindSessionsComplete m_MultiplayerOnFindSessionsComplete;
 
-	/// 멀티플레이어 세션 참가 완료 대리자
-	FMultiplayerOnJoinSessionComplete m_MultiplayerOnJoinSessionComplete;
-
-	/// 멀티플레이어 세션 파괴 완료 대리자
-	FMultiplayerOnDestroySessionComplete m_MultiplayerOnDestroySessionComplete;
-
-	/// 멀티플레이어 세션 시작 완료 대리자
-	FMultiplayerOnStartSessionComplete m_MultiplayerOnStartSessionComplete;
+	/// 멀티플레이어 세션 부분 검색 결과 대리자 ( 스트리밍 검색 )
+	FMultiplayerOnFindSessionsPartial m_MultiplayerOnFindSessionsPartial;
 
 
 public:
 	/// 생성자
 	UMultiPlayerSessionsSubsystem();
 
+	/// 서브시스템을 초기화합니다.
+	virtual void Initialize( FSubsystemCollectionBase& collection ) override;
+
+	/// 서브시스템을 정리합니다.
+	virtual void Deinitialize() override;
+
 
 /// To Handle session functionality. The Menu class will call these
+/// 요청은 세션마다 대기열에 쌓여 하나씩 처리되며, 같은 결과를 내는 중복 요청은 하나로 합쳐집니다.
+/// 대상을 받지 않는 함수는 첫 번째 로컬 플레이어의 NAME_GameSession 을 대상으로 합니다.
 public:
-	/// 세션을 생성합니다.
+	/// 세션을 생성합니다. 이미 호스팅 중인 세션은 가능하면 파괴하지 않고 설정만 갱신합니다.
 	void CreateSession( int32 numPublicConnections, FString matchType );
+	void CreateSession( const FMultiplayerSessionTarget& target, int32 numPublicConnections, FString matchType );
+
+	/// 세션을 찾습니다. 같은 조건의 최근 검색 결과가 있으면 캐시로 바로 응답합니다.
+	void FindSessions( int32 maxSearchResults, FName matchType = NAME_None );
+	void FindSessions( const FMultiplayerSessionTarget& target, int32 maxSearchResults, FName matchType = NAME_None );
+
+	/// 세션을 찾으면서 도착한 결과를 pollInterval 마다 부분 결과로 전달합니다.
+	/// 검색 중에 결과를 채우는 백엔드 ( Null, LAN, 가짜 ) 에서만 부분 결과가 나옵니다. Steam 은 완료 시에 한 번에 채우므로 완료 대리자만 의미가 있습니다.
+	void FindSessionsStreaming( int32 maxSearchResults, FName matchType = NAME_None, float pollInterval = 0.1f );
+	void FindSessionsStreaming( const FMultiplayerSessionTarget& target, int32 maxSearchResults, FName matchType = NAME_None, float pollInterval = 0.1f );
+
+	/// 검색 결과 캐시를 무효화합니다. 다음 검색은 항상 백엔드에 요청합니다.
+	void InvalidateSearchCache();
 
-	/// 세션을 찾습니다.
-	void FindSessions( int32 maxSearchResults );
+	/// 검색 결과 캐시 시간을 설정합니다.
+	void SetSearchCacheTime( float ttl, float staleTime );
+
+	/// 진행 중인 세션 찾기를 중단합니다. 완료 대리자는 더 이상 호출되지 않습니다.
+	void StopFindSessions();
 
 	/// 세션에 참가합니다.
 	void JoinSession( const FOnlineSessionSearchResult& sessionResult );
+	void JoinSession( const FMultiplayerSessionTarget& target, const FOnlineSessionSearchResult& sessionResult );
+
+	/// 마지막 검색 결과의 순위 후보에 차례로 참가를 시도합니다. 시도할 후보가 없으면 false
+	/// 후보가 가득 찼거나 없어졌거나 주소를 얻지 못하면 다음 후보로 넘어가고, 최종 결과만 참가 완료 대리자로 전달합니다.
+	bool JoinBestSession( FName matchType, int32 maxAttempts = 3, float attemptTimeout = 10.f );
+	bool JoinBestSession( const FMultiplayerSessionTarget& target, FName matchType, int32 maxAttempts = 3, float attemptTimeout = 10.f );
 
 	/// 세션을 파괴합니다.
 	void DestroySession();
+	void DestroySession( const FMultiplayerSessionTarget& target );
 
 	/// 세션을 시작합니다.
 	void StartSession();
+	void StartSession( const FMultiplayerSessionTarget& target );
+
+	/// 호스팅 중인 세션의 빈 슬롯 수를 광고합니다. debounceDelay 안의 변경은 모아서 한 번만 갱신합니다.
+	/// 빈 슬롯이 없으면 광고를 멈추고, 슬롯이 비면 다시 광고합니다.
+	void SetOpenSlots( int32 numOpenSlots, FName sessionName = NAME_GameSession, float debounceDelay = 0.5f );
+
+	/// 마지막 검색 결과에서 MatchType 과 빈 슬롯 조건에 맞는 참가 후보를 반환합니다. 없으면 nullptr
+	const FOnlineSessionSearchResult* FindIndexedSession( FName matchType, int32 minOpenSlots = 1 ) const;
+
+	/// 마지막 검색 결과의 참가 후보들을 점수 순으로 최대 maxCandidates 개 선정합니다. 선정된 후보 수를 반환합니다.
+	int32 RankSessions( FName matchType, int32 maxCandidates = 8, int32 minOpenSlots = 1 );
+
+	/// 선정된 참가 후보 중 rank 번째 후보를 반환합니다. 없으면 nullptr
+	const FOnlineSessionSearchResult* GetRankedSession( int32 rank ) const;
+
+	/// 참가 후보 점수 계산 방식을 설정합니다. nullptr 이면 기본 핑 점수를 사용합니다.
+	void SetSessionScorer( TSharedPtr< IMultiplayerSessionScorer > scorer );
+
+	/// 세션 백엔드를 바꿉니다. nullptr 이면 온라인 서브시스템을 사용합니다. 진행 중인 작업이 있으면 false
+	bool SetSessionBackend( TSharedPtr< IMultiplayerSessionBackend > backend );
+
+	/// 참가한 세션의 접속 주소를 얻습니다. 호스트가 광고한 세션 이름이 있으면 ?Session= 접속 옵션을 붙입니다.
+	bool GetResolvedConnectString( FString& outAddress, FName sessionName = NAME_GameSession ) const;
+
+	/// 이동할 맵 패키지를 비동기로 미리 로드합니다. 해당 맵으로 이동이 끝나면 자동으로 놓아줍니다.
+	void PreloadMap( const FString& mapPath );
+
+	/// 맵 패키지가 미리 로드되어 있는지 여부
+	bool IsMapPreloaded( const FString& mapPath ) const;
+
+	/// 세션의 최대 접속 수를 반환합니다. 세션이 없으면 0
+	int32 GetNumPublicConnections( FName sessionName = NAME_GameSession ) const;
+
+	/// 세션의 백엔드 호출 상태를 반환합니다.
+	EMultiplayerSessionState GetSessionState( FName sessionName = NAME_GameSession ) const;
+
+	/// 진행 중이거나 대기 중인 세션 작업이 있는지 여부 ( NAME_None 이면 모든 세션과 검색 )
+	bool IsBusy( FName sessionName = NAME_None ) const;
+
+	/// 관리 중인 세션 이름들을 얻습니다.
+	void GetSessionNames( TArray< FName >& outSessionNames ) const;
+
+	/// 데디케이티드 서버로 실행 중인지 여부
+	bool IsDedicatedServer() const;
+
+	/// 이 프로세스가 호스팅하는 게임 세션 이름을 반환합니다. 데디케이티드 서버는 등록 설정의 이름 ( -SessionName= ), 그 외에는 NAME_GameSession
+	FName GetHostedSessionName() const;
+
+	/// 게임 접속 포트를 반환합니다. 리슨 중이면 넷 드라이버가 연 포트, 아니면 월드 URL 의 포트 ( 월드가 없으면 0 )
+	int32 GetListenPort() const;
+
+	/// 설정에 따라 데디케이티드 서버 세션을 등록합니다. 로컬 플레이어 없이 bIsDedicated 세션을 만들고, 실패하면 다시 시도합니다.
+	void RegisterDedicatedServer();
+
+	/// Presence 세션 대신 데디케이티드 서버를 검색할지 설정합니다.
+	void SetSearchDedicatedServers( bool bSearchDedicatedServers );
+
+	/// 이후 호스팅하는 세션에 광고할 지역과 실력 구간을 설정합니다.
+	void SetHostAdvertisement( uint8 region, uint8 skillBand );
+
+	/// 이후 호스팅하는 세션에 광고할 맵을 설정합니다. 참가하는 쪽은 참가를 기다리는 동안 이 맵을 미리 로드합니다.
+	void SetHostMap( const FString& mapPath );
+
+	/// 백엔드에 보낼 검색 필터를 설정합니다. 같은 빌드의 세션만 찾고, 빈 슬롯과 지역 조건에 맞지 않는 세션은 받지 않습니다.
+	/// 파티로 참가하려면 minOpenSlots 를 파티 인원으로 설정합니다. region 이 INDEX_NONE 이면 모든 지역
+	void SetSearchFilters( int32 minOpenSlots, int32 region = INDEX_NONE );
+
+	/// 적응형 검색 결과 수를 설정합니다. initialSearchResults 개부터 찾고, 조건에 맞는 세션이 없을 때만 growth 배씩 넓힙니다.
+	/// initialSearchResults 가 0 이면 요청된 최대 수로 한 번에 검색합니다.
+	void SetAdaptiveSearchLimit( int32 initialSearchResults, int32 growth = 4 );
+
+	/// 참가 후보 QoS 측정 설정을 바꿉니다. 진행 중인 측정에는 적용되지 않습니다.
+	void SetQosConfig( const FMultiplayerQosConfig& config );
 
 
 /// Getter and Setter
 public:
 	/// 멀티플레이어 세션 생성 완료 대리자를 반환한다.
-	FMultiplayerOnCreateSessionComplete& GetMultiplayerOnCreateSessionComplete();
+	FMultiplayerOnCreateSessionComplete& GetMultiplayerOnCreateSessionComplete( FName sessionName = NAME_GameSession );
 
 	/// 멀티플레이어 세션 검색 완료 대리자를 반환한다.
 	FMultiplayerOnFindSessionsComplete& GetMultiplayerOnFindSessionsComplete();
 
+	/// 멀티플레이어 세션 부분 검색 결과 대리자를 반환한다.
+	FMultiplayerOnFindSessionsPartial& GetMultiplayerOnFindSessionsPartial();
+
 	/// 멀티플레이어 세션 참가 완료 대리자를 반환한다.
-	FMultiplayerOnJoinSessionComplete& GetMultiplayerOnJoinSessionComplete();
+	FMultiplayerOnJoinSessionComplete& GetMultiplayerOnJoinSessionComplete( FName sessionName = NAME_GameSession );
 
 	// 멀티플레이어 세션 파괴 완료 대리자를 반환한다.
-	FMultiplayerOnDestroySessionComplete& GetMultiplayerOnDestroySessionComplete();
+	FMultiplayerOnDestroySessionComplete& GetMultiplayerOnDestroySessionComplete( FName sessionName = NAME_GameSession );
 
 	/// 멀티플레이어 세션 시작 완료 대리자를 반환한다.
-	FMultiplayerOnStartSessionComplete& GetMultiplayerOnStartSessionComplete();
+	FMultiplayerOnStartSessionComplete& GetMultiplayerOnStartSessionComplete( FName sessionName = NAME_GameSession );
 
 
 /// Internal callbacks for the delegates we'll add to the OnlineSession Interface delegate list.
@@ -143,9 +404,15 @@ protected:
 	/// 세션 생성이 완료되었을 때 처리한다.
 	void OnCreateSessionComplete( FName sessionName, bool bWasSuccessful );
 
+	/// 세션 갱신이 완료되었을 때 처리한다.
+	void OnUpdateSessionComplete( FName sessionName, bool bWasSuccessful );
+
 	/// 세션 검색이 완료되었을 때 처리한다.
 	void OnFindSessionsComplete(bool bwasSuccessful);
 
+	/// 검색 캐시 갱신이 완료되었을 때 처리한다.
+	void OnRefreshSessionsComplete( bool bWasSuccessful );
+
 	/// 세션 합류가 완료되었을 때 처리한다.
 	void OnJoinSessionComplete( FName sessionName, EOnJoinSessionCompleteResult::Type result );
 
@@ -154,4 +421,145 @@ protected:
 
 	/// 세션 시작이 완료되었을 때 처리한다.
 	void OnStartSessionComplete(FName sessionName, bool bwasSuccessful);
+
+	/// 데디케이티드 서버 세션 등록 결과를 처리한다. [ Delegator 로부터 전달받아 호출된 함수 ]
+	UFUNCTION()
+	void OnDedicatedServerRegistered( bool bWasSuccessful );
+
+
+private:
+	/// 백엔드에 완료 대리자를 등록한다.
+	void BindBackendDelegates();
+
+	/// 백엔드에 등록한 완료 대리자를 해제한다.
+	void UnbindBackendDelegates();
+
+	/// 세션 이름의 채널을 반환한다. 없으면 만든다.
+	FMultiplayerSessionChannel& FindOrAddChannel( FName sessionName );
+
+	/// 세션 이름의 채널을 반환한다. 없으면 nullptr
+	FMultiplayerSessionChannel* FindChannel( FName sessionName ) const;
+
+	/// 요청을 보낼 플레이어를 정한다. 대상에 플레이어가 없으면 첫 번째 로컬 플레이어
+	FUniqueNetIdPtr ResolvePlayerId( const FMultiplayerSessionTarget& target ) const;
+
+	/// 요청을 대기열에 넣는다. 진행 중이거나 대기 중인 같은 요청이 있으면 합친다.
+	void QueueRequest( FMultiplayerSessionRequest&& request );
+
+	/// 진행 중인 작업이 없으면 대기열의 다음 요청을 실행한다.
+	void ProcessNextRequest( FMultiplayerSessionChannel& channel );
+
+	/// 진행 중인 요청을 끝내고 다음 요청으로 넘어간다. 취소된 요청과 캐시로 응답한 요청은 지연 시간을 기록하지 않는다.
+	void FinishRequest( FMultiplayerSessionChannel& channel, bool bRecordLatency = true );
+
+	/// 요청을 실행한다.
+	void ExecuteRequest( FMultiplayerSessionChannel& channel );
+
+	/// 세션 생성 요청을 실행한다.
+	void ExecuteCreateSession( FMultiplayerSessionChannel& channel, int32 numPublicConnections, const FString& matchType );
+
+	/// 세션 찾기 요청을 실행한다.
+	void ExecuteFindSessions( int32 maxSearchResults, FName matchType, float pollInterval );
+
+	/// 세션 참가 요청을 실행한다.
+	void ExecuteJoinSession( FMultiplayerSessionChannel& channel );
+
+	/// 세션 파괴를 요청한다. 요청이 실패하면 false
+	bool BeginDestroySession( FMultiplayerSessionChannel& channel );
+
+	/// 세션 시작을 요청한다. 요청이 실패하면 false
+	bool BeginStartSession( FMultiplayerSessionChannel& channel );
+
+	/// 빈 슬롯 갱신 요청을 실행한다.
+	void ExecuteUpdateSession( FMultiplayerSessionChannel& channel );
+
+	/// 빈 슬롯 갱신을 모으는 시간이 지났을 때 처리한다.
+	bool OnBackfillDebounceElapsed( float deltaTime, FName sessionName );
+
+	/// 세션 생성 요청을 끝내고 결과를 전달한다.
+	void FinishCreateSession( FMultiplayerSessionChannel& channel, bool bWasSuccessful );
+
+	/// 세션 찾기 요청을 끝내고 결과를 전달한다. 캐시로 응답한 검색은 백엔드 지연 시간이 아니므로 기록하지 않는다.
+	void FinishFindSessions( const TArray< FOnlineSessionSearchResult >& sessionResults, bool bWasSuccessful, bool bRecordLatency = true );
+
+	/// 기존 세션을 파괴하지 않고 설정만 갱신할 수 있는지 여부
+	bool CanUpdateSessionInPlace( const FNamedOnlineSession& existingSession, int32 numPublicConnections ) const;
+
+	/// 세션 설정에 광고를 쓴다.
+	void WriteAdvertisement( FOnlineSessionSettings& settings, const FString& matchType, int32 numOpenSlots ) const;
+
+	/// 기존 세션의 접속 수와 MatchType 을 갱신한다. 요청이 실패하면 false
+	bool UpdateSessionInPlace( FMultiplayerSessionChannel& channel, FNamedOnlineSession& existingSession, int32 numPublicConnections, const FString& matchType );
+
+	/// 검색 쿼리 키를 만든다.
+	FMultiplayerSessionQueryKey MakeSearchQueryKey( FName matchType ) const;
+
+	/// 쿼리 키로 세션 찾기 객체를 만든다. 재사용할 객체가 있으면 그 할당을 그대로 쓴다.
+	TSharedRef< FOnlineSessionSearch > MakeSessionSearch( int32 maxSearchResults, const FMultiplayerSessionQueryKey& queryKey );
+
+	/// 더 이상 참조하지 않는 세션 찾기를 다음 검색에 재사용하도록 돌려놓는다.
+	void ReleaseSessionSearch( TSharedPtr< FOnlineSessionSearch >& sessionSearch );
+
+	/// 마지막 검색 조건으로 maxSearchResults 개까지 세션 찾기를 요청한다.
+	void BeginSessionSearch( int32 maxSearchResults, float pollInterval );
+
+	/// 조건에 맞는 세션이 없고 결과가 제한에 걸렸다면 결과 수를 넓혀 다시 검색한다. 다시 검색하면 true
+	bool WidenSessionSearch();
+
+	/// 검색 결과에서 후보 순위와 참가에 쓰지 않는 세팅을 버린다.
+	void CompactSearchResults( FOnlineSessionSearch& sessionSearch ) const;
+
+	/// 캐시된 검색 결과의 경과 시간을 반환한다. 재사용할 수 없으면 음수
+	double GetSearchCacheAge( const FMultiplayerSessionQueryKey& queryKey, int32 maxSearchResults ) const;
+
+	/// 마지막 검색과 같은 조건으로 백그라운드 검색을 시작한다.
+	void RefreshSearchCache();
+
+	/// 진행 중인 백그라운드 검색을 취소한다.
+	void CancelSearchCacheRefresh();
+
+	/// 스트리밍 검색 중 새로 도착한 결과를 확인한다.
+	bool TickStreamingSearch( float deltaTime );
+
+	/// 스트리밍 검색 폴링을 멈춘다.
+	void StopStreamingSearchTicker();
+
+	/// 아직 인덱스에 반영되지 않은 검색 결과를 추가한다. 새 결과의 시작 인덱스를 반환하고 없으면 INDEX_NONE
+	int32 IndexNewSearchResults();
+
+	/// 세션 참가를 요청한다. 요청이 실패하면 false
+	bool BeginJoinSession( FMultiplayerSessionChannel& channel, const FOnlineSessionSearchResult& sessionResult );
+
+	/// 다음 순위 후보로 참가를 시도한다. 진행 중인 시도가 없으면 false
+	bool TryNextJoinCandidate( FMultiplayerSessionChannel& channel );
+
+	/// 참가 후보의 핑 측정을 시작한다. 측정하지 않으면 false
+	bool BeginSessionQos( FMultiplayerSessionChannel& channel );
+
+	/// 측정한 핑으로 참가 후보 순위를 다시 매기고 참가를 시도한다.
+	void OnSessionQosComplete( const TArray< FMultiplayerQosResult >& results, FName sessionName );
+
+	/// 호스팅한 세션의 QoS 에코 응답을 시작한다.
+	void StartQosResponder();
+
+	/// 호스트가 QoS 에코에 응답할 포트를 반환한다. ( 응답 중이면 그 포트 )
+	int32 GetQosEchoPort() const;
+
+	/// 순위 후보 참가를 끝내고 결과를 전달한다.
+	void FinishJoinFailover( FMultiplayerSessionChannel& channel, EOnJoinSessionCompleteResult::Type result );
+
+	/// 참가 시도 제한 시간이 지났을 때 처리한다.
+	bool OnJoinAttemptTimeout( float deltaTime, FName sessionName );
+
+	/// 참가 시도 제한 시간 티커를 멈춘다.
+	static void StopJoinTimeoutTicker( FMultiplayerSessionChannel& channel );
+
+	/// 빈 슬롯 갱신 티커를 멈춘다.
+	static void StopBackfillTicker( FMultiplayerSessionChannel& channel );
+
+	/// 데디케이티드 서버 세션 등록을 다시 시도한다.
+	bool OnRegisterRetryElapsed( float deltaTime );
+
+	/// 다음 후보로 넘어가도 되는 참가 실패인지 여부 ( 가득 참, 세션 없음, 주소 조회 실패 )
+	static bool IsRetryableJoinResult( EOnJoinSessionCompleteResult::Type result );
 };
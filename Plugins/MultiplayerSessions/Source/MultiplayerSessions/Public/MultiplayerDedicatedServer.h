@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 데디케이티드 서버 세션 등록 설정
+/// DefaultGame.ini 의 [MultiplayerSessions.DedicatedServer] 를 읽고, 명령줄 인자로 덮어쓴다.
+/// 예 : MenuSystemServer Lobby -log -SessionConnections=8 -SessionMatchType=FreeForAll -SessionName=GameSession
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerDedicatedServerConfig
+{
+	/// 설정 섹션 이름
+	static const TCHAR* ConfigSection;
+
+	/// 서버 시작 시 세션을 자동으로 등록할지 여부 ( 명령줄 -NoSessionRegister 로 끌 수 있다 )
+	bool bAutoRegister{ true };
+
+	/// 등록할 세션 이름
+	FName SessionName{ NAME_GameSession };
+
+	/// 최대 접속 수
+	int32 NumPublicConnections{ 4 };
+
+	/// 광고할 MatchType
+	FString MatchType{ TEXT( "FreeForAll" ) };
+
+	/// 등록에 실패했을 때 다시 시도하기까지의 시간 ( 초 )
+	float RetryDelay{ 5.f };
+
+	/// 등록 재시도 횟수 ( 음수면 무제한 )
+	int32 MaxRetries{ -1 };
+
+
+	/// 설정 파일과 명령줄에서 설정을 읽는다.
+	static FMultiplayerDedicatedServerConfig Load();
+};
@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Math/RandomStream.h"
+#include "MultiplayerSessionBackend.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 가짜 세션 백엔드 설정
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerFakeBackendConfig
+{
+	/// 광고 중인 세션 수
+	int32 NumSessions{ 1000 };
+
+	/// 광고할 MatchType 목록
+	TArray< FString > MatchTypes{ TEXT( "FreeForAll" ) };
+
+	/// 광고 세션을 나눌 지역 수 ( 지역 필터 검색용 )
+	int32 NumRegions{ 1 };
+
+	/// 요청 지연 시간 기본값 ( ms )
+	float LatencyMs{ 50.f };
+
+	/// 요청 지연 시간 꼬리 평균 ( ms, 지수 분포로 더해진다 )
+	float LatencyJitterMs{ 30.f };
+
+	/// 요청 실패 확률 ( 0 ~ 1 )
+	float CreateFailureRate{ 0.f };
+	float FindFailureRate{ 0.f };
+	float JoinFailureRate{ 0.f };
+
+	/// 참가 요청이 도착하기 전에 다른 플레이어가 마지막 슬롯을 차지할 확률 ( 0 ~ 1 )
+	float FullLobbyRaceRate{ 0.f };
+
+	/// 세션 찾기 결과를 나눠서 전달하는 횟수
+	int32 NumFindBatches{ 4 };
+
+	/// LAN 세션으로 동작할지 여부
+	bool bIsLAN{ false };
+
+	/// 난수 시드 ( 같은 시드면 같은 결과를 만든다 )
+	int32 Seed{ 1234 };
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 프로세스 내 가짜 세션 백엔드
+/// 네트워크 없이 광고 세션 수, 지연 시간 분포, 실패율, 가득 찬 로비 경쟁을 흉내 낸다.
+/// 완료 대리자는 코어 티커에서 지연 시간이 지난 후 호출된다. ( Flush 로 즉시 처리할 수도 있다 )
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerFakeSessionBackend : public IMultiplayerSessionBackend
+{
+private:
+	/// 예약된 완료 이벤트
+	struct FPendingEvent
+	{
+		/// 실행 시간
+		double DueTime{ 0.0 };
+
+		/// 같은 시간 이벤트의 순서
+		uint64 Sequence{ 0 };
+
+		/// 세션 찾기 이벤트 여부 ( 취소 시 제거 )
+		bool bIsFind{ false };
+
+		/// 실행할 작업
+		TFunction< void() > Execute;
+	};
+
+	/// 설정
+	FMultiplayerFakeBackendConfig m_Config;
+
+	/// 난수
+	FRandomStream m_Random;
+
+	/// 광고 중인 세션
+	TArray< FOnlineSessionSearchResult > m_AdvertisedSessions;
+
+	/// 호스트 이름 → 광고 세션 인덱스
+	TMap< FString, int32 > m_AdvertisedSessionIndices;
+
+	/// 생성 / 참가한 세션
+	TMap< FName, TSharedRef< FNamedOnlineSession > > m_NamedSessions;
+
+	/// 예약된 완료 이벤트 ( DueTime 기준 최소 힙 )
+	TArray< FPendingEvent > m_PendingEvents;
+
+	/// 다음 이벤트 순서
+	uint64 m_NextSequence{ 0 };
+
+	/// 진행 중인 세션 찾기
+	TSharedPtr< FOnlineSessionSearch > m_ActiveSearch;
+
+	/// 이벤트 처리 티커 핸들
+	FTSTicker::FDelegateHandle m_TickerHandle;
+
+
+public:
+	/// 생성자
+	explicit FMultiplayerFakeSessionBackend( const FMultiplayerFakeBackendConfig& config = FMultiplayerFakeBackendConfig() );
+
+	/// 소멸자
+	virtual ~FMultiplayerFakeSessionBackend();
+
+	/// 설정을 바꾸고 광고 세션을 다시 만든다. 예약된 이벤트와 세션은 모두 지운다.
+	void Reset( const FMultiplayerFakeBackendConfig& config );
+
+	/// 현재 시간까지 도달한 이벤트를 처리한다.
+	void Pump( double now );
+
+	/// 예약된 이벤트를 시간과 관계없이 모두 처리한다.
+	void Flush();
+
+	/// 설정을 반환한다.
+	const FMultiplayerFakeBackendConfig& GetConfig() const;
+
+	/// 광고 중인 세션 수를 반환한다.
+	int32 GetNumAdvertisedSessions() const;
+
+
+public:
+	virtual bool CreateSession( const FUniqueNetId& hostingPlayerId, FName sessionName, const FOnlineSessionSettings& newSessionSettings ) override;
+	virtual bool CreateSession( int32 hostingPlayerNum, FName sessionName, const FOnlineSessionSettings& newSessionSettings ) override;
+	virtual bool StartSession( FName sessionName ) override;
+	virtual bool UpdateSession( FName sessionName, FOnlineSessionSettings& updatedSessionSettings ) override;
+	virtual bool DestroySession( FName sessionName ) override;
+	virtual bool FindSessions( const FUniqueNetId& searchingPlayerId, const TSharedRef< FOnlineSessionSearch >& searchSettings ) override;
+	virtual bool CancelFindSessions() override;
+	virtual bool JoinSession( const FUniqueNetId& localPlayerId, FName sessionName, const FOnlineSessionSearchResult& desiredSession ) override;
+	virtual FNamedOnlineSession* GetNamedSession( FName sessionName ) override;
+	virtual bool GetResolvedConnectString( FName sessionName, FString& connectInfo ) override;
+	virtual bool GetResolvedConnectString( const FOnlineSessionSearchResult& searchResult, FName portType, FString& connectInfo ) override;
+	virtual bool IsLAN() const override;
+
+
+private:
+	/// 지연 시간 후에 실행할 작업을 예약한다.
+	void Schedule( double delaySeconds, TFunction< void() >&& execute, bool bIsFind = false );
+
+	/// 설정된 분포로 지연 시간 ( 초 ) 을 뽑는다.
+	double SampleLatency();
+
+	/// 확률 rate 로 true 를 반환한다.
+	bool Roll( float rate );
+
+	/// 광고 세션을 만든다.
+	void BuildAdvertisedSessions();
+
+	/// 코어 티커에서 이벤트를 처리한다.
+	bool Tick( float deltaTime );
+};
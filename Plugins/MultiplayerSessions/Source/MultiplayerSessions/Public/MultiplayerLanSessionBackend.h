@@ -0,0 +1,213 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "MultiplayerSessionBackend.h"
+#include "OnlineSessionSettings.h"
+
+
+class FSocket;
+class FInternetAddr;
+struct FMultiplayerLanDiscovery;
+
+
+////////////////////////////////////////////////////////////////////////////
+/// LAN 탐색 설정
+/// DefaultGame.ini 의 [MultiplayerSessions.LanDiscovery] 를 읽고, 명령줄 -LanBeaconPort= / -LanProbe= 로 덮어쓴다.
+/// 한 장비에서 여러 호스트를 띄우면 BasePort 부터 비어 있는 포트를 하나씩 차지하므로 루프백만으로 테스트할 수 있다.
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerLanDiscoveryConfig
+{
+	/// 설정 섹션 이름
+	static const TCHAR* ConfigSection;
+
+	/// 탐색할 주소 ( 호스트 / 서브넷 브로드캐스트 주소, 마지막 자리 범위 10.0.0.1-254 )
+	TArray< FString > ProbeAddresses{ TEXT( "127.0.0.1" ) };
+
+	/// 비콘 포트 범위의 시작
+	int32 BasePort{ 14000 };
+
+	/// 비콘 포트 수
+	int32 NumPorts{ 16 };
+
+	/// 호스트가 사용할 비콘 포트 ( 0 이면 포트 범위에서 비어 있는 포트 )
+	int32 BeaconPort{ 0 };
+
+	/// 탐색 작업 하나가 맡는 주소:포트 수
+	int32 ShardSize{ 16 };
+
+	/// 동시에 진행하는 탐색 작업 수
+	int32 MaxConcurrentShards{ 4 };
+
+	/// 탐색 작업이 응답을 기다리는 시간 ( 초 )
+	float ProbeTimeout{ 0.25f };
+
+	/// 호스트가 광고하는 게임 접속 포트 ( 실제 리슨 포트를 알 수 없을 때만 쓴다 )
+	int32 GamePort{ 7777 };
+
+	/// 서브시스템 초기화 시 LAN 서브시스템 대신 사용할지 여부
+	bool bEnabled{ false };
+
+
+	/// 설정 파일과 명령줄에서 설정을 읽는다.
+	static FMultiplayerLanDiscoveryConfig Load();
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// LAN 탐색으로 찾은 세션 정보 ( 참가 시 접속 주소를 얻는다 )
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerLanSessionInfo : public FOnlineSessionInfo
+{
+public:
+	/// 세션 아이디 타입
+	static const FName SessionIdType;
+
+	/// 호스트가 세션마다 만든 아이디 ( 여러 주소로 응답해도 같은 세션이다 )
+	FGuid SessionGuid;
+
+	/// 응답한 호스트 주소
+	FString HostAddress;
+
+	/// 게임 접속 포트
+	int32 GamePort{ 0 };
+
+private:
+	/// 세션 아이디
+	FUniqueNetIdRef m_SessionId;
+
+
+public:
+	/// 생성자
+	FMultiplayerLanSessionInfo( const FGuid& sessionGuid, const FString& hostAddress, int32 gamePort );
+
+	/// 접속 주소 ( 주소:포트 ) 를 반환한다.
+	FString GetConnectString() const;
+
+	/// LAN 탐색으로 찾은 세션 정보이면 반환한다. 아니면 nullptr
+	static const FMultiplayerLanSessionInfo* Get( const FOnlineSession& session );
+
+
+public:
+	virtual const uint8* GetBytes() const override;
+	virtual int32 GetSize() const override;
+	virtual bool IsValid() const override;
+	virtual const FUniqueNetId& GetSessionId() const override;
+	virtual FString ToString() const override;
+	virtual FString ToDebugString() const override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// LAN 탐색 세션 백엔드
+/// 호스트는 비콘 포트에서 탐색 요청에 응답하고, 검색하는 쪽은 주소:포트 목록을 샤드로 나눠 워커 작업에서 동시에 탐색한다.
+/// 동시에 진행하는 작업 수는 MaxConcurrentShards 로 제한하고, 응답은 세션 아이디로 중복을 제거해서 도착하는 대로 결과에 추가한다.
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerLanSessionBackend : public IMultiplayerSessionBackend
+{
+private:
+	/// 설정
+	FMultiplayerLanDiscoveryConfig m_Config;
+
+	/// 생성 / 참가한 세션
+	TMap< FName, TSharedRef< FNamedOnlineSession > > m_NamedSessions;
+
+	/// 호스팅 중인 세션의 아이디
+	TMap< FName, FGuid > m_HostedSessionIds;
+
+	/// 비콘 소켓 ( 호스팅 중일 때만 연다 )
+	FSocket* m_BeaconSocket{ nullptr };
+
+	/// 비콘 포트
+	int32 m_BeaconPort{ 0 };
+
+	/// 다음 틱에 호출할 완료 대리자 ( 온라인 서브시스템처럼 요청 함수 안에서 완료하지 않는다 )
+	TArray< TFunction< void() > > m_PendingCompletions;
+
+	/// 진행 중인 세션 찾기
+	TSharedPtr< FOnlineSessionSearch > m_ActiveSearch;
+
+	/// 진행 중인 탐색 ( 워커 작업과 공유한다 )
+	TSharedPtr< FMultiplayerLanDiscovery, ESPMode::ThreadSafe > m_Discovery;
+
+	/// 탐색 샤드 ( 주소별로 묶은 주소:포트 목록 )
+	TArray< TArray< TSharedRef< FInternetAddr > > > m_Shards;
+
+	/// 다음에 시작할 샤드 ( 시작한 작업 수 )
+	int32 m_NextShard{ 0 };
+
+	/// 결과에 추가한 세션 아이디
+	TSet< FGuid > m_FoundSessionIds;
+
+	/// 비콘 / 탐색 처리 티커 핸들
+	FTSTicker::FDelegateHandle m_TickerHandle;
+
+	/// 실제 게임 접속 포트를 반환하는 함수 ( 없거나 0 을 반환하면 설정의 GamePort )
+	TFunction< int32() > m_GamePortResolver;
+
+
+public:
+	/// 생성자
+	explicit FMultiplayerLanSessionBackend( const FMultiplayerLanDiscoveryConfig& config = FMultiplayerLanDiscoveryConfig::Load() );
+
+	/// 소멸자
+	virtual ~FMultiplayerLanSessionBackend();
+
+	/// 설정을 반환한다.
+	const FMultiplayerLanDiscoveryConfig& GetConfig() const;
+
+	/// 비콘 포트를 반환한다. 호스팅 중이 아니면 0
+	int32 GetBeaconPort() const;
+
+	/// 비콘 응답에 광고할 게임 접속 포트를 얻는 함수를 설정한다. ( 리슨 서버의 실제 포트 )
+	void SetGamePortResolver( TFunction< int32() >&& resolver );
+
+
+public:
+	virtual bool CreateSession( const FUniqueNetId& hostingPlayerId, FName sessionName, const FOnlineSessionSettings& newSessionSettings ) override;
+	virtual bool CreateSession( int32 hostingPlayerNum, FName sessionName, const FOnlineSessionSettings& newSessionSettings ) override;
+	virtual bool StartSession( FName sessionName ) override;
+	virtual bool UpdateSession( FName sessionName, FOnlineSessionSettings& updatedSessionSettings ) override;
+	virtual bool DestroySession( FName sessionName ) override;
+	virtual bool FindSessions( const FUniqueNetId& searchingPlayerId, const TSharedRef< FOnlineSessionSearch >& searchSettings ) override;
+	virtual bool CancelFindSessions() override;
+	virtual bool JoinSession( const FUniqueNetId& localPlayerId, FName sessionName, const FOnlineSessionSearchResult& desiredSession ) override;
+	virtual FNamedOnlineSession* GetNamedSession( FName sessionName ) override;
+	virtual bool GetResolvedConnectString( FName sessionName, FString& connectInfo ) override;
+	virtual bool GetResolvedConnectString( const FOnlineSessionSearchResult& searchResult, FName portType, FString& connectInfo ) override;
+	virtual bool IsLAN() const override;
+
+
+private:
+	/// 비콘 포트 범위에서 비어 있는 포트로 비콘 소켓을 연다.
+	bool OpenBeacon();
+
+	/// 비콘 소켓을 닫는다.
+	void CloseBeacon();
+
+	/// 도착한 탐색 요청에 호스팅 중인 세션으로 응답한다.
+	void ServeBeacon();
+
+	/// 광고할 게임 접속 포트를 반환한다.
+	int32 ResolveGamePort() const;
+
+	/// 탐색할 주소:포트 목록을 샤드로 나눈다.
+	void BuildShards();
+
+	/// 동시 작업 수 안에서 탐색 작업을 시작한다.
+	void LaunchShards();
+
+	/// 도착한 응답을 결과에 추가하고, 모든 작업이 끝났으면 검색을 완료한다.
+	void DrainDiscovery();
+
+	/// 진행 중인 탐색을 끝낸다.
+	void StopDiscovery();
+
+	/// 완료 대리자를 다음 틱에 호출한다.
+	void Defer( TFunction< void() >&& completion );
+
+	/// 코어 티커에서 비콘과 탐색을 처리한다.
+	bool Tick( float deltaTime );
+};
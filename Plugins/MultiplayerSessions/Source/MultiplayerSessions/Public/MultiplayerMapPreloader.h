@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+
+
+class UPackage;
+class UWorld;
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 이동할 맵 패키지를 미리 비동기 로드해 두는 로더
+/// 로드된 패키지는 해당 맵으로 이동이 끝날 때까지 GC 되지 않도록 붙잡아 둔다.
+/// 비동기 로드 완료는 로더가 사라진 후에도 올 수 있으므로 항상 TSharedPtr 로 만들어 쓴다.
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerMapPreloader : public FGCObject, public TSharedFromThis< FMultiplayerMapPreloader >
+{
+private:
+	/// 미리 로드 중이거나 로드된 맵 패키지 ( 로드 중이면 nullptr )
+	TMap< FName, TObjectPtr< UPackage > > m_Packages;
+
+	/// 맵 로드 완료 대리자 핸들
+	FDelegateHandle m_PostLoadMapHandle;
+
+
+public:
+	/// 생성자
+	FMultiplayerMapPreloader();
+
+	/// 소멸자
+	virtual ~FMultiplayerMapPreloader();
+
+	/// 맵 패키지를 비동기로 미리 로드한다. 경로 뒤의 travel 옵션( ?listen 등 )은 무시한다.
+	void Preload( const FString& mapPath );
+
+	/// 맵 패키지가 로드되어 있는지 여부
+	bool IsLoaded( const FString& mapPath ) const;
+
+	/// 붙잡아 둔 패키지를 모두 놓는다.
+	void Reset();
+
+	/// travel URL 에서 맵 패키지 이름을 얻는다. 유효하지 않으면 NAME_None
+	static FName GetMapPackageName( const FString& mapPath );
+
+
+public:
+	/// FGCObject
+	virtual void AddReferencedObjects( FReferenceCollector& collector ) override;
+	virtual FString GetReferencerName() const override;
+
+
+private:
+	/// 패키지 비동기 로드가 완료되었을 때 처리한다.
+	void OnPackageLoaded( const FName& packageName, UPackage* loadedPackage, EAsyncLoadingResult::Type result );
+
+	/// 맵 로드가 완료되었을 때 처리한다.
+	void OnPostLoadMap( UWorld* loadedWorld );
+};
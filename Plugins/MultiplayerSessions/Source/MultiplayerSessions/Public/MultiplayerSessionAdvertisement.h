@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MultiplayerSessionQuery.h"
+
+
+class FOnlineSessionSettings;
+class FOnlineSearchSettings;
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 매치 타입 ( 광고에는 정수로 들어간다. 기존 값의 의미를 바꾸면 SchemaVersion 을 올린다 )
+/// NumKnown 이후 값은 이름이 MatchType_<값> 인 사용자 정의 매치 타입이다.
+////////////////////////////////////////////////////////////////////////////
+enum class EMultiplayerMatchType : uint8
+{
+	None = 0,
+	FreeForAll,
+	TeamDeathMatch,
+	CaptureTheFlag,
+
+	NumKnown
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 광고 스키마
+/// 검색에 필요한 필드를 int64 하나로 묶어 광고한다. 문자열 키 / 값 대신 정수 하나만 핑 응답에 실리고,
+/// 검색하는 쪽은 문자열 파싱 없이 비트 연산과 정수 비교로 필터링한다.
+///
+/// 비트 배치 ( 하위 비트부터 )
+///   [  0 ..  3 ] 스키마 버전
+///   [  4 .. 11 ] 매치 타입
+///   [ 12 .. 19 ] 지역
+///   [ 20 .. 35 ] 빌드
+///   [ 36 .. 43 ] 실력 구간
+///   [ 44 .. 51 ] 빈 슬롯 수
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerSessionAdvertisement
+{
+	/// 스키마 버전 ( 버전이 다른 광고는 읽지 않는다 )
+	static constexpr uint8 SchemaVersion{ 1 };
+
+	/// 묶은 광고 세팅 키 ( 핑 응답에 포함 )
+	static const FName Key;
+
+	/// 백엔드 쿼리 필터용 세팅 키 ( 핑 응답에는 포함하지 않는다 )
+	static const FName MatchTypeKey;
+	static const FName RegionKey;
+	static const FName BuildKey;
+
+	/// 매치 타입
+	EMultiplayerMatchType MatchType{ EMultiplayerMatchType::None };
+
+	/// 지역
+	uint8 Region{ 0 };
+
+	/// 빌드 ( 세션 BuildUniqueId 의 하위 16 비트 )
+	uint16 BuildId{ 0 };
+
+	/// 실력 구간
+	uint8 SkillBand{ 0 };
+
+	/// 빈 슬롯 수 ( 255 이상은 255 )
+	uint8 OpenSlots{ 0 };
+
+
+	/// 광고를 int64 하나로 묶는다.
+	int64 Encode() const;
+
+	/// 묶은 광고를 푼다. 스키마 버전이 다르면 false
+	static bool Decode( int64 packed, FMultiplayerSessionAdvertisement& outAdvertisement );
+
+	/// 세션 설정에 광고를 쓴다.
+	void Write( FOnlineSessionSettings& settings ) const;
+
+	/// 세션 설정에서 광고를 읽는다. 광고가 없거나 스키마 버전이 다르면 false
+	static bool Read( const FOnlineSessionSettings& settings, FMultiplayerSessionAdvertisement& outAdvertisement );
+
+	/// 백엔드가 걸러서 응답하도록 쿼리 키의 조건을 검색 쿼리에 추가한다. ( 매치 타입, 지역, 빌드, 최소 빈 슬롯 )
+	static void AddQueryFilters( FOnlineSearchSettings& querySettings, const FMultiplayerSessionQueryKey& queryKey );
+
+	/// 세션이 AddQueryFilters 로 추가한 조건을 만족하는지 여부 ( 필터를 지원하지 않는 백엔드의 결과는 직접 거른다 )
+	static bool MatchesQuery( const FOnlineSessionSettings& settings, int32 numOpenSlots, const FOnlineSearchSettings& querySettings );
+
+	/// 매치 타입 이름을 값으로 바꾼다. 모르는 이름이면 None
+	static EMultiplayerMatchType ParseMatchType( FName matchTypeName );
+
+	/// 매치 타입 값을 이름으로 바꾼다. None 이면 NAME_None
+	static FName GetMatchTypeName( EMultiplayerMatchType matchType );
+};
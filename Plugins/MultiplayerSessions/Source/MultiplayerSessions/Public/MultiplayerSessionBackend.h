@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "OnlineDelegateMacros.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 백엔드 인터페이스
+/// 서브시스템이 사용하는 IOnlineSession 의 일부만 같은 이름 / 같은 시그니처로 옮겨 둔 것이다.
+/// 온라인 서브시스템 대신 프로세스 내 가짜 백엔드로 교체해서 네트워크 없이 부하 테스트를 할 수 있다.
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API IMultiplayerSessionBackend
+{
+public:
+	virtual ~IMultiplayerSessionBackend() = default;
+
+	/// 완료 대리자 ( Add / Clear 동작은 IOnlineSession 과 같다 )
+	DEFINE_ONLINE_DELEGATE_TWO_PARAM( OnCreateSessionComplete, FName, bool );
+	DEFINE_ONLINE_DELEGATE_TWO_PARAM( OnStartSessionComplete, FName, bool );
+	DEFINE_ONLINE_DELEGATE_TWO_PARAM( OnUpdateSessionComplete, FName, bool );
+	DEFINE_ONLINE_DELEGATE_TWO_PARAM( OnDestroySessionComplete, FName, bool );
+	DEFINE_ONLINE_DELEGATE_ONE_PARAM( OnFindSessionsComplete, bool );
+	DEFINE_ONLINE_DELEGATE_TWO_PARAM( OnJoinSessionComplete, FName, EOnJoinSessionCompleteResult::Type );
+
+public:
+	/// 세션을 생성한다.
+	virtual bool CreateSession( const FUniqueNetId& hostingPlayerId, FName sessionName, const FOnlineSessionSettings& newSessionSettings ) = 0;
+
+	/// 로컬 플레이어 번호로 세션을 생성한다. ( 데디케이티드 서버는 플레이어 없이 0 을 넘긴다 )
+	virtual bool CreateSession( int32 hostingPlayerNum, FName sessionName, const FOnlineSessionSettings& newSessionSettings ) = 0;
+
+	/// 세션을 시작한다.
+	virtual bool StartSession( FName sessionName ) = 0;
+
+	/// 세션 설정을 갱신한다.
+	virtual bool UpdateSession( FName sessionName, FOnlineSessionSettings& updatedSessionSettings ) = 0;
+
+	/// 세션을 파괴한다.
+	virtual bool DestroySession( FName sessionName ) = 0;
+
+	/// 세션을 찾는다. 결과는 searchSettings->SearchResults 에 도착하는 대로 추가된다.
+	virtual bool FindSessions( const FUniqueNetId& searchingPlayerId, const TSharedRef< FOnlineSessionSearch >& searchSettings ) = 0;
+
+	/// 진행 중인 세션 찾기를 취소한다.
+	virtual bool CancelFindSessions() = 0;
+
+	/// 세션에 참가한다.
+	virtual bool JoinSession( const FUniqueNetId& localPlayerId, FName sessionName, const FOnlineSessionSearchResult& desiredSession ) = 0;
+
+	/// 이름으로 세션을 찾는다. 없으면 nullptr
+	virtual FNamedOnlineSession* GetNamedSession( FName sessionName ) = 0;
+
+	/// 참가한 세션의 접속 주소를 얻는다.
+	virtual bool GetResolvedConnectString( FName sessionName, FString& connectInfo ) = 0;
+
+	/// 검색 결과의 접속 주소를 얻는다. ( 참가 전에 후보의 핑을 잴 때 사용한다 )
+	virtual bool GetResolvedConnectString( const FOnlineSessionSearchResult& searchResult, FName portType, FString& connectInfo ) = 0;
+
+	/// LAN 세션을 사용하는 백엔드인지 여부
+	virtual bool IsLAN() const = 0;
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 온라인 서브시스템 세션 백엔드 ( IOnlineSession 으로 그대로 전달한다 )
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerOnlineSessionBackend : public IMultiplayerSessionBackend
+{
+private:
+	/// 온라인 세션 인터페이스
+	IOnlineSessionPtr m_Session;
+
+	/// LAN 세션 여부 ( NULL 서브시스템 )
+	bool m_IsLAN{ false };
+
+
+public:
+	/// 기본 온라인 서브시스템으로 백엔드를 만든다. 세션 인터페이스가 없으면 nullptr
+	static TSharedPtr< IMultiplayerSessionBackend > Create();
+
+	/// 생성자
+	FMultiplayerOnlineSessionBackend( IOnlineSessionPtr session, bool bIsLAN );
+
+
+public:
+	/// 대리자는 온라인 세션 인터페이스에 직접 등록한다.
+	virtual FDelegateHandle AddOnCreateSessionCompleteDelegate_Handle( const FOnCreateSessionCompleteDelegate& delegate ) override;
+	virtual void ClearOnCreateSessionCompleteDelegate_Handle( FDelegateHandle& handle ) override;
+	virtual FDelegateHandle AddOnStartSessionCompleteDelegate_Handle( const FOnStartSessionCompleteDelegate& delegate ) override;
+	virtual void ClearOnStartSessionCompleteDelegate_Handle( FDelegateHandle& handle ) override;
+	virtual FDelegateHandle AddOnUpdateSessionCompleteDelegate_Handle( const FOnUpdateSessionCompleteDelegate& delegate ) override;
+	virtual void ClearOnUpdateSessionCompleteDelegate_Handle( FDelegateHandle& handle ) override;
+	virtual FDelegateHandle AddOnDestroySessionCompleteDelegate_Handle( const FOnDestroySessionCompleteDelegate& delegate ) override;
+	virtual void ClearOnDestroySessionCompleteDelegate_Handle( FDelegateHandle& handle ) override;
+	virtual FDelegateHandle AddOnFindSessionsCompleteDelegate_Handle( const FOnFindSessionsCompleteDelegate& delegate ) override;
+	virtual void ClearOnFindSessionsCompleteDelegate_Handle( FDelegateHandle& handle ) override;
+	virtual FDelegateHandle AddOnJoinSessionCompleteDelegate_Handle( const FOnJoinSessionCompleteDelegate& delegate ) override;
+	virtual void ClearOnJoinSessionCompleteDelegate_Handle( FDelegateHandle& handle ) override;
+
+	virtual bool CreateSession( const FUniqueNetId& hostingPlayerId, FName sessionName, const FOnlineSessionSettings& newSessionSettings ) override;
+	virtual bool CreateSession( int32 hostingPlayerNum, FName sessionName, const FOnlineSessionSettings& newSessionSettings ) override;
+	virtual bool StartSession( FName sessionName ) override;
+	virtual bool UpdateSession( FName sessionName, FOnlineSessionSettings& updatedSessionSettings ) override;
+	virtual bool DestroySession( FName sessionName ) override;
+	virtual bool FindSessions( const FUniqueNetId& searchingPlayerId, const TSharedRef< FOnlineSessionSearch >& searchSettings ) override;
+	virtual bool CancelFindSessions() override;
+	virtual bool JoinSession( const FUniqueNetId& localPlayerId, FName sessionName, const FOnlineSessionSearchResult& desiredSession ) override;
+	virtual FNamedOnlineSession* GetNamedSession( FName sessionName ) override;
+	virtual bool GetResolvedConnectString( FName sessionName, FString& connectInfo ) override;
+	virtual bool GetResolvedConnectString( const FOnlineSessionSearchResult& searchResult, FName portType, FString& connectInfo ) override;
+	virtual bool IsLAN() const override;
+};
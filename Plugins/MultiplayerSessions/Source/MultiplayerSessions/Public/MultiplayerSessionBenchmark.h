@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/StrongObjectPtr.h"
+
+
+class FOnlineSessionSearchResult;
+class FMultiplayerFakeSessionBackend;
+class UMultiPlayerSessionsSubsystem;
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 벤치마크 설정
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerSessionBenchmarkConfig
+{
+	/// 합성 검색 결과 수
+	int32 NumResults{ 10000 };
+
+	/// 단계별 반복 횟수
+	int32 Iterations{ 20 };
+
+	/// 반복마다 조회할 횟수 ( FindCandidate )
+	int32 LookupsPerIteration{ 1000 };
+
+	/// 합성 MatchType 종류 수
+	int32 NumMatchTypes{ 8 };
+
+	/// 난수 시드 ( 같은 시드면 같은 결과를 만든다 )
+	int32 Seed{ 1234 };
+
+	/// 서브시스템으로 실행할 작업 묶음 수 ( 생성 → 파괴, 찾기, 참가 → 파괴 )
+	int32 NumOperations{ 100 };
+
+	/// 가짜 백엔드가 광고하는 세션 수
+	int32 NumAdvertisedSessions{ 1000 };
+
+	/// 가짜 백엔드 지연 시간 ( ms ), 0 이면 이벤트를 바로 처리 ( Flush ) 해서 서브시스템 처리 비용만 잰다.
+	float BackendLatencyMs{ 0.f };
+
+	/// 작업 하나가 끝나기를 기다리는 최대 시간 ( 초 )
+	float OperationTimeout{ 10.f };
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 작업 / 검색 결과 처리 벤치마크
+/// 네트워크 없이 가짜 백엔드로 서브시스템의 생성 / 찾기 / 참가 / 파괴 처리량과 지연 시간을 재고,
+/// 합성 검색 결과로 인덱싱 / 조회 / 순위 계산 비용과 결과당 메모리를 측정한다.
+/// 콘솔 명령 : MultiplayerSessions.Benchmark [numResults] [iterations] [path] [Ops=] [LatencyMs=]
+/// 헤드리스 : UnrealEditor-Cmd <project> -ExecCmds="MultiplayerSessions.Benchmark, Quit" -NullRHI -Unattended
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerSessionBenchmark
+{
+public:
+	/// 벤치마크를 실행하고 결과를 JSON 으로 반환한다.
+	static FString Run( const FMultiplayerSessionBenchmarkConfig& config );
+
+	/// 게임 인스턴스 / 로컬 플레이어 없이 가짜 백엔드를 쓰는 서브시스템을 만든다. ( QoS 측정과 검색 캐시는 끈다 )
+	static TStrongObjectPtr< UMultiPlayerSessionsSubsystem > MakeHeadlessSubsystem( const TSharedRef< FMultiplayerFakeSessionBackend >& backend );
+
+	/// 서브시스템의 작업이 모두 끝날 때까지 가짜 백엔드 이벤트를 처리한다. timeout 안에 끝나지 않으면 false
+	/// bRealTime 이면 지연 시간이 지난 이벤트만 처리 ( Pump ) 하고, 아니면 바로 처리 ( Flush ) 한다.
+	static bool WaitUntilIdle( UMultiPlayerSessionsSubsystem& subsystem, FMultiplayerFakeSessionBackend& backend, bool bRealTime, double timeout );
+
+	/// 합성 검색 결과를 만든다. MatchType 은 matchTypes 중에서 고르고, 지역은 numRegions 개에 고르게 나눈다.
+	static void MakeSyntheticResults( int32 numResults, const TArray< FString >& matchTypes, int32 seed, TArray< FOnlineSessionSearchResult >& outResults, int32 numRegions = 1 );
+
+	/// 검색 결과가 차지하는 대략적인 힙 메모리 ( byte )
+	static SIZE_T GetAllocatedSize( const TArray< FOnlineSessionSearchResult >& searchResults );
+};
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+class FOnlineSessionSearchResult;
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 검색 결과를 MatchType / 빈 슬롯 수 기준으로 버킷팅한 인덱스
+/// 검색 완료 시 한 번 빌드하고, 참가 후보는 문자열 비교 없이 FName 으로 조회한다.
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerSessionIndex
+{
+public:
+	/// MatchType 문자열 세션 세팅 키 ( 이전 스키마, 그리고 광고 값이 없는 사용자 정의 매치 타입 )
+	static const FName MatchTypeKey;
+
+	/// 호스트 세션 이름 세팅 키 ( 한 프로세스가 여러 세션을 호스팅할 때 접속 옵션으로 방을 고른다 )
+	static const FName HostSessionKey;
+
+	/// 호스트의 QoS 에코 포트 세팅 키 ( 참가 전 핑 측정에 쓴다 )
+	static const FName QosPortKey;
+
+	/// 버킷팅할 최대 빈 슬롯 수 ( 이보다 큰 값은 마지막 버킷에 모인다 )
+	static constexpr int32 MaxSlotBucket{ 64 };
+
+private:
+	/// MatchType 하나에 대한 버킷
+	struct FMatchTypeBucket
+	{
+		/// 빈 슬롯 수 별 검색 결과 인덱스 ( 0 번은 가득 찬 세션 )
+		TArray< TArray< int32 > > BySlots;
+
+		/// 검색 순서상 첫번째로 참가 가능한 세션 인덱스
+		int32 FirstJoinable{ INDEX_NONE };
+	};
+
+	/// MatchType 별 버킷
+	TMap< FName, FMatchTypeBucket > m_Buckets;
+
+	/// 인덱싱된 검색 결과 수
+	int32 m_NumResults{ 0 };
+
+
+public:
+	/// 검색 결과로 인덱스를 빌드한다.
+	void Build( const TArray< FOnlineSessionSearchResult >& searchResults );
+
+	/// 검색 결과 하나를 인덱스에 추가한다. index 는 검색 결과 배열상의 위치
+	void Add( const FOnlineSessionSearchResult& searchResult, int32 index, FString& scratch );
+
+	/// 인덱스를 비운다.
+	void Reset();
+
+	/// 조건에 맞는 참가 후보의 검색 결과 인덱스를 반환한다. 없으면 INDEX_NONE
+	int32 FindCandidate( FName matchType, int32 minOpenSlots = 1 ) const;
+
+	/// 빈 슬롯이 minOpenSlots 이상인 검색 결과 인덱스를 모두 모은다.
+	void GatherCandidates( FName matchType, int32 minOpenSlots, TArray< int32 >& outIndices ) const;
+
+	/// 빈 슬롯 수가 정확히 일치하는 검색 결과 인덱스 목록을 반환한다.
+	const TArray< int32 >* FindBySlots( FName matchType, int32 openSlots ) const;
+
+	/// 인덱싱된 검색 결과 수를 반환한다.
+	int32 Num() const;
+
+	/// MatchType 을 FName 으로 읽는다. 묶은 광고에 매치 타입이 있으면 문자열 없이 읽고, 없으면 MatchType 문자열을 읽는다.
+	/// scratch 는 호출자가 재사용하는 버퍼
+	static FName ReadMatchType( const FOnlineSessionSearchResult& searchResult, FString& scratch );
+
+	/// 검색 결과에서 참가 ( 세션 정보 ), 순위 ( 핑 / 빈 슬롯 ) 와 인덱싱 ( 묶은 광고 / 호스트 세션 이름 ) 에 쓰지 않는 세팅을 버린다.
+	/// bKeepAdvertisement 가 false 이면 광고도 버린다. ( 검색 조건에 맞지 않아 인덱싱하지 않은 결과 )
+	static void Compact( FOnlineSessionSearchResult& searchResult, bool bKeepAdvertisement );
+};
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Optional.h"
+#include "OnlineSessionSettings.h"
+
+class ULocalPlayer;
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 작업 종류
+////////////////////////////////////////////////////////////////////////////
+enum class EMultiplayerSessionOp : uint8
+{
+	None,
+	Create,
+	Find,
+	Join,
+	Destroy,
+	Start,
+	Update,
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 백엔드 호출 상태
+////////////////////////////////////////////////////////////////////////////
+enum class EMultiplayerSessionState : uint8
+{
+	Idle,
+	Creating,
+	Updating,
+	Finding,
+	Joining,
+	Destroying,
+	Starting,
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 작업 대상 ( 세션 이름과 요청하는 플레이어 )
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerSessionTarget
+{
+	/// 세션 이름 ( 파티 세션과 게임 세션처럼 이름별로 따로 관리된다 )
+	FName SessionName{ NAME_GameSession };
+
+	/// 요청하는 플레이어 ( 없으면 첫 번째 로컬 플레이어 )
+	FUniqueNetIdPtr PlayerId;
+
+	FMultiplayerSessionTarget() = default;
+
+	explicit FMultiplayerSessionTarget( FName sessionName, FUniqueNetIdPtr playerId = nullptr )
+		: SessionName( sessionName ), PlayerId( MoveTemp( playerId ) )
+	{}
+
+	/// 로컬 플레이어의 대상을 만든다.
+	static FMultiplayerSessionTarget ForLocalPlayer( const ULocalPlayer* localPlayer, FName sessionName = NAME_GameSession );
+
+	/// 같은 플레이어인지 여부 ( 둘 다 없으면 첫 번째 로컬 플레이어로 같다 )
+	bool IsSamePlayer( const FMultiplayerSessionTarget& other ) const
+	{
+		if ( PlayerId.IsValid() != other.PlayerId.IsValid() )
+			return false;
+
+		return !PlayerId.IsValid() || *PlayerId == *other.PlayerId;
+	}
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 대기열에 쌓이는 세션 작업 요청
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerSessionRequest
+{
+	/// 작업 종류
+	EMultiplayerSessionOp Op{ EMultiplayerSessionOp::None };
+
+	/// 작업 대상 ( Find 는 세션 이름을 쓰지 않는다 )
+	FMultiplayerSessionTarget Target;
+
+	/// Create : 연결가능한 Connection 수
+	int32 NumPublicConnections{ 0 };
+
+	/// Create : MatchType
+	FString MatchType;
+
+	/// Find : 최대 검색 결과 수
+	int32 MaxSearchResults{ 0 };
+
+	/// Find / Join : 찾을 MatchType
+	FName SearchMatchType{ NAME_None };
+
+	/// Find : 스트리밍 폴링 간격 ( 0 이면 완료 시 한 번에 전달 )
+	float PollInterval{ 0.f };
+
+	/// Join : 참가할 세션 ( 없으면 순위 후보로 차례로 참가 )
+	TOptional< FOnlineSessionSearchResult > SessionResult;
+
+	/// Join : 최대 참가 시도 수
+	int32 MaxAttempts{ 1 };
+
+	/// Join : 참가 시도당 제한 시간 ( 초 )
+	float AttemptTimeout{ 0.f };
+
+	/// Update : 광고할 빈 슬롯 수
+	int32 NumOpenSlots{ 0 };
+
+	/// 같은 결과를 내는 요청이라 하나로 합칠 수 있는지 여부
+	bool IsDuplicateOf( const FMultiplayerSessionRequest& other ) const
+	{
+		if ( Op != other.Op || !Target.IsSamePlayer( other.Target ) )
+			return false;
+
+		switch ( Op )
+		{
+		case EMultiplayerSessionOp::Create:
+			return NumPublicConnections == other.NumPublicConnections && MatchType == other.MatchType;
+
+		case EMultiplayerSessionOp::Find:
+			return SearchMatchType == other.SearchMatchType && MaxSearchResults <= other.MaxSearchResults && PollInterval == other.PollInterval;
+
+		case EMultiplayerSessionOp::Join:
+			return IsSameSessionResult( other ) && SearchMatchType == other.SearchMatchType && MaxAttempts == other.MaxAttempts;
+
+		case EMultiplayerSessionOp::Update:
+			return NumOpenSlots == other.NumOpenSlots;
+
+		default:
+			// 파괴 / 시작은 진행 중인 작업이 하나만 있으면 된다.
+			return true;
+		}
+	}
+
+	/// 참가할 세션이 같은지 여부 ( 둘 다 없으면 순위 후보로 참가하므로 같다 )
+	bool IsSameSessionResult( const FMultiplayerSessionRequest& other ) const
+	{
+		if ( SessionResult.IsSet() != other.SessionResult.IsSet() )
+			return false;
+
+		return !SessionResult.IsSet() || SessionResult->GetSessionIdStr() == other.SessionResult->GetSessionIdStr();
+	}
+};
@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "HAL/Runnable.h"
+#include <atomic>
+
+
+class FSocket;
+class FRunnableThread;
+struct FMultiplayerQosProbeState;
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 참가 후보 QoS 측정 설정
+/// DefaultGame.ini 의 [MultiplayerSessions.Qos] 를 읽고, 명령줄 -QosEchoPort= 로 응답 포트를 고정할 수 있다.
+/// 호스트는 게임 접속 포트 + EchoPortOffset 에서 에코 요청에 응답하고, 응답 포트를 세션 설정에 광고한다.
+/// 접속 주소가 IP 인 백엔드 ( LAN, Null ) 에서만 측정할 수 있으므로 기본값은 꺼져 있다. ( Steam 주소 steam.<id>:port 는 측정 불가 )
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerQosConfig
+{
+	/// 설정 섹션 이름
+	static const TCHAR* ConfigSection;
+
+	/// 참가 전에 후보의 핑을 측정할지 여부
+	bool bEnabled{ false };
+
+	/// 호스팅하는 동안 에코 요청에 응답할지 여부
+	bool bRunEchoResponder{ false };
+
+	/// 측정할 최대 후보 수
+	int32 MaxCandidates{ 8 };
+
+	/// 동시에 측정하는 후보 수
+	int32 MaxInFlight{ 4 };
+
+	/// 후보당 보내는 에코 요청 수
+	int32 NumProbes{ 4 };
+
+	/// 에코 요청 하나의 제한 시간 ( 초 )
+	float ProbeTimeout{ 0.2f };
+
+	/// 게임 포트에서 에코 포트까지의 간격
+	int32 EchoPortOffset{ 1000 };
+
+	/// 에코 응답 포트 ( 0 이면 게임 접속 포트 + EchoPortOffset )
+	int32 EchoPort{ 0 };
+
+	/// 핑에 더하는 지터 가중치
+	float JitterWeight{ 1.f };
+
+
+	/// 설정 파일과 명령줄에서 설정을 읽는다.
+	static FMultiplayerQosConfig Load();
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 측정 대상
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerQosTarget
+{
+	/// 검색 결과 배열상의 위치
+	int32 ResultIndex{ INDEX_NONE };
+
+	/// 호스트 주소
+	FString Host;
+
+	/// 에코 포트
+	int32 Port{ 0 };
+
+
+	/// 접속 주소 ( 주소:포트 ) 로 대상을 만든다. 주소를 해석할 수 없으면 false
+	static bool Parse( int32 resultIndex, const FString& connectString, int32 portOffset, FMultiplayerQosTarget& outTarget );
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 측정 결과
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerQosResult
+{
+	/// 검색 결과 배열상의 위치
+	int32 ResultIndex{ INDEX_NONE };
+
+	/// 보낸 / 받은 에코 수
+	int32 NumSent{ 0 };
+	int32 NumReceived{ 0 };
+
+	/// 왕복 시간 중앙값 ( ms )
+	float RttMs{ 0.f };
+
+	/// 연속한 왕복 시간 차이의 평균 ( ms )
+	float JitterMs{ 0.f };
+
+
+	/// 응답을 하나라도 받았는지 여부
+	bool IsReachable() const { return NumReceived > 0; }
+};
+
+
+DECLARE_DELEGATE_OneParam( FMultiplayerOnQosComplete, const TArray< FMultiplayerQosResult >& );
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 참가 후보 QoS 측정
+/// 후보마다 워커 작업에서 UDP 에코를 차례로 보내 왕복 시간과 지터를 잰다. 동시에 측정하는 후보 수는 MaxInFlight 로 제한한다.
+/// 결과는 코어 티커에서 모아서 모든 후보가 끝나면 한 번에 전달한다.
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerQosProber
+{
+private:
+	/// 설정
+	FMultiplayerQosConfig m_Config;
+
+	/// 진행 중인 측정 ( 워커 작업과 공유한다 )
+	TSharedPtr< FMultiplayerQosProbeState, ESPMode::ThreadSafe > m_State;
+
+	/// 측정 대상
+	TArray< FMultiplayerQosTarget > m_Targets;
+
+	/// 다음에 시작할 대상 ( 시작한 작업 수 )
+	int32 m_NextTarget{ 0 };
+
+	/// 모은 결과
+	TArray< FMultiplayerQosResult > m_Results;
+
+	/// 완료 대리자
+	FMultiplayerOnQosComplete m_OnComplete;
+
+	/// 결과 처리 티커 핸들
+	FTSTicker::FDelegateHandle m_TickerHandle;
+
+
+public:
+	/// 생성자
+	explicit FMultiplayerQosProber( const FMultiplayerQosConfig& config );
+
+	/// 소멸자
+	~FMultiplayerQosProber();
+
+	/// 측정을 시작한다. 이미 측정 중이거나 대상이 없으면 false
+	bool Start( TArray< FMultiplayerQosTarget >&& targets, FMultiplayerOnQosComplete&& onComplete );
+
+	/// 측정을 중단한다. 완료 대리자는 호출되지 않는다.
+	void Cancel();
+
+	/// 측정 중인지 여부
+	bool IsRunning() const;
+
+private:
+	/// 동시 측정 수 안에서 측정 작업을 시작한다.
+	void LaunchProbes();
+
+	/// 코어 티커에서 결과를 모은다.
+	bool Tick( float deltaTime );
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// QoS 에코 응답
+/// 전용 스레드에서 에코 요청을 받은 그대로 돌려보낸다. 게임 틱을 거치지 않으므로 프레임 시간이 왕복 시간에 섞이지 않는다.
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerQosEchoResponder : public FRunnable
+{
+private:
+	/// 에코 소켓
+	FSocket* m_Socket{ nullptr };
+
+	/// 응답 스레드
+	FRunnableThread* m_Thread{ nullptr };
+
+	/// 응답 포트
+	int32 m_Port{ 0 };
+
+	/// 중단 요청 여부
+	std::atomic< bool > m_bStopping{ false };
+
+
+public:
+	/// 소멸자
+	virtual ~FMultiplayerQosEchoResponder();
+
+	/// 포트를 열고 응답을 시작한다. 이미 응답 중이면 true
+	bool Start( int32 port );
+
+	/// 응답을 멈추고 포트를 닫는다.
+	void Shutdown();
+
+	/// 응답 포트를 반환한다. 응답 중이 아니면 0
+	int32 GetPort() const;
+
+
+public:
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+};
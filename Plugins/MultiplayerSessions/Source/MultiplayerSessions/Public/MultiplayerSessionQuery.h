@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 검색 쿼리 키 ( 같은 키의 검색 결과는 캐시에서 재사용한다 )
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerSessionQueryKey
+{
+	/// LAN 검색 여부
+	bool bIsLanQuery{ false };
+
+	/// Presence 세션 검색 여부
+	bool bSearchPresence{ true };
+
+	/// 찾을 MatchType ( NAME_None 이면 모든 MatchType )
+	FName MatchType{ NAME_None };
+
+	/// 찾을 지역 ( INDEX_NONE 이면 모든 지역 )
+	int32 Region{ INDEX_NONE };
+
+	/// 찾을 빌드 ( INDEX_NONE 이면 모든 빌드 )
+	int32 BuildId{ INDEX_NONE };
+
+	/// 최소 빈 슬롯 수 ( 0 이면 가득 찬 세션도 받는다 )
+	int32 MinOpenSlots{ 0 };
+
+	bool operator==( const FMultiplayerSessionQueryKey& other ) const
+	{
+		return bIsLanQuery == other.bIsLanQuery
+			&& bSearchPresence == other.bSearchPresence
+			&& MatchType == other.MatchType
+			&& Region == other.Region
+			&& BuildId == other.BuildId
+			&& MinOpenSlots == other.MinOpenSlots;
+	}
+
+	bool operator!=( const FMultiplayerSessionQueryKey& other ) const
+	{
+		return !( *this == other );
+	}
+
+	friend uint32 GetTypeHash( const FMultiplayerSessionQueryKey& key )
+	{
+		uint32 hash = HashCombine( GetTypeHash( key.MatchType ), ( key.bIsLanQuery ? 1u : 0u ) | ( key.bSearchPresence ? 2u : 0u ) );
+		hash = HashCombine( hash, GetTypeHash( key.Region ) );
+		hash = HashCombine( hash, GetTypeHash( key.BuildId ) );
+		return HashCombine( hash, GetTypeHash( key.MinOpenSlots ) );
+	}
+};
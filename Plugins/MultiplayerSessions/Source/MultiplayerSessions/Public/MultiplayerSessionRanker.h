@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+class FOnlineSessionSearchResult;
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 참가 후보 세션
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerSessionCandidate
+{
+	/// 검색 결과 배열상의 위치
+	int32 ResultIndex{ INDEX_NONE };
+
+	/// 후보 점수 ( 낮을수록 좋은 후보 )
+	float Score{ 0.f };
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 참가 후보 점수 계산 인터페이스
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API IMultiplayerSessionScorer
+{
+public:
+	virtual ~IMultiplayerSessionScorer() = default;
+
+	/// 후보 점수를 계산한다. ( 낮을수록 좋은 후보 ) 참가 대상이 아니면 false 를 반환한다.
+	virtual bool Score( const FOnlineSessionSearchResult& searchResult, float& outScore ) const = 0;
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 핑과 빈 슬롯 수를 조합하는 기본 점수 계산
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerPingScorer : public IMultiplayerSessionScorer
+{
+public:
+	/// 핑을 알 수 없는 세션에 적용할 핑 ( ms )
+	int32 UnknownPingMs{ 250 };
+
+	/// 허용하는 최대 핑 ( ms ), 0 이면 제한 없음
+	int32 MaxPingMs{ 0 };
+
+	/// 빈 슬롯 하나당 감점되는 핑 ( ms )
+	float OpenSlotBonusMs{ 5.f };
+
+	/// 빈 슬롯 보너스를 적용할 최대 슬롯 수
+	int32 MaxOpenSlotBonus{ 4 };
+
+public:
+	/// 후보 점수를 계산한다. ( 낮을수록 좋은 후보 ) 참가 대상이 아니면 false 를 반환한다.
+	virtual bool Score( const FOnlineSessionSearchResult& searchResult, float& outScore ) const override;
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 점수 기준 상위 후보 선택
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerSessionRanker
+{
+public:
+	/// 후보 인덱스 중 점수가 낮은 순으로 최대 maxCandidates 개를 선택한다.
+	/// 전체 정렬 대신 크기 maxCandidates 의 힙을 유지하므로 O( n log k ) 이다.
+	static void SelectTopCandidates(
+		const TArray< FOnlineSessionSearchResult >& searchResults,
+		const TArray< int32 >& candidateIndices,
+		const IMultiplayerSessionScorer& scorer,
+		int32 maxCandidates,
+		TArray< FMultiplayerSessionCandidate >& outCandidates );
+};
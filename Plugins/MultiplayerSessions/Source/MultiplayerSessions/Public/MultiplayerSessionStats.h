@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MultiplayerSessionOperation.h"
+#include <atomic>
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 지연 시간 히스토그램 요약
+////////////////////////////////////////////////////////////////////////////
+struct MULTIPLAYERSESSIONS_API FMultiplayerLatencySnapshot
+{
+	/// 기록 수
+	uint64 Count{ 0 };
+
+	/// 평균 ( ms )
+	double MeanMs{ 0.0 };
+
+	/// 백분위 ( ms )
+	double P50Ms{ 0.0 };
+	double P95Ms{ 0.0 };
+	double P99Ms{ 0.0 };
+
+	/// 최대 ( ms )
+	double MaxMs{ 0.0 };
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 고정 버킷 지연 시간 히스토그램
+/// 2 의 거듭제곱 구간마다 8 개의 버킷을 두어 상대 오차를 12.5% 이내로 유지한다. ( 1us ~ 약 71 분 )
+/// 기록은 atomic 카운터만 증가시키므로 어느 스레드에서나 락 없이 호출할 수 있다.
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerLatencyHistogram
+{
+public:
+	/// 2 의 거듭제곱 구간당 버킷 수 ( 2^SubBucketBits )
+	static constexpr int32 SubBucketBits{ 3 };
+	static constexpr int32 NumSubBuckets{ 1 << SubBucketBits };
+
+	/// 전체 버킷 수 ( uint32 us 범위 )
+	static constexpr int32 NumBuckets{ ( 32 - SubBucketBits + 1 ) * NumSubBuckets };
+
+private:
+	/// 버킷별 기록 수
+	std::atomic< uint32 > m_Buckets[ NumBuckets ];
+
+	/// 전체 기록 수
+	std::atomic< uint64 > m_Count{ 0 };
+
+	/// 전체 합 ( us )
+	std::atomic< uint64 > m_SumUs{ 0 };
+
+	/// 최대 ( us )
+	std::atomic< uint32 > m_MaxUs{ 0 };
+
+
+public:
+	/// 생성자
+	FMultiplayerLatencyHistogram();
+
+	/// 지연 시간을 기록한다.
+	void Record( double seconds );
+
+	/// 기록을 모두 지운다.
+	void Reset();
+
+	/// 현재 기록을 요약한다.
+	FMultiplayerLatencySnapshot MakeSnapshot() const;
+
+	/// 값이 들어갈 버킷 인덱스를 반환한다.
+	static int32 GetBucketIndex( uint32 valueUs );
+
+	/// 버킷의 하한 ( us, 포함 ) 을 반환한다.
+	static uint64 GetBucketLowerBound( int32 bucketIndex );
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 세션 작업별 지연 시간 통계
+/// 콘솔 명령 : MultiplayerSessions.Latency.Dump / Reset / Export [csv|json] [path], stat MultiplayerSessions
+////////////////////////////////////////////////////////////////////////////
+class MULTIPLAYERSESSIONS_API FMultiplayerSessionStats
+{
+public:
+	/// 기록하는 작업 종류 수 ( None 제외 )
+	static constexpr int32 NumOps{ static_cast< int32 >( EMultiplayerSessionOp::Update ) };
+
+private:
+	/// 작업별 요청 → 완료 지연 시간
+	FMultiplayerLatencyHistogram m_Histograms[ NumOps ];
+
+
+public:
+	/// 프로세스 전역 통계를 반환한다.
+	static FMultiplayerSessionStats& Get();
+
+	/// 작업의 지연 시간을 기록한다.
+	void Record( EMultiplayerSessionOp op, double seconds );
+
+	/// 기록을 모두 지운다.
+	void Reset();
+
+	/// 작업의 지연 시간 요약을 반환한다.
+	FMultiplayerLatencySnapshot MakeSnapshot( EMultiplayerSessionOp op ) const;
+
+	/// 요약을 로그에 출력한다.
+	void Dump( FOutputDevice& output ) const;
+
+	/// 요약을 CSV 로 만든다.
+	FString ExportCsv() const;
+
+	/// 요약을 JSON 으로 만든다.
+	FString ExportJson() const;
+
+	/// 요약을 파일로 저장한다. path 가 비어 있으면 Saved/Profiling/MultiplayerSessions 아래에 저장한다.
+	bool SaveToFile( bool bJson, const FString& path, FString* outPath = nullptr ) const;
+
+	/// 작업 이름을 반환한다.
+	static const TCHAR* GetOpName( EMultiplayerSessionOp op );
+};
@@ -5,6 +5,9 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+/// 세션 로그 ( 헤드리스 서버에서는 로그가 유일한 출력이다 )
+MULTIPLAYERSESSIONS_API DECLARE_LOG_CATEGORY_EXTERN( LogMultiplayerSessions, Log, All );
+
 class FMultiplayerSessionsModule : public IModuleInterface
 {
 public:
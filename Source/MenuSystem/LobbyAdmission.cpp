@@ -0,0 +1,184 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LobbyAdmission.h"
+
+
+namespace LobbyAdmission
+{
+	/// 가득 찬 버킷을 정리하는 간격 ( 초 )
+	static constexpr double PruneInterval = 10.0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 토큰을 채우고 하나를 쓴다. 토큰이 없으면 false
+//////////////////////////////////////////////////////////////////////////
+bool FLobbyTokenBucket::TryConsume( double now, float rate, float burst )
+{
+	// 처음 본 버킷은 가득 찬 상태로 시작한다.
+	if ( LastRefillTime <= 0.0 )
+	{
+		Tokens = burst;
+	}
+	else
+	{
+		Tokens = FMath::Min( burst, Tokens + static_cast< float >( ( now - LastRefillTime ) * rate ) );
+	}
+
+	LastRefillTime = now;
+
+	if ( Tokens < 1.f )
+		return false;
+
+	Tokens -= 1.f;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 지금 토큰이 가득 차 있는지 여부
+//////////////////////////////////////////////////////////////////////////
+bool FLobbyTokenBucket::IsFull( double now, float rate, float burst ) const
+{
+	return Tokens + ( now - LastRefillTime ) * rate >= burst;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 같은 플레이어인지 여부
+//////////////////////////////////////////////////////////////////////////
+bool FLobbyAdmissionControl::FReservation::Matches( const FUniqueNetIdRepl& playerId, const FString& address ) const
+{
+	if ( PlayerId.IsValid() || playerId.IsValid() )
+		return PlayerId == playerId;
+
+	return Address == address;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 입장을 심사한다. 거절하면 false 와 함께 이유를 채운다.
+//////////////////////////////////////////////////////////////////////////
+bool FLobbyAdmissionControl::Admit( const FLobbyAdmissionConfig& config, const FString& address, const FUniqueNetIdRepl& playerId,
+									int32 numPlayers, int32 capacity, double now, FString& outReason )
+{
+	ExpireReservations( now );
+	PruneBuckets( config, now );
+
+	// 빈도 제한을 먼저 검사해서, 몰려드는 시도는 인원 계산 전에 싸게 거절한다.
+	if ( !m_AddressBuckets.FindOrAdd( address ).TryConsume( now, config.LoginRatePerAddress, config.LoginBurstPerAddress ) )
+	{
+		outReason = TEXT( "Too many join attempts from this address. Try again shortly." );
+		return false;
+	}
+
+	if ( playerId.IsValid()
+		&& !m_IdBuckets.FindOrAdd( playerId ).TryConsume( now, config.LoginRatePerId, config.LoginBurstPerId ) )
+	{
+		outReason = TEXT( "Too many join attempts. Try again shortly." );
+		return false;
+	}
+
+	// 이미 자리를 잡아둔 플레이어의 재시도는 예약 시간만 늘린다.
+	const double expireTime = now + config.ReservationTimeout;
+
+	FReservation* reservation = m_Reservations.FindByPredicate( [ &playerId, &address ]( const FReservation& each )
+	{
+		return each.Matches( playerId, address );
+	} );
+
+	if ( reservation )
+	{
+		reservation->ExpireTime = expireTime;
+		return true;
+	}
+
+	// 로그인 중인 플레이어의 자리까지 포함해서 인원을 센다.
+	if ( capacity > 0 && numPlayers + m_Reservations.Num() >= capacity )
+	{
+		outReason = TEXT( "Lobby is full." );
+		return false;
+	}
+
+	FReservation& newReservation = m_Reservations.AddDefaulted_GetRef();
+	newReservation.PlayerId	  = playerId;
+	newReservation.Address	  = address;
+	newReservation.ExpireTime = expireTime;
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 로그인이 끝난 플레이어의 예약을 푼다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyAdmissionControl::ConfirmLogin( const FUniqueNetIdRepl& playerId, const FString& address )
+{
+	const int32 index = m_Reservations.IndexOfByPredicate( [ &playerId, &address ]( const FReservation& each )
+	{
+		return each.Matches( playerId, address );
+	} );
+
+	if ( INDEX_NONE != index )
+	{
+		m_Reservations.RemoveAtSwap( index, 1, false );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 아직 로그인 중인 플레이어 수
+//////////////////////////////////////////////////////////////////////////
+int32 FLobbyAdmissionControl::GetNumReservations( double now )
+{
+	ExpireReservations( now );
+
+	return m_Reservations.Num();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 모든 상태를 비운다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyAdmissionControl::Reset()
+{
+	m_AddressBuckets.Reset();
+	m_IdBuckets.Reset();
+	m_Reservations.Reset();
+	m_NextPruneTime = 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 시간이 지난 예약을 푼다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyAdmissionControl::ExpireReservations( double now )
+{
+	// 접속 도중 끊긴 플레이어의 자리는 로그아웃이 오지 않으므로 시간으로 푼다.
+	m_Reservations.RemoveAllSwap( [ now ]( const FReservation& each )
+	{
+		return each.ExpireTime <= now;
+	}, false );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 가득 찬 버킷을 정리한다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyAdmissionControl::PruneBuckets( const FLobbyAdmissionConfig& config, double now )
+{
+	if ( now < m_NextPruneTime )
+		return;
+
+	m_NextPruneTime = now + LobbyAdmission::PruneInterval;
+
+	// 가득 찬 버킷은 처음 본 버킷과 같으므로 지워도 결과가 바뀌지 않는다.
+	for ( auto it = m_AddressBuckets.CreateIterator(); it; ++it )
+	{
+		if ( it.Value().IsFull( now, config.LoginRatePerAddress, config.LoginBurstPerAddress ) )
+		{
+			it.RemoveCurrent();
+		}
+	}
+
+	for ( auto it = m_IdBuckets.CreateIterator(); it; ++it )
+	{
+		if ( it.Value().IsFull( now, config.LoginRatePerId, config.LoginBurstPerId ) )
+		{
+			it.RemoveCurrent();
+		}
+	}
+}
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/OnlineReplStructs.h"
+#include "LobbyAdmission.generated.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 로비 입장 제한 설정
+////////////////////////////////////////////////////////////////////////////
+USTRUCT()
+struct FLobbyAdmissionConfig
+{
+	GENERATED_BODY()
+
+	/// 주소별 초당 입장 시도 수
+	UPROPERTY( EditDefaultsOnly, Category = Admission, meta = ( ClampMin = "0.0" ) )
+		float LoginRatePerAddress{ 1.f };
+
+	/// 주소별로 한 번에 허용하는 입장 시도 수 ( 같은 주소 뒤의 여러 플레이어 )
+	UPROPERTY( EditDefaultsOnly, Category = Admission, meta = ( ClampMin = "1.0" ) )
+		float LoginBurstPerAddress{ 4.f };
+
+	/// 고유 ID 별 초당 입장 시도 수
+	UPROPERTY( EditDefaultsOnly, Category = Admission, meta = ( ClampMin = "0.0" ) )
+		float LoginRatePerId{ 0.2f };
+
+	/// 고유 ID 별로 한 번에 허용하는 입장 시도 수
+	UPROPERTY( EditDefaultsOnly, Category = Admission, meta = ( ClampMin = "1.0" ) )
+		float LoginBurstPerId{ 2.f };
+
+	/// 입장을 허락한 플레이어의 자리를 잡아두는 시간 ( 초, 로그인이 끝나지 않으면 풀린다 )
+	UPROPERTY( EditDefaultsOnly, Category = Admission, meta = ( ClampMin = "0.0" ) )
+		float ReservationTimeout{ 30.f };
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 토큰 버킷
+////////////////////////////////////////////////////////////////////////////
+struct FLobbyTokenBucket
+{
+	/// 남은 토큰
+	float Tokens{ 0.f };
+
+	/// 마지막으로 토큰을 채운 시간
+	double LastRefillTime{ 0.0 };
+
+	/// 토큰을 채우고 하나를 쓴다. 토큰이 없으면 false
+	bool TryConsume( double now, float rate, float burst );
+
+	/// 지금 토큰이 가득 차 있는지 여부 ( 지워도 되는 버킷 )
+	bool IsFull( double now, float rate, float burst ) const;
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 로비 입장 제한 ( 인원, 주소 / 고유 ID 별 입장 빈도, 입장 중인 플레이어 자리 예약 )
+////////////////////////////////////////////////////////////////////////////
+class FLobbyAdmissionControl
+{
+private:
+	/// 입장 중인 플레이어의 예약
+	struct FReservation
+	{
+		/// 고유 ID ( 없으면 주소로 구분 )
+		FUniqueNetIdRepl PlayerId;
+
+		/// 주소
+		FString Address;
+
+		/// 예약이 풀리는 시간
+		double ExpireTime{ 0.0 };
+
+		/// 같은 플레이어인지 여부
+		bool Matches( const FUniqueNetIdRepl& playerId, const FString& address ) const;
+	};
+
+	/// 주소별 토큰 버킷
+	TMap< FString, FLobbyTokenBucket > m_AddressBuckets;
+
+	/// 고유 ID 별 토큰 버킷
+	TMap< FUniqueNetIdRepl, FLobbyTokenBucket > m_IdBuckets;
+
+	/// 입장 중인 플레이어 예약 ( 최대 인원을 넘지 않으므로 배열로 둔다 )
+	TArray< FReservation > m_Reservations;
+
+	/// 다음에 가득 찬 버킷을 정리할 시간
+	double m_NextPruneTime{ 0.0 };
+
+
+public:
+	/// 입장을 심사한다. 거절하면 false 와 함께 이유를 채운다.
+	/// capacity 가 0 이하면 인원은 제한하지 않는다.
+	bool Admit( const FLobbyAdmissionConfig& config, const FString& address, const FUniqueNetIdRepl& playerId,
+				int32 numPlayers, int32 capacity, double now, FString& outReason );
+
+	/// 로그인이 끝난 플레이어의 예약을 푼다.
+	void ConfirmLogin( const FUniqueNetIdRepl& playerId, const FString& address );
+
+	/// 아직 로그인 중인 플레이어 수
+	int32 GetNumReservations( double now );
+
+	/// 모든 상태를 비운다.
+	void Reset();
+
+
+private:
+	/// 시간이 지난 예약을 푼다.
+	void ExpireReservations( double now );
+
+	/// 가득 찬 버킷을 정리한다.
+	void PruneBuckets( const FLobbyAdmissionConfig& config, double now );
+};
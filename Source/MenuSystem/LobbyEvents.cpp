@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LobbyEvents.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// 이벤트를 추가한다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyEventCoalescer::Add( ELobbyEventType type, int32 slot )
+{
+	if ( !ensure( slot >= 0 && slot <= MAX_uint16 ) )
+		return;
+
+	TArray< FLobbyEvent >& events = m_Pending.Events;
+
+	// 같은 묶음에서 들어왔다가 나간 플레이어는 클라이언트가 알 필요가 없다.
+	// ( 나갔다가 같은 슬롯으로 들어온 경우는 다른 플레이어일 수 있으므로 둘 다 보낸다 )
+	if ( ELobbyEventType::Left == type )
+	{
+		const int32 lastIndex = events.FindLastByPredicate( [ slot ]( const FLobbyEvent& each )
+		{
+			return each.Slot == slot;
+		} );
+
+		if ( INDEX_NONE != lastIndex && ELobbyEventType::Joined == events[ lastIndex ].Type )
+		{
+			events.RemoveAt( lastIndex, 1, false );
+			return;
+		}
+	}
+
+	FLobbyEvent& newEvent = events.AddDefaulted_GetRef();
+	newEvent.Type = type;
+	newEvent.Slot = static_cast< uint16 >( slot );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 모은 이벤트를 묶음으로 꺼낸다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyEventCoalescer::Flush( int32 numPlayers, FLobbyEventBatch& outBatch )
+{
+	m_Pending.NumPlayers = static_cast< uint16 >( FMath::Clamp( numPlayers, 0, static_cast< int32 >( MAX_uint16 ) ) );
+
+	// 배열을 맞바꿔서 다음 묶음도 같은 버퍼를 재사용한다.
+	outBatch.Events.Reset();
+	Swap( outBatch, m_Pending );
+}
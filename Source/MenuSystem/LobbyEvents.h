@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LobbyEvents.generated.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 로비 이벤트 종류
+////////////////////////////////////////////////////////////////////////////
+UENUM()
+enum class ELobbyEventType : uint8
+{
+	Joined,
+	Left,
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 로비 이벤트 ( 플레이어는 로스터 슬롯으로 가리킨다 )
+////////////////////////////////////////////////////////////////////////////
+USTRUCT()
+struct FLobbyEvent
+{
+	GENERATED_BODY()
+
+	/// 이벤트 종류
+	UPROPERTY()
+		ELobbyEventType Type{ ELobbyEventType::Joined };
+
+	/// 로스터 슬롯 인덱스
+	UPROPERTY()
+		uint16 Slot{ 0 };
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 한 번에 보내는 로비 이벤트 묶음
+////////////////////////////////////////////////////////////////////////////
+USTRUCT()
+struct FLobbyEventBatch
+{
+	GENERATED_BODY()
+
+	/// 묶음을 보낸 시점의 로비 인원
+	UPROPERTY()
+		uint16 NumPlayers{ 0 };
+
+	/// 이벤트 ( 발생 순서 )
+	UPROPERTY()
+		TArray< FLobbyEvent > Events;
+};
+
+
+/// 로비 이벤트 묶음을 받았을 때
+DECLARE_MULTICAST_DELEGATE_OneParam( FOnLobbyEventBatch, const FLobbyEventBatch& );
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 로비 이벤트를 묶는다. 한 묶음 안에서 들어왔다 바로 나간 플레이어는 서로 지운다.
+////////////////////////////////////////////////////////////////////////////
+class FLobbyEventCoalescer
+{
+private:
+	/// 아직 보내지 않은 이벤트
+	FLobbyEventBatch m_Pending;
+
+
+public:
+	/// 이벤트를 추가한다.
+	void Add( ELobbyEventType type, int32 slot );
+
+	/// 보낼 이벤트가 있는지 여부
+	bool HasPending() const { return m_Pending.Events.Num() > 0; }
+
+	/// 모은 이벤트를 묶음으로 꺼낸다.
+	void Flush( int32 numPlayers, FLobbyEventBatch& outBatch );
+};
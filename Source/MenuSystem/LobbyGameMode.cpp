@@ -2,10 +2,75 @@
 
 
 #include "LobbyGameMode.h"
-#include "GameFramework/GameStateBase.h"
+#include "LobbyGameState.h"
 #include "GameFramework/PlayerState.h"
+#include "Engine/NetConnection.h"
+#include "MultiPlayerSessionsSubsystem.h"
 
 
+//////////////////////////////////////////////////////////////////////////
+// 생성자
+//////////////////////////////////////////////////////////////////////////
+ALobbyGameMode::ALobbyGameMode()
+{
+	// 매치 맵으로 이동할 때 연결을 유지한다.
+	bUseSeamlessTravel = true;
+
+	// 접속한 플레이어는 로비 로스터로 관리한다.
+	GameStateClass = ALobbyGameState::StaticClass();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 로비를 시작합니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UMultiPlayerSessionsSubsystem* sessionsSubsystem = GetSessionsSubsystem();
+	ALobbyGameState* lobbyGameState = GetGameState< ALobbyGameState >();
+
+	// 로비에서 기다리는 동안 매치 맵을 미리 로드해서, 이동할 때 로딩 끊김이 없도록 한다.
+	// 게임 상태가 경로를 복제하므로 접속한 클라이언트도 같은 맵을 미리 로드한다.
+	if ( lobbyGameState )
+	{
+		lobbyGameState->SetMatchMapPath( m_MatchMapPath );
+	}
+
+	// 로그인이 몰려도 로스터가 다시 할당하지 않도록 세션 최대 인원만큼 잡아둔다.
+	if ( lobbyGameState && sessionsSubsystem )
+	{
+		lobbyGameState->GetRoster().Reserve( sessionsSubsystem->GetNumPublicConnections( sessionsSubsystem->GetHostedSessionName() ) );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 플레이어 입장을 심사합니다. 인원이 찼거나 입장 시도가 너무 잦으면 거절합니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameMode::PreLogin( const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage )
+{
+	Super::PreLogin( Options, Address, UniqueId, ErrorMessage );
+
+	if ( !ErrorMessage.IsEmpty() )
+		return;
+
+	// 매치 맵으로 이동 중인 로비에는 더 받지 않는다.
+	if ( m_IsMatchStarting )
+	{
+		ErrorMessage = TEXT( "Match is starting." );
+		return;
+	}
+
+	const ALobbyGameState* lobbyGameState = GetGameState< ALobbyGameState >();
+	const UMultiPlayerSessionsSubsystem* sessionsSubsystem = GetSessionsSubsystem();
+
+	const int32 numPlayers = lobbyGameState ? lobbyGameState->GetRoster().Num() : 0;
+	const int32 capacity   = sessionsSubsystem ? sessionsSubsystem->GetNumPublicConnections( sessionsSubsystem->GetHostedSessionName() ) : 0;
+
+	// 연결과 맵 이동 비용을 치르기 전에 거절해서, 로비에 있는 플레이어의 서버 틱을 지킨다.
+	m_Admission.Admit( m_AdmissionConfig, Address, UniqueId, numPlayers, capacity, FPlatformTime::Seconds(), ErrorMessage );
+}
+
 //////////////////////////////////////////////////////////////////////////
 // 플레이어가 로그인 합니다.
 //////////////////////////////////////////////////////////////////////////
@@ -13,29 +78,25 @@ void ALobbyGameMode::PostLogin( APlayerController* NewPlayer )
 {
 	Super::PostLogin( NewPlayer );
 
-	if ( GameState )
+	// 로그인이 끝났으므로 잡아둔 자리는 로스터가 대신 센다.
+	UNetConnection* netConnection = NewPlayer->GetNetConnection();
+	m_Admission.ConfirmLogin(
+		NewPlayer->PlayerState ? NewPlayer->PlayerState->GetUniqueId() : FUniqueNetIdRepl(),
+		netConnection ? netConnection->LowLevelGetRemoteAddress() : FString() );
+
+	ALobbyGameState* lobbyGameState = GetGameState< ALobbyGameState >();
+	APlayerState* playerState = NewPlayer->GetPlayerState< APlayerState >();
+
+	if ( lobbyGameState && playerState )
 	{
-		int32 numberOfPlayers = GameState.Get()->PlayerArray.Num();
-		if ( GEngine )
-		{
-			GEngine->AddOnScreenDebugMessage(
-				1,
-				60.f,
-				FColor::Yellow,
-				FString::Printf( TEXT( "Player in game: %d" ), numberOfPlayers ) );
-		}
-
-		APlayerState* playerState = NewPlayer->GetPlayerState< APlayerState >();
-		if ( playerState )
-		{
-			FString playerName = playerState->GetPlayerName();
-			GEngine->AddOnScreenDebugMessage(
-				-1,
-				60.f,
-				FColor::Yellow,
-				FString::Printf( TEXT( "%s has joined the game" ), *playerName ) );
-		}
+		// 로스터는 슬롯 하나만 갱신하고, 바뀐 슬롯만 클라이언트로 복제된다.
+		// 클라이언트에는 간격마다 묶은 이벤트로 알린다.
+		const int32 slot = lobbyGameState->GetRoster().AddPlayer( playerState, GetWorld()->GetTimeSeconds() );
+		lobbyGameState->QueueLobbyEvent( ELobbyEventType::Joined, slot );
 	}
+
+	UpdateBackfill();
+	TryStartMatch();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -45,26 +106,109 @@ void ALobbyGameMode::Logout( AController* Exiting )
 {
 	Super::Logout( Exiting );
 
+	ALobbyGameState* lobbyGameState = GetGameState< ALobbyGameState >();
 	APlayerState* playerState = Exiting->GetPlayerState< APlayerState >();
-	if ( playerState )
+
+	if ( lobbyGameState && playerState )
+	{
+		const int32 slot = lobbyGameState->GetRoster().RemovePlayer( playerState );
+		lobbyGameState->QueueLobbyEvent( ELobbyEventType::Left, slot );
+	}
+
+	// 빈 자리는 다시 광고해서 검색하는 플레이어로 채운다.
+	UpdateBackfill();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 세션 시작 결과를 처리한다. [ Delegator 로부터 전달받아 호출된 함수 ]
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameMode::OnStartSession( bool bWasSuccessful )
+{
+	UMultiPlayerSessionsSubsystem* sessionsSubsystem = GetSessionsSubsystem();
+	if ( sessionsSubsystem )
+	{
+		sessionsSubsystem->GetMultiplayerOnStartSessionComplete( sessionsSubsystem->GetHostedSessionName() ).RemoveDynamic( this, &ThisClass::OnStartSession );
+	}
+
+	if ( !bWasSuccessful )
 	{
-		if ( GEngine )
-		{
-			int32 numberOfPlayers = GameState.Get()->PlayerArray.Num();
-
-			GEngine->AddOnScreenDebugMessage(
-				-1,
-				60.f,
-				FColor::Yellow,
-				FString::Printf( TEXT( "Player in game: %d" ), numberOfPlayers ) );
-		}
-
-		FString playerName = playerState->GetPlayerName();
-		GEngine->AddOnScreenDebugMessage(
-			1,
-			60.f,
-			FColor::Yellow,
-			FString::Printf( TEXT( "%s has exited the game" ), *playerName ) );
+		// 다음 로그인 때 다시 시도한다.
+		m_IsMatchStarting = false;
+		return;
+	}
 
+	// 미리 로드가 끝나지 않았어도 전환 맵에서 나머지 로드를 기다리므로 바로 이동한다.
+	UWorld* world = GetWorld();
+	if ( world )
+	{
+		// 데디케이티드 서버는 이미 접속을 받고 있으므로 listen 옵션이 필요 없다.
+		const bool bIsDedicated = NM_DedicatedServer == GetNetMode();
+		world->ServerTravel( bIsDedicated ? m_MatchMapPath : FString::Printf( TEXT( "%s?listen" ), *m_MatchMapPath ) );
 	}
 }
+
+//////////////////////////////////////////////////////////////////////////
+// 로비 인원이 시작 기준에 도달했으면 세션을 시작한다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameMode::TryStartMatch()
+{
+	ALobbyGameState* lobbyGameState = GetGameState< ALobbyGameState >();
+	if ( m_IsMatchStarting || nullptr == lobbyGameState )
+		return;
+
+	UMultiPlayerSessionsSubsystem* sessionsSubsystem = GetSessionsSubsystem();
+	if ( nullptr == sessionsSubsystem )
+		return;
+
+	// 데디케이티드 서버는 -SessionName= 으로 다른 이름을 등록할 수 있으므로 등록한 이름을 쓴다.
+	const FName sessionName = sessionsSubsystem->GetHostedSessionName();
+
+	const int32 numPublicConnections = sessionsSubsystem->GetNumPublicConnections( sessionName );
+	if ( numPublicConnections <= 0 )
+		return;
+
+	const int32 numPlayersToStart = FMath::Clamp(
+		FMath::CeilToInt( numPublicConnections * m_StartFillRatio ),
+		m_MinPlayersToStart,
+		numPublicConnections );
+
+	if ( lobbyGameState->GetRoster().Num() < numPlayersToStart )
+		return;
+
+	m_IsMatchStarting = true;
+
+	sessionsSubsystem->GetMultiplayerOnStartSessionComplete( sessionName ).AddUniqueDynamic( this, &ThisClass::OnStartSession );
+	sessionsSubsystem->StartSession( FMultiplayerSessionTarget( sessionName ) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 남은 자리 수를 세션 광고에 반영한다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameMode::UpdateBackfill()
+{
+	// 매치 맵으로 이동 중이면 더 받지 않으므로 광고를 바꾸지 않는다.
+	if ( m_IsMatchStarting )
+		return;
+
+	ALobbyGameState* lobbyGameState = GetGameState< ALobbyGameState >();
+	UMultiPlayerSessionsSubsystem* sessionsSubsystem = GetSessionsSubsystem();
+	if ( nullptr == lobbyGameState || nullptr == sessionsSubsystem )
+		return;
+
+	// 로그인 중인 플레이어의 자리도 빼야 검색하는 쪽이 들어올 수 없는 로비를 받지 않는다.
+	const int32 numUsedSlots = lobbyGameState->GetRoster().Num() + m_Admission.GetNumReservations( FPlatformTime::Seconds() );
+	const FName sessionName = sessionsSubsystem->GetHostedSessionName();
+	sessionsSubsystem->SetOpenSlots( sessionsSubsystem->GetNumPublicConnections( sessionName ) - numUsedSlots, sessionName );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 세션 서브시스템을 반환한다.
+//////////////////////////////////////////////////////////////////////////
+UMultiPlayerSessionsSubsystem* ALobbyGameMode::GetSessionsSubsystem() const
+{
+	UGameInstance* gameInstance = GetGameInstance();
+	if ( nullptr == gameInstance )
+		return nullptr;
+
+	return gameInstance->GetSubsystem< UMultiPlayerSessionsSubsystem >();
+}
@@ -4,8 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "LobbyAdmission.h"
 #include "LobbyGameMode.generated.h"
 
+
+class UMultiPlayerSessionsSubsystem;
+
+
 /**
  * 
  */
@@ -14,10 +19,60 @@ class MENUSYSTEM_API ALobbyGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
 
+private:
+	/// 로비가 찼을 때 이동할 매치 맵 경로
+	UPROPERTY( EditDefaultsOnly, Category = Lobby, meta = ( AllowPrivateAccess = "true" ) )
+		FString m_MatchMapPath{ TEXT( "/Game/ThirdPerson/Maps/ThirdPersonMap" ) };
+
+	/// 매치를 시작하는 로비 인원 비율 ( 세션 최대 접속 수 기준, 1 이면 가득 찼을 때 )
+	UPROPERTY( EditDefaultsOnly, Category = Lobby, meta = ( AllowPrivateAccess = "true", ClampMin = "0.0", ClampMax = "1.0" ) )
+		float m_StartFillRatio{ 1.f };
+
+	/// 매치를 시작하는 최소 인원
+	UPROPERTY( EditDefaultsOnly, Category = Lobby, meta = ( AllowPrivateAccess = "true", ClampMin = "1" ) )
+		int32 m_MinPlayersToStart{ 2 };
+
+	/// 입장 제한 설정
+	UPROPERTY( EditDefaultsOnly, Category = Lobby, meta = ( AllowPrivateAccess = "true" ) )
+		FLobbyAdmissionConfig m_AdmissionConfig;
+
+	/// 입장 제한
+	FLobbyAdmissionControl m_Admission;
+
+	/// 매치 시작을 요청했는지 여부 ( 중복 시작 방지 )
+	bool m_IsMatchStarting{ false };
+
+
 public:
+	/// 생성자
+	ALobbyGameMode();
+
+	/// 로비를 시작합니다.
+	virtual void BeginPlay() override;
+
+	/// 플레이어 입장을 심사합니다. 인원이 찼거나 입장 시도가 너무 잦으면 거절합니다.
+	virtual void PreLogin( const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage ) override;
+
 	/// 플레이어가 로그인 합니다.
 	virtual void PostLogin( APlayerController* NewPlayer ) override;
 
 	/// 플레이어가 로그아웃 합니다.
 	virtual void Logout( AController* Exiting ) override;
+
+
+protected:
+	/// 세션 시작 결과를 처리한다. [ Delegator 로부터 전달받아 호출된 함수 ]
+	UFUNCTION()
+	void OnStartSession( bool bWasSuccessful );
+
+
+private:
+	/// 로비 인원이 시작 기준에 도달했으면 세션을 시작한다.
+	void TryStartMatch();
+
+	/// 남은 자리 수를 세션 광고에 반영한다.
+	void UpdateBackfill();
+
+	/// 세션 서브시스템을 반환한다.
+	UMultiPlayerSessionsSubsystem* GetSessionsSubsystem() const;
 };
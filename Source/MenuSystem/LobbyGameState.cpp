@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LobbyGameState.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+#include "Engine/GameInstance.h"
+#include "MultiPlayerSessionsSubsystem.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// 복제할 속성을 등록합니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >& OutLifetimeProps ) const
+{
+	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
+
+	DOREPLIFETIME( ALobbyGameState, m_Roster );
+	DOREPLIFETIME( ALobbyGameState, m_MatchMapPath );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 이동할 매치 맵을 정하고 미리 로드합니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameState::SetMatchMapPath( const FString& matchMapPath )
+{
+	if ( !HasAuthority() || m_MatchMapPath == matchMapPath )
+		return;
+
+	m_MatchMapPath = matchMapPath;
+
+	// 복제 알림은 서버에서 불리지 않으므로 서버( 리슨 호스트 포함 )는 직접 미리 로드한다.
+	PreloadMatchMap();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 매치 맵 경로를 복제받았을 때 미리 로드한다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameState::OnRep_MatchMapPath()
+{
+	PreloadMatchMap();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 로비 이벤트를 추가합니다. 간격 안에 들어온 이벤트는 한 번에 보냅니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameState::QueueLobbyEvent( ELobbyEventType type, int32 slot )
+{
+	if ( !HasAuthority() || INDEX_NONE == slot )
+		return;
+
+	m_EventCoalescer.Add( type, slot );
+
+	// 첫 이벤트가 들어올 때만 타이머를 건다. 로그인이 몰려도 간격마다 RPC 하나만 나간다.
+	if ( !GetWorldTimerManager().IsTimerActive( m_EventFlushTimerHandle ) )
+	{
+		GetWorldTimerManager().SetTimer( m_EventFlushTimerHandle, this, &ThisClass::FlushLobbyEvents, FMath::Max( m_EventBatchInterval, KINDA_SMALL_NUMBER ), false );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 로비 이벤트 묶음을 모든 클라이언트에 전달한다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameState::MulticastLobbyEvents_Implementation( const FLobbyEventBatch& batch )
+{
+	OnLobbyEvents.Broadcast( batch );
+
+	// 화면 디버그 출력은 개발 빌드에서만 한다. 실제 UI 는 OnLobbyEvents 에 바인딩한다.
+#if !UE_BUILD_SHIPPING
+	if ( GEngine )
+	{
+		int32 numJoined = 0;
+		for ( const FLobbyEvent& lobbyEvent : batch.Events )
+		{
+			numJoined += ELobbyEventType::Joined == lobbyEvent.Type ? 1 : 0;
+		}
+
+		// 묶음마다 한 줄만 갱신한다.
+		GEngine->AddOnScreenDebugMessage(
+			1,
+			60.f,
+			FColor::Yellow,
+			FString::Printf( TEXT( "Player in game: %d ( +%d / -%d )" ), batch.NumPlayers, numJoined, batch.Events.Num() - numJoined ) );
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 모은 로비 이벤트를 보낸다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameState::FlushLobbyEvents()
+{
+	// 들어왔다가 바로 나간 플레이어만 있었다면 보낼 것이 없다.
+	if ( !m_EventCoalescer.HasPending() )
+		return;
+
+	m_EventCoalescer.Flush( m_Roster.Num(), m_OutgoingEvents );
+
+	MulticastLobbyEvents( m_OutgoingEvents );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 매치 맵을 미리 로드한다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyGameState::PreloadMatchMap() const
+{
+	if ( m_MatchMapPath.IsEmpty() )
+		return;
+
+	const UGameInstance* gameInstance = GetGameInstance();
+	UMultiPlayerSessionsSubsystem* sessionsSubsystem = gameInstance ? gameInstance->GetSubsystem< UMultiPlayerSessionsSubsystem >() : nullptr;
+	if ( sessionsSubsystem )
+	{
+		sessionsSubsystem->PreloadMap( m_MatchMapPath );
+	}
+}
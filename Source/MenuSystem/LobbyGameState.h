@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "LobbyEvents.h"
+#include "LobbyRoster.h"
+#include "LobbyGameState.generated.h"
+
+
+/**
+ * 로비 로스터와 로비 이벤트를 클라이언트로 복제하는 게임 상태
+ */
+UCLASS()
+class MENUSYSTEM_API ALobbyGameState : public AGameStateBase
+{
+	GENERATED_BODY()
+
+private:
+	/// 로비 로스터 ( 바뀐 슬롯만 복제된다 )
+	UPROPERTY( Replicated )
+		FLobbyRoster m_Roster;
+
+	/// 로비가 끝나면 이동할 매치 맵 경로 ( 클라이언트도 기다리는 동안 미리 로드한다 )
+	UPROPERTY( ReplicatedUsing = OnRep_MatchMapPath )
+		FString m_MatchMapPath;
+
+	/// 로비 이벤트를 모아서 보내는 간격 ( 초 )
+	UPROPERTY( EditDefaultsOnly, Category = Lobby, meta = ( AllowPrivateAccess = "true", ClampMin = "0.0" ) )
+		float m_EventBatchInterval{ 0.25f };
+
+	/// 아직 보내지 않은 로비 이벤트
+	FLobbyEventCoalescer m_EventCoalescer;
+
+	/// 보낼 로비 이벤트 묶음 ( 버퍼 재사용 )
+	FLobbyEventBatch m_OutgoingEvents;
+
+	/// 로비 이벤트 전송 타이머 핸들
+	FTimerHandle m_EventFlushTimerHandle;
+
+public:
+	/// 로비 이벤트 묶음을 받았을 때 ( 서버와 클라이언트 모두 )
+	FOnLobbyEventBatch OnLobbyEvents;
+
+
+public:
+	/// 복제할 속성을 등록합니다.
+	virtual void GetLifetimeReplicatedProps( TArray< FLifetimeProperty >& OutLifetimeProps ) const override;
+
+	/// 로비 로스터를 반환합니다.
+	FLobbyRoster& GetRoster() { return m_Roster; }
+	const FLobbyRoster& GetRoster() const { return m_Roster; }
+
+	/// 이동할 매치 맵을 정하고 미리 로드합니다. 클라이언트는 복제받은 후 미리 로드합니다. [ 서버 전용 ]
+	void SetMatchMapPath( const FString& matchMapPath );
+
+	/// 로비 이벤트를 추가합니다. 간격 안에 들어온 이벤트는 한 번에 보냅니다. [ 서버 전용 ]
+	void QueueLobbyEvent( ELobbyEventType type, int32 slot );
+
+
+protected:
+	/// 매치 맵 경로를 복제받았을 때 미리 로드한다.
+	UFUNCTION()
+	void OnRep_MatchMapPath();
+
+	/// 로비 이벤트 묶음을 모든 클라이언트에 전달한다.
+	UFUNCTION( NetMulticast, Reliable )
+	void MulticastLobbyEvents( const FLobbyEventBatch& batch );
+
+
+private:
+	/// 모은 로비 이벤트를 보낸다.
+	void FlushLobbyEvents();
+
+	/// 매치 맵을 미리 로드한다.
+	void PreloadMatchMap() const;
+};
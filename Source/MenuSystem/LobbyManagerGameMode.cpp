@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LobbyManagerGameMode.h"
+#include "LobbyPlayerState.h"
+#include "LobbyRoom.h"
+#include "GameFramework/GameSession.h"
+#include "Engine/NetConnection.h"
+#include "Kismet/GameplayStatics.h"
+#include "MultiPlayerSessionsSubsystem.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// 생성자
+//////////////////////////////////////////////////////////////////////////
+ALobbyManagerGameMode::ALobbyManagerGameMode()
+{
+	// 방 단위로 복제되는 플레이어 상태를 사용한다.
+	PlayerStateClass = ALobbyPlayerState::StaticClass();
+
+	// 방은 논리적인 단위라 같은 월드에 폰을 만들면 다른 방 플레이어와 섞이므로 만들지 않는다.
+	DefaultPawnClass = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 방을 만들고 방마다 세션을 등록합니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyManagerGameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UWorld* world = GetWorld();
+	if ( nullptr == world )
+		return;
+
+	UMultiPlayerSessionsSubsystem* sessionsSubsystem = GetSessionsSubsystem();
+
+	FActorSpawnParameters spawnParams;
+	spawnParams.Owner = this;
+
+	m_Rooms.Reserve( m_NumRooms );
+	m_RoomIndexBySession.Reserve( m_NumRooms );
+
+	for ( int32 roomIndex = 0; roomIndex < m_NumRooms; ++roomIndex )
+	{
+		const FName sessionName( *FString::Printf( TEXT( "%s_%d" ), *m_RoomSessionPrefix.ToString(), roomIndex + 1 ) );
+
+		ALobbyRoom* room = world->SpawnActor< ALobbyRoom >( spawnParams );
+		if ( nullptr == room )
+			continue;
+
+		room->InitializeRoom( sessionName, m_RoomCapacity, m_EventBatchInterval );
+		m_RoomIndexBySession.Add( sessionName, m_Rooms.Add( room ) );
+
+		// 세션마다 대기열이 따로 있으므로 방 세션들은 동시에 등록된다.
+		if ( sessionsSubsystem )
+		{
+			sessionsSubsystem->CreateSession( FMultiplayerSessionTarget( sessionName ), m_RoomCapacity, m_MatchType );
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 플레이어 입장을 심사합니다. 요청한 방이 없거나 찼거나, 모든 방이 찼거나, 입장 시도가 너무 잦으면 거절합니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyManagerGameMode::PreLogin( const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage )
+{
+	Super::PreLogin( Options, Address, UniqueId, ErrorMessage );
+
+	if ( !ErrorMessage.IsEmpty() )
+		return;
+
+	const FName requestedSessionName( *UGameplayStatics::ParseOption( Options, TEXT( "Session" ) ) );
+	if ( !requestedSessionName.IsNone() )
+	{
+		const ALobbyRoom* requestedRoom = FindRoom( requestedSessionName );
+		if ( nullptr == requestedRoom )
+		{
+			ErrorMessage = TEXT( "Unknown lobby." );
+			return;
+		}
+
+		// 클라이언트는 요청한 방의 세션에 참가해 있으므로 다른 방으로 보내지 않는다.
+		if ( requestedRoom->GetNumOpenSlots() <= 0 )
+		{
+			ErrorMessage = TEXT( "Lobby is full." );
+			return;
+		}
+	}
+
+	// 방을 지정하지 않은 플레이어는 아무 방에나 넣으므로 프로세스 전체 자리로 심사한다.
+	const int32 capacity = m_Rooms.Num() * m_RoomCapacity;
+	m_Admission.Admit( m_AdmissionConfig, Address, UniqueId, m_NumPlayers, capacity, FPlatformTime::Seconds(), ErrorMessage );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 접속 옵션에서 요청한 방을 기억합니다.
+//////////////////////////////////////////////////////////////////////////
+FString ALobbyManagerGameMode::InitNewPlayer( APlayerController* NewPlayerController, const FUniqueNetIdRepl& UniqueId, const FString& Options, const FString& Portal )
+{
+	const FString errorMessage = Super::InitNewPlayer( NewPlayerController, UniqueId, Options, Portal );
+
+	if ( errorMessage.IsEmpty() && NewPlayerController )
+	{
+		m_RequestedRooms.Add( NewPlayerController, FName( *UGameplayStatics::ParseOption( Options, TEXT( "Session" ) ) ) );
+	}
+
+	return errorMessage;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 플레이어를 방에 넣습니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyManagerGameMode::PostLogin( APlayerController* NewPlayer )
+{
+	Super::PostLogin( NewPlayer );
+
+	// 로그인이 끝났으므로 잡아둔 자리는 방 인원이 대신 센다.
+	UNetConnection* netConnection = NewPlayer->GetNetConnection();
+	m_Admission.ConfirmLogin(
+		NewPlayer->PlayerState ? NewPlayer->PlayerState->GetUniqueId() : FUniqueNetIdRepl(),
+		netConnection ? netConnection->LowLevelGetRemoteAddress() : FString() );
+
+	FName requestedSessionName;
+	m_RequestedRooms.RemoveAndCopyValue( NewPlayer, requestedSessionName );
+
+	ALobbyPlayerState* playerState = NewPlayer->GetPlayerState< ALobbyPlayerState >();
+	ALobbyRoom* room = ChooseRoom( requestedSessionName );
+
+	// 동시에 로그인한 플레이어들이 마지막 자리를 나눠 가진 경우
+	if ( nullptr == room || nullptr == playerState || INDEX_NONE == room->AddPlayer( playerState ) )
+	{
+		if ( GameSession )
+		{
+			GameSession->KickPlayer( NewPlayer, FText::FromString( TEXT( "Lobby is full." ) ) );
+		}
+		return;
+	}
+
+	playerState->SetRoom( room );
+	++m_NumPlayers;
+
+	UpdateRoomBackfill( *room );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 플레이어를 방에서 뺍니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyManagerGameMode::Logout( AController* Exiting )
+{
+	Super::Logout( Exiting );
+
+	m_RequestedRooms.Remove( Cast< APlayerController >( Exiting ) );
+
+	ALobbyPlayerState* playerState = Exiting->GetPlayerState< ALobbyPlayerState >();
+	ALobbyRoom* room = playerState ? playerState->GetRoom() : nullptr;
+	if ( nullptr == room )
+		return;
+
+	if ( INDEX_NONE != room->RemovePlayer( playerState ) )
+	{
+		--m_NumPlayers;
+	}
+
+	playerState->SetRoom( nullptr );
+
+	// 빈 자리는 다시 광고해서 검색하는 플레이어로 채운다.
+	UpdateRoomBackfill( *room );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 세션 이름으로 방을 찾습니다. 없으면 nullptr
+//////////////////////////////////////////////////////////////////////////
+ALobbyRoom* ALobbyManagerGameMode::FindRoom( FName sessionName ) const
+{
+	const int32* roomIndex = m_RoomIndexBySession.Find( sessionName );
+	return roomIndex ? m_Rooms[ *roomIndex ].Get() : nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 방을 요청했으면 그 방에 자리가 있을 때만 그 방을, 요청하지 않았으면 가장 많이 찬 방 중 자리가 있는 방을 반환한다. 없으면 nullptr
+//////////////////////////////////////////////////////////////////////////
+ALobbyRoom* ALobbyManagerGameMode::ChooseRoom( FName requestedSessionName ) const
+{
+	// 요청한 방이 찼다고 다른 방에 넣으면 클라이언트가 참가한 세션과 실제 방이 어긋나므로 거절한다.
+	if ( !requestedSessionName.IsNone() )
+	{
+		ALobbyRoom* requestedRoom = FindRoom( requestedSessionName );
+		return requestedRoom && requestedRoom->GetNumOpenSlots() > 0 ? requestedRoom : nullptr;
+	}
+
+	// 방을 하나씩 채워야 광고 중인 방마다 인원이 흩어지지 않는다.
+	ALobbyRoom* bestRoom = nullptr;
+	for ( ALobbyRoom* room : m_Rooms )
+	{
+		const int32 numOpenSlots = room ? room->GetNumOpenSlots() : 0;
+		if ( numOpenSlots > 0 && ( nullptr == bestRoom || numOpenSlots < bestRoom->GetNumOpenSlots() ) )
+		{
+			bestRoom = room;
+		}
+	}
+
+	return bestRoom;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 방의 남은 자리 수를 세션 광고에 반영한다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyManagerGameMode::UpdateRoomBackfill( const ALobbyRoom& room )
+{
+	UMultiPlayerSessionsSubsystem* sessionsSubsystem = GetSessionsSubsystem();
+	if ( sessionsSubsystem )
+	{
+		sessionsSubsystem->SetOpenSlots( room.GetNumOpenSlots(), room.GetSessionName() );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 세션 서브시스템을 반환한다.
+//////////////////////////////////////////////////////////////////////////
+UMultiPlayerSessionsSubsystem* ALobbyManagerGameMode::GetSessionsSubsystem() const
+{
+	UGameInstance* gameInstance = GetGameInstance();
+	if ( nullptr == gameInstance )
+		return nullptr;
+
+	return gameInstance->GetSubsystem< UMultiPlayerSessionsSubsystem >();
+}
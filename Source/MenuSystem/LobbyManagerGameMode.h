@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "LobbyAdmission.h"
+#include "LobbyManagerGameMode.generated.h"
+
+
+class ALobbyRoom;
+class UMultiPlayerSessionsSubsystem;
+
+
+/**
+ * 한 데디케이티드 서버 프로세스에서 여러 로비 방을 호스팅하는 게임 모드
+ * 방마다 세션을 따로 광고하고, 접속 옵션 ?Session= 으로 맵 이동 없이 방을 고른다.
+ * 방은 논리적인 단위이므로 폰을 만들지 않고, 방 액터와 플레이어 상태는 같은 방 멤버에게만 복제된다.
+ */
+UCLASS()
+class MENUSYSTEM_API ALobbyManagerGameMode : public AGameModeBase
+{
+	GENERATED_BODY()
+
+private:
+	/// 호스팅할 방 수
+	UPROPERTY( EditDefaultsOnly, Category = Lobby, meta = ( AllowPrivateAccess = "true", ClampMin = "1" ) )
+		int32 m_NumRooms{ 16 };
+
+	/// 방 정원
+	UPROPERTY( EditDefaultsOnly, Category = Lobby, meta = ( AllowPrivateAccess = "true", ClampMin = "1" ) )
+		int32 m_RoomCapacity{ 4 };
+
+	/// 방 세션에 광고할 MatchType
+	UPROPERTY( EditDefaultsOnly, Category = Lobby, meta = ( AllowPrivateAccess = "true" ) )
+		FString m_MatchType{ TEXT( "FreeForAll" ) };
+
+	/// 방 세션 이름 접두사 ( Lobby_1, Lobby_2, ... )
+	UPROPERTY( EditDefaultsOnly, Category = Lobby, meta = ( AllowPrivateAccess = "true" ) )
+		FName m_RoomSessionPrefix{ TEXT( "Lobby" ) };
+
+	/// 방 이벤트를 모아서 보내는 간격 ( 초 )
+	UPROPERTY( EditDefaultsOnly, Category = Lobby, meta = ( AllowPrivateAccess = "true", ClampMin = "0.0" ) )
+		float m_EventBatchInterval{ 0.25f };
+
+	/// 입장 제한 설정 ( 프로세스 전체에 적용한다 )
+	UPROPERTY( EditDefaultsOnly, Category = Lobby, meta = ( AllowPrivateAccess = "true" ) )
+		FLobbyAdmissionConfig m_AdmissionConfig;
+
+	/// 입장 제한
+	FLobbyAdmissionControl m_Admission;
+
+	/// 방 목록
+	UPROPERTY()
+		TArray< TObjectPtr< ALobbyRoom > > m_Rooms;
+
+	/// 세션 이름 → 방 인덱스
+	TMap< FName, int32 > m_RoomIndexBySession;
+
+	/// 로그인 중인 플레이어가 요청한 방 세션 이름 ( PostLogin 에서 꺼낸다 )
+	TMap< TWeakObjectPtr< APlayerController >, FName > m_RequestedRooms;
+
+	/// 방에 들어가 있는 플레이어 수
+	int32 m_NumPlayers{ 0 };
+
+
+public:
+	/// 생성자
+	ALobbyManagerGameMode();
+
+	/// 방을 만들고 방마다 세션을 등록합니다.
+	virtual void BeginPlay() override;
+
+	/// 플레이어 입장을 심사합니다. 요청한 방이 없거나 찼거나, 모든 방이 찼거나, 입장 시도가 너무 잦으면 거절합니다.
+	virtual void PreLogin( const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage ) override;
+
+	/// 접속 옵션에서 요청한 방을 기억합니다.
+	virtual FString InitNewPlayer( APlayerController* NewPlayerController, const FUniqueNetIdRepl& UniqueId, const FString& Options, const FString& Portal = TEXT( "" ) ) override;
+
+	/// 플레이어를 방에 넣습니다.
+	virtual void PostLogin( APlayerController* NewPlayer ) override;
+
+	/// 플레이어를 방에서 뺍니다.
+	virtual void Logout( AController* Exiting ) override;
+
+	/// 세션 이름으로 방을 찾습니다. 없으면 nullptr
+	ALobbyRoom* FindRoom( FName sessionName ) const;
+
+	/// 방 목록을 반환합니다.
+	const TArray< TObjectPtr< ALobbyRoom > >& GetRooms() const { return m_Rooms; }
+
+
+private:
+	/// 방을 요청했으면 그 방에 자리가 있을 때만 그 방을, 요청하지 않았으면 가장 많이 찬 방 중 자리가 있는 방을 반환한다. 없으면 nullptr
+	ALobbyRoom* ChooseRoom( FName requestedSessionName ) const;
+
+	/// 방의 남은 자리 수를 세션 광고에 반영한다.
+	void UpdateRoomBackfill( const ALobbyRoom& room );
+
+	/// 세션 서브시스템을 반환한다.
+	UMultiPlayerSessionsSubsystem* GetSessionsSubsystem() const;
+};
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LobbyPlayerState.h"
+#include "LobbyRoom.h"
+#include "GameFramework/PlayerController.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// 생성자
+//////////////////////////////////////////////////////////////////////////
+ALobbyPlayerState::ALobbyPlayerState()
+{
+	// 기본 플레이어 상태는 모든 연결에 복제되므로, 방 단위로 복제되도록 끈다.
+	bAlwaysRelevant = false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 같은 방의 플레이어에게만 복제합니다.
+//////////////////////////////////////////////////////////////////////////
+bool ALobbyPlayerState::IsNetRelevantFor( const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation ) const
+{
+	const ALobbyPlayerState* viewerPlayerState = GetViewerPlayerState( RealViewer );
+	if ( this == viewerPlayerState )
+		return true;
+
+	const ALobbyRoom* room = GetRoom();
+	return room && viewerPlayerState && room == viewerPlayerState->GetRoom();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 들어가 있는 방을 설정합니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyPlayerState::SetRoom( ALobbyRoom* room )
+{
+	m_Room = room;
+
+	// 방이 바뀌면 복제 대상도 바뀌므로 다음 복제 때 바로 반영한다.
+	ForceNetUpdate();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 복제를 보는 쪽의 플레이어 상태를 반환합니다.
+//////////////////////////////////////////////////////////////////////////
+const ALobbyPlayerState* ALobbyPlayerState::GetViewerPlayerState( const AActor* realViewer )
+{
+	const APlayerController* viewerController = Cast< APlayerController >( realViewer );
+	return viewerController ? Cast< ALobbyPlayerState >( viewerController->PlayerState ) : nullptr;
+}
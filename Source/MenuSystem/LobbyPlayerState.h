@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerState.h"
+#include "LobbyPlayerState.generated.h"
+
+
+class ALobbyRoom;
+
+
+/**
+ * 여러 로비 방을 호스팅하는 서버의 플레이어 상태
+ * 같은 방의 플레이어에게만 복제되므로, 방이 늘어나도 플레이어마다 복제 비용은 방 인원만큼만 든다.
+ */
+UCLASS()
+class MENUSYSTEM_API ALobbyPlayerState : public APlayerState
+{
+	GENERATED_BODY()
+
+private:
+	/// 들어가 있는 방 [ 서버 전용 ]
+	TWeakObjectPtr< ALobbyRoom > m_Room;
+
+
+public:
+	/// 생성자
+	ALobbyPlayerState();
+
+	/// 같은 방의 플레이어에게만 복제합니다.
+	virtual bool IsNetRelevantFor( const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation ) const override;
+
+	/// 들어가 있는 방을 반환합니다. 없으면 nullptr [ 서버 전용 ]
+	ALobbyRoom* GetRoom() const { return m_Room.Get(); }
+
+	/// 들어가 있는 방을 설정합니다. [ 서버 전용 ]
+	void SetRoom( ALobbyRoom* room );
+
+	/// 복제를 보는 쪽의 플레이어 상태를 반환합니다. 없으면 nullptr
+	static const ALobbyPlayerState* GetViewerPlayerState( const AActor* realViewer );
+};
@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LobbyRoom.h"
+#include "LobbyPlayerState.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// 생성자
+//////////////////////////////////////////////////////////////////////////
+ALobbyRoom::ALobbyRoom()
+{
+	bReplicates		= true;
+	bAlwaysRelevant = false;
+
+	// 방은 대부분 가만히 있으므로 자주 확인하지 않는다. 인원이 바뀌면 ForceNetUpdate 로 바로 보낸다.
+	NetUpdateFrequency	  = 1.f;
+	MinNetUpdateFrequency = 0.2f;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 복제할 속성을 등록합니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyRoom::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >& OutLifetimeProps ) const
+{
+	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
+
+	DOREPLIFETIME_CONDITION( ALobbyRoom, m_SessionName, COND_InitialOnly );
+	DOREPLIFETIME_CONDITION( ALobbyRoom, m_Capacity, COND_InitialOnly );
+	DOREPLIFETIME( ALobbyRoom, m_Roster );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 방 멤버에게만 복제합니다.
+//////////////////////////////////////////////////////////////////////////
+bool ALobbyRoom::IsNetRelevantFor( const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation ) const
+{
+	const ALobbyPlayerState* viewerPlayerState = ALobbyPlayerState::GetViewerPlayerState( RealViewer );
+	return viewerPlayerState && this == viewerPlayerState->GetRoom();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 방을 초기화합니다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyRoom::InitializeRoom( FName sessionName, int32 capacity, float eventBatchInterval )
+{
+	m_SessionName		 = sessionName;
+	m_Capacity			 = FMath::Max( capacity, 1 );
+	m_EventBatchInterval = eventBatchInterval;
+
+	// 로그인이 몰려도 로스터가 다시 할당하지 않도록 정원만큼 잡아둔다.
+	m_Roster.Reserve( m_Capacity );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 플레이어를 방에 넣습니다. 방이 가득 찼으면 INDEX_NONE
+//////////////////////////////////////////////////////////////////////////
+int32 ALobbyRoom::AddPlayer( APlayerState* playerState )
+{
+	if ( !HasAuthority() || nullptr == playerState || GetNumOpenSlots() <= 0 )
+		return INDEX_NONE;
+
+	const int32 slot = m_Roster.AddPlayer( playerState, GetWorld()->GetTimeSeconds() );
+	QueueLobbyEvent( ELobbyEventType::Joined, slot );
+
+	ForceNetUpdate();
+
+	return slot;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 플레이어를 방에서 뺍니다. 방에 없던 플레이어면 INDEX_NONE
+//////////////////////////////////////////////////////////////////////////
+int32 ALobbyRoom::RemovePlayer( APlayerState* playerState )
+{
+	if ( !HasAuthority() || nullptr == playerState )
+		return INDEX_NONE;
+
+	const int32 slot = m_Roster.RemovePlayer( playerState );
+	if ( INDEX_NONE == slot )
+		return INDEX_NONE;
+
+	QueueLobbyEvent( ELobbyEventType::Left, slot );
+
+	ForceNetUpdate();
+
+	return slot;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 로비 이벤트 묶음을 방 멤버에게 전달한다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyRoom::MulticastLobbyEvents_Implementation( const FLobbyEventBatch& batch )
+{
+	OnLobbyEvents.Broadcast( batch );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 로비 이벤트를 추가한다. 간격 안에 들어온 이벤트는 한 번에 보낸다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyRoom::QueueLobbyEvent( ELobbyEventType type, int32 slot )
+{
+	if ( INDEX_NONE == slot )
+		return;
+
+	m_EventCoalescer.Add( type, slot );
+
+	if ( !GetWorldTimerManager().IsTimerActive( m_EventFlushTimerHandle ) )
+	{
+		GetWorldTimerManager().SetTimer( m_EventFlushTimerHandle, this, &ThisClass::FlushLobbyEvents, FMath::Max( m_EventBatchInterval, KINDA_SMALL_NUMBER ), false );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 모은 로비 이벤트를 보낸다.
+//////////////////////////////////////////////////////////////////////////
+void ALobbyRoom::FlushLobbyEvents()
+{
+	if ( !m_EventCoalescer.HasPending() )
+		return;
+
+	m_EventCoalescer.Flush( m_Roster.Num(), m_OutgoingEvents );
+
+	// 멀티캐스트도 방 멤버에게만 간다. ( 관련 없는 연결에는 액터 채널이 없다 )
+	MulticastLobbyEvents( m_OutgoingEvents );
+}
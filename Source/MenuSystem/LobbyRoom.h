@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "LobbyEvents.h"
+#include "LobbyRoster.h"
+#include "LobbyRoom.generated.h"
+
+
+/**
+ * 한 프로세스 안의 논리적인 로비 방
+ * 방마다 세션, 로스터, 정원을 따로 가지며, 방 멤버에게만 복제된다.
+ * 대부분 시간 동안 변화가 없으므로 낮은 빈도로 복제하고, 인원이 바뀔 때만 바로 보낸다.
+ */
+UCLASS( NotBlueprintable )
+class MENUSYSTEM_API ALobbyRoom : public AInfo
+{
+	GENERATED_BODY()
+
+private:
+	/// 방의 세션 이름
+	UPROPERTY( Replicated )
+		FName m_SessionName;
+
+	/// 방 정원
+	UPROPERTY( Replicated )
+		int32 m_Capacity{ 0 };
+
+	/// 방 로스터 ( 바뀐 슬롯만 복제된다 )
+	UPROPERTY( Replicated )
+		FLobbyRoster m_Roster;
+
+	/// 로비 이벤트를 모아서 보내는 간격 ( 초 )
+	float m_EventBatchInterval{ 0.25f };
+
+	/// 아직 보내지 않은 로비 이벤트
+	FLobbyEventCoalescer m_EventCoalescer;
+
+	/// 보낼 로비 이벤트 묶음 ( 버퍼 재사용 )
+	FLobbyEventBatch m_OutgoingEvents;
+
+	/// 로비 이벤트 전송 타이머 핸들
+	FTimerHandle m_EventFlushTimerHandle;
+
+public:
+	/// 로비 이벤트 묶음을 받았을 때 ( 서버와 방 멤버 클라이언트 )
+	FOnLobbyEventBatch OnLobbyEvents;
+
+
+public:
+	/// 생성자
+	ALobbyRoom();
+
+	/// 복제할 속성을 등록합니다.
+	virtual void GetLifetimeReplicatedProps( TArray< FLifetimeProperty >& OutLifetimeProps ) const override;
+
+	/// 방 멤버에게만 복제합니다.
+	virtual bool IsNetRelevantFor( const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation ) const override;
+
+	/// 방을 초기화합니다. [ 서버 전용 ]
+	void InitializeRoom( FName sessionName, int32 capacity, float eventBatchInterval );
+
+	/// 플레이어를 방에 넣습니다. 방이 가득 찼으면 INDEX_NONE [ 서버 전용 ]
+	int32 AddPlayer( APlayerState* playerState );
+
+	/// 플레이어를 방에서 뺍니다. 방에 없던 플레이어면 INDEX_NONE [ 서버 전용 ]
+	int32 RemovePlayer( APlayerState* playerState );
+
+	/// 방의 세션 이름을 반환합니다.
+	FName GetSessionName() const { return m_SessionName; }
+
+	/// 방 정원을 반환합니다.
+	int32 GetCapacity() const { return m_Capacity; }
+
+	/// 방의 빈 자리 수를 반환합니다.
+	int32 GetNumOpenSlots() const { return FMath::Max( m_Capacity - m_Roster.Num(), 0 ); }
+
+	/// 방 로스터를 반환합니다.
+	const FLobbyRoster& GetRoster() const { return m_Roster; }
+
+
+protected:
+	/// 로비 이벤트 묶음을 방 멤버에게 전달한다.
+	UFUNCTION( NetMulticast, Reliable )
+	void MulticastLobbyEvents( const FLobbyEventBatch& batch );
+
+
+private:
+	/// 로비 이벤트를 추가한다. 간격 안에 들어온 이벤트는 한 번에 보낸다.
+	void QueueLobbyEvent( ELobbyEventType type, int32 slot );
+
+	/// 모은 로비 이벤트를 보낸다.
+	void FlushLobbyEvents();
+};
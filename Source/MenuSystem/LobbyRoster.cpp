@@ -0,0 +1,237 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LobbyRoster.h"
+#include "GameFramework/PlayerState.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// 예상 인원만큼 미리 할당한다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyRoster::Reserve( int32 numPlayers )
+{
+	m_Entries.Reserve( numPlayers );
+	m_IndexById.Reserve( numPlayers );
+	m_FreeSlots.Reserve( numPlayers );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 플레이어를 추가한다. 슬롯 인덱스를 반환한다.
+//////////////////////////////////////////////////////////////////////////
+int32 FLobbyRoster::AddPlayer( APlayerState* playerState, float joinTime )
+{
+	if ( nullptr == playerState )
+		return INDEX_NONE;
+
+	// 같은 ID 로 다시 들어온 플레이어는 기존 슬롯을 갱신한다.
+	const FUniqueNetIdRepl& playerId = playerState->GetUniqueId();
+	int32 index = FindIndex( playerId );
+
+	if ( INDEX_NONE == index )
+	{
+		// 나간 플레이어의 슬롯을 먼저 재사용해서 인덱스와 배열 크기를 유지한다.
+		index = m_FreeSlots.Num() > 0 ? m_FreeSlots.Pop( false ) : m_Entries.AddDefaulted();
+	}
+
+	FLobbyRosterEntry& entry = m_Entries[ index ];
+	entry.PlayerState  = playerState;
+	entry.PlayerId	   = playerId;
+	entry.JoinTime	   = joinTime;
+	entry.bIsConnected = true;
+	entry.bIsReady	   = false;
+	entry.Team		   = 0;
+
+	MarkSlotDirty( index );
+
+	return index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 플레이어를 뺀다. 비운 슬롯 인덱스를 반환하고 없으면 INDEX_NONE
+//////////////////////////////////////////////////////////////////////////
+int32 FLobbyRoster::RemovePlayer( const APlayerState* playerState )
+{
+	if ( nullptr == playerState )
+		return INDEX_NONE;
+
+	int32 index = FindIndex( playerState->GetUniqueId() );
+
+	// 고유 ID 가 없는 플레이어 ( 온라인 서브시스템 없이 실행 ) 만 슬롯을 훑는다.
+	if ( INDEX_NONE == index )
+	{
+		index = m_Entries.IndexOfByPredicate( [ playerState ]( const FLobbyRosterEntry& entry )
+		{
+			return entry.bIsConnected && entry.PlayerState == playerState;
+		} );
+
+		if ( INDEX_NONE == index )
+			return INDEX_NONE;
+	}
+
+	FLobbyRosterEntry& entry = m_Entries[ index ];
+	entry.PlayerState  = nullptr;
+	entry.PlayerId	   = FUniqueNetIdRepl();
+	entry.bIsConnected = false;
+	entry.bIsReady	   = false;
+
+	m_FreeSlots.Push( index );
+
+	MarkSlotDirty( index );
+
+	return index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 준비 상태를 바꾼다.
+//////////////////////////////////////////////////////////////////////////
+bool FLobbyRoster::SetReady( const FUniqueNetIdRepl& playerId, bool bIsReady )
+{
+	const int32 index = FindIndex( playerId );
+	if ( INDEX_NONE == index )
+		return false;
+
+	if ( m_Entries[ index ].bIsReady != bIsReady )
+	{
+		m_Entries[ index ].bIsReady = bIsReady;
+		MarkSlotDirty( index );
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 팀을 바꾼다.
+//////////////////////////////////////////////////////////////////////////
+bool FLobbyRoster::SetTeam( const FUniqueNetIdRepl& playerId, uint8 team )
+{
+	const int32 index = FindIndex( playerId );
+	if ( INDEX_NONE == index )
+		return false;
+
+	if ( m_Entries[ index ].Team != team )
+	{
+		m_Entries[ index ].Team = team;
+		MarkSlotDirty( index );
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 고유 ID 의 슬롯 인덱스를 반환한다. 없으면 INDEX_NONE
+//////////////////////////////////////////////////////////////////////////
+int32 FLobbyRoster::FindIndex( const FUniqueNetIdRepl& playerId ) const
+{
+	if ( !playerId.IsValid() )
+		return INDEX_NONE;
+
+	const int32* index = m_IndexById.Find( playerId );
+	return index ? *index : INDEX_NONE;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 고유 ID 의 슬롯을 반환한다. 없으면 nullptr
+//////////////////////////////////////////////////////////////////////////
+const FLobbyRosterEntry* FLobbyRoster::Find( const FUniqueNetIdRepl& playerId ) const
+{
+	const int32 index = FindIndex( playerId );
+	return INDEX_NONE != index ? &m_Entries[ index ] : nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 로스터를 비운다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyRoster::Reset()
+{
+	m_Entries.Reset();
+	m_IndexById.Reset();
+	m_FreeSlots.Reset();
+	m_NumPlayers = 0;
+
+	MarkArrayDirty();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 복제로 슬롯이 추가되었을 때 처리한다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyRoster::PostReplicatedAdd( const TArrayView< int32 >& addedIndices, int32 finalSize )
+{
+	for ( const int32 index : addedIndices )
+	{
+		SyncIndex( index );
+		OnChanged.Broadcast( index );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 복제로 슬롯이 바뀌었을 때 처리한다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyRoster::PostReplicatedChange( const TArrayView< int32 >& changedIndices, int32 finalSize )
+{
+	for ( const int32 index : changedIndices )
+	{
+		SyncIndex( index );
+		OnChanged.Broadcast( index );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 복제로 슬롯이 지워지기 전에 처리한다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyRoster::PreReplicatedRemove( const TArrayView< int32 >& removedIndices, int32 finalSize )
+{
+	// 서버는 슬롯을 지우지 않으므로 로스터를 비웠을 때만 온다.
+	for ( const int32 index : removedIndices )
+	{
+		FLobbyRosterEntry& entry = m_Entries[ index ];
+		entry.bIsConnected = false;
+
+		SyncIndex( index );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 슬롯의 조회 테이블 등록과 인원 수를 슬롯 내용과 맞춘다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyRoster::SyncIndex( int32 index )
+{
+	FLobbyRosterEntry& entry = m_Entries[ index ];
+
+	if ( entry.bIsCounted != entry.bIsConnected )
+	{
+		m_NumPlayers += entry.bIsConnected ? 1 : -1;
+		entry.bIsCounted = entry.bIsConnected;
+	}
+
+	FUniqueNetIdRepl playerId;
+	if ( entry.bIsConnected )
+	{
+		playerId = entry.PlayerId;
+	}
+
+	if ( entry.IndexedPlayerId == playerId )
+		return;
+
+	if ( entry.IndexedPlayerId.IsValid() )
+	{
+		m_IndexById.Remove( entry.IndexedPlayerId );
+	}
+
+	if ( playerId.IsValid() )
+	{
+		m_IndexById.Add( playerId, index );
+	}
+
+	entry.IndexedPlayerId = MoveTemp( playerId );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// 슬롯을 바꾼 것으로 표시하고 알린다.
+//////////////////////////////////////////////////////////////////////////
+void FLobbyRoster::MarkSlotDirty( int32 index )
+{
+	SyncIndex( index );
+	MarkItemDirty( m_Entries[ index ] );
+
+	OnChanged.Broadcast( index );
+}
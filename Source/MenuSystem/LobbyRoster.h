@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/OnlineReplStructs.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "LobbyRoster.generated.h"
+
+
+class APlayerState;
+struct FLobbyRoster;
+
+
+/// 로스터 슬롯이 바뀌었을 때 ( 슬롯 인덱스 )
+DECLARE_MULTICAST_DELEGATE_OneParam( FOnLobbyRosterChanged, int32 );
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 로비 로스터 슬롯
+////////////////////////////////////////////////////////////////////////////
+USTRUCT()
+struct FLobbyRosterEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/// 플레이어 상태 ( 이름은 플레이어 상태가 복제하므로 따로 복사하지 않는다 )
+	UPROPERTY()
+		TObjectPtr< APlayerState > PlayerState;
+
+	/// 플레이어 고유 ID
+	UPROPERTY()
+		FUniqueNetIdRepl PlayerId;
+
+	/// 로비에 들어온 시간 ( 서버 월드 시간 )
+	UPROPERTY()
+		float JoinTime{ 0.f };
+
+	/// 접속 중인 슬롯인지 여부 ( 나간 플레이어의 슬롯은 비워두고 다음 플레이어가 재사용한다 )
+	UPROPERTY()
+		bool bIsConnected{ false };
+
+	/// 준비 완료 여부
+	UPROPERTY()
+		bool bIsReady{ false };
+
+	/// 팀
+	UPROPERTY()
+		uint8 Team{ 0 };
+
+	/// 조회 테이블에 등록된 ID ( 클라이언트에서 바뀐 슬롯의 이전 ID 를 지우기 위함 )
+	UPROPERTY( NotReplicated )
+		FUniqueNetIdRepl IndexedPlayerId;
+
+	/// 인원 수에 반영된 접속 여부
+	UPROPERTY( NotReplicated )
+		bool bIsCounted{ false };
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+/// 로비 로스터 ( 슬롯 인덱스가 유지되는 표, 바뀐 슬롯만 클라이언트로 복제된다 )
+////////////////////////////////////////////////////////////////////////////
+USTRUCT()
+struct FLobbyRoster : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+private:
+	/// 슬롯
+	UPROPERTY()
+		TArray< FLobbyRosterEntry > m_Entries;
+
+	/// 고유 ID → 슬롯 인덱스
+	TMap< FUniqueNetIdRepl, int32 > m_IndexById;
+
+	/// 비어 있는 슬롯 인덱스
+	TArray< int32 > m_FreeSlots;
+
+	/// 접속 중인 플레이어 수
+	int32 m_NumPlayers{ 0 };
+
+public:
+	/// 슬롯이 바뀌었을 때 ( 서버 변경과 클라이언트 복제 모두 )
+	FOnLobbyRosterChanged OnChanged;
+
+
+public:
+	/// 예상 인원만큼 미리 할당한다. ( 로그인이 몰려도 할당하지 않도록 )
+	void Reserve( int32 numPlayers );
+
+	/// 플레이어를 추가한다. 슬롯 인덱스를 반환한다.
+	int32 AddPlayer( APlayerState* playerState, float joinTime );
+
+	/// 플레이어를 뺀다. 비운 슬롯 인덱스를 반환하고 없으면 INDEX_NONE
+	int32 RemovePlayer( const APlayerState* playerState );
+
+	/// 준비 상태를 바꾼다.
+	bool SetReady( const FUniqueNetIdRepl& playerId, bool bIsReady );
+
+	/// 팀을 바꾼다.
+	bool SetTeam( const FUniqueNetIdRepl& playerId, uint8 team );
+
+	/// 고유 ID 의 슬롯 인덱스를 반환한다. 없으면 INDEX_NONE
+	int32 FindIndex( const FUniqueNetIdRepl& playerId ) const;
+
+	/// 고유 ID 의 슬롯을 반환한다. 없으면 nullptr
+	const FLobbyRosterEntry* Find( const FUniqueNetIdRepl& playerId ) const;
+
+	/// 슬롯을 반환한다. ( 비어 있는 슬롯도 포함 )
+	const TArray< FLobbyRosterEntry >& GetEntries() const { return m_Entries; }
+
+	/// 접속 중인 플레이어 수
+	int32 Num() const { return m_NumPlayers; }
+
+	/// 로스터를 비운다.
+	void Reset();
+
+
+/// FFastArraySerializer
+public:
+	/// 바뀐 슬롯만 복제한다.
+	bool NetDeltaSerialize( FNetDeltaSerializeInfo& deltaParams )
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize< FLobbyRosterEntry, FLobbyRoster >( m_Entries, deltaParams, *this );
+	}
+
+	/// 복제로 슬롯이 추가되었을 때 처리한다.
+	void PostReplicatedAdd( const TArrayView< int32 >& addedIndices, int32 finalSize );
+
+	/// 복제로 슬롯이 바뀌었을 때 처리한다.
+	void PostReplicatedChange( const TArrayView< int32 >& changedIndices, int32 finalSize );
+
+	/// 복제로 슬롯이 지워지기 전에 처리한다.
+	void PreReplicatedRemove( const TArrayView< int32 >& removedIndices, int32 finalSize );
+
+
+private:
+	/// 슬롯의 조회 테이블 등록과 인원 수를 슬롯 내용과 맞춘다.
+	void SyncIndex( int32 index );
+
+	/// 슬롯을 바꾼 것으로 표시하고 알린다.
+	void MarkSlotDirty( int32 index );
+};
+
+template<>
+struct TStructOpsTypeTraits< FLobbyRoster > : public TStructOpsTypeTraitsBase2< FLobbyRoster >
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -15,7 +15,16 @@ public class MenuSystem : ModuleRules
 			"InputCore", 
 			"HeadMountedDisplay", 
 			"EnhancedInput",
+			"NetCore",
 			"OnlineSubsystem",
-			"OnlineSubsystemSteam" });
+			"MultiplayerSessions" });
+
+		// Steam 헤더는 사용하지 않으므로 런타임에만 필요하다. ( 헤드리스 빌드는 OnlineSubsystemNull 로 동작한다 )
+		if ( Target.Platform == UnrealTargetPlatform.Win64 ||
+			 Target.Platform == UnrealTargetPlatform.Mac ||
+			 Target.Platform == UnrealTargetPlatform.Linux )
+		{
+			DynamicallyLoadedModuleNames.Add( "OnlineSubsystemSteam" );
+		}
 	}
 }
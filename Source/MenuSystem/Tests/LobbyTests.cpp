@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LobbyAdmission.h"
+#include "LobbyEvents.h"
+#include "LobbyRoster.h"
+#include "GameFramework/PlayerState.h"
+#include "OnlineSubsystemTypes.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Misc/AutomationTest.h"
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+namespace LobbyTests
+{
+	/// 테스트 플래그
+	static constexpr EAutomationTestFlags::Type TestFlags = static_cast< EAutomationTestFlags::Type >( EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter );
+
+	/// 테스트 시작 시간 ( 0 이하는 처음 본 버킷으로 취급하므로 피한다 )
+	static constexpr double StartTime = 100.0;
+
+	/// 테스트용 플레이어 고유 ID
+	static FUniqueNetIdRepl MakePlayerId( const TCHAR* name )
+	{
+		return FUniqueNetIdRepl( FUniqueNetIdString::Create( name, FName( TEXT( "LobbyTests" ) ) ) );
+	}
+
+	/// 고유 ID 가 있는 테스트용 플레이어 상태
+	static TStrongObjectPtr< APlayerState > MakePlayerState( const TCHAR* name )
+	{
+		TStrongObjectPtr< APlayerState > playerState( NewObject< APlayerState >( GetTransientPackage() ) );
+		playerState->SetUniqueId( MakePlayerId( name ) );
+
+		return playerState;
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 입장 제한 : 주소별 토큰 버킷, 로그인 중인 자리 예약과 만료
+//////////////////////////////////////////////////////////////////////////
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FLobbyAdmissionTest, "MenuSystem.Lobby.Admission", LobbyTests::TestFlags )
+bool FLobbyAdmissionTest::RunTest( const FString& parameters )
+{
+	using namespace LobbyTests;
+
+	FLobbyAdmissionConfig config;
+	config.LoginRatePerAddress	= 1.f;
+	config.LoginBurstPerAddress = 2.f;
+	config.ReservationTimeout	= 5.f;
+
+	// 같은 주소의 시도는 버스트만큼 통과하고, 시간이 지나 토큰이 차야 다시 통과한다.
+	{
+		FLobbyAdmissionControl admission;
+		FString reason;
+
+		TestTrue( TEXT( "첫 시도" ), admission.Admit( config, TEXT( "10.0.0.1" ), FUniqueNetIdRepl(), 0, 0, StartTime, reason ) );
+		TestTrue( TEXT( "버스트 안의 재시도" ), admission.Admit( config, TEXT( "10.0.0.1" ), FUniqueNetIdRepl(), 0, 0, StartTime, reason ) );
+		TestFalse( TEXT( "버스트를 넘은 시도" ), admission.Admit( config, TEXT( "10.0.0.1" ), FUniqueNetIdRepl(), 0, 0, StartTime, reason ) );
+		TestFalse( TEXT( "거절 이유" ), reason.IsEmpty() );
+
+		reason.Reset();
+		TestTrue( TEXT( "다른 주소는 따로 센다" ), admission.Admit( config, TEXT( "10.0.0.2" ), FUniqueNetIdRepl(), 0, 0, StartTime, reason ) );
+		TestTrue( TEXT( "토큰이 다시 차면 통과" ), admission.Admit( config, TEXT( "10.0.0.1" ), FUniqueNetIdRepl(), 0, 0, StartTime + 1.0, reason ) );
+	}
+
+	// 로그인 중인 플레이어의 자리는 정원에 포함하고, 로그인이 끝나거나 시간이 지나면 푼다.
+	{
+		FLobbyAdmissionControl admission;
+		FString reason;
+
+		const FUniqueNetIdRepl playerA = MakePlayerId( TEXT( "A" ) );
+		const FUniqueNetIdRepl playerB = MakePlayerId( TEXT( "B" ) );
+		const FUniqueNetIdRepl playerC = MakePlayerId( TEXT( "C" ) );
+
+		TestTrue( TEXT( "A 예약" ), admission.Admit( config, TEXT( "10.0.0.1" ), playerA, 0, 2, StartTime, reason ) );
+		TestTrue( TEXT( "B 예약" ), admission.Admit( config, TEXT( "10.0.0.2" ), playerB, 0, 2, StartTime, reason ) );
+		TestEqual( TEXT( "예약 수" ), admission.GetNumReservations( StartTime ), 2 );
+
+		TestFalse( TEXT( "예약으로 찬 정원" ), admission.Admit( config, TEXT( "10.0.0.3" ), playerC, 0, 2, StartTime, reason ) );
+		TestEqual( TEXT( "정원 거절 이유" ), reason, FString( TEXT( "Lobby is full." ) ) );
+
+		reason.Reset();
+		TestTrue( TEXT( "예약한 플레이어의 재시도" ), admission.Admit( config, TEXT( "10.0.0.1" ), playerA, 0, 2, StartTime + 1.0, reason ) );
+		TestEqual( TEXT( "재시도는 예약을 늘리지 않는다" ), admission.GetNumReservations( StartTime + 1.0 ), 2 );
+
+		admission.ConfirmLogin( playerB, TEXT( "10.0.0.2" ) );
+		TestEqual( TEXT( "로그인이 끝나면 예약을 푼다" ), admission.GetNumReservations( StartTime + 1.0 ), 1 );
+		TestFalse( TEXT( "로그인한 인원도 정원에 포함" ), admission.Admit( config, TEXT( "10.0.0.3" ), playerC, 1, 2, StartTime + 1.0, reason ) );
+
+		// A 는 재시도로 예약 시간이 늘었으므로 처음 예약 시간이 지나도 남는다.
+		TestEqual( TEXT( "늘어난 예약" ), admission.GetNumReservations( StartTime + config.ReservationTimeout ), 1 );
+		TestEqual( TEXT( "만료된 예약" ), admission.GetNumReservations( StartTime + 1.0 + config.ReservationTimeout ), 0 );
+	}
+
+	return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 로스터 : 나간 슬롯 재사용, 같은 ID 의 재입장, 고유 ID 조회
+//////////////////////////////////////////////////////////////////////////
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FLobbyRosterTest, "MenuSystem.Lobby.Roster", LobbyTests::TestFlags )
+bool FLobbyRosterTest::RunTest( const FString& parameters )
+{
+	using namespace LobbyTests;
+
+	const TStrongObjectPtr< APlayerState > playerA = MakePlayerState( TEXT( "A" ) );
+	const TStrongObjectPtr< APlayerState > playerB = MakePlayerState( TEXT( "B" ) );
+	const TStrongObjectPtr< APlayerState > playerC = MakePlayerState( TEXT( "C" ) );
+	const TStrongObjectPtr< APlayerState > playerD = MakePlayerState( TEXT( "D" ) );
+
+	FLobbyRoster roster;
+	roster.Reserve( 4 );
+
+	TestEqual( TEXT( "A 슬롯" ), roster.AddPlayer( playerA.Get(), 0.f ), 0 );
+	TestEqual( TEXT( "B 슬롯" ), roster.AddPlayer( playerB.Get(), 1.f ), 1 );
+	TestEqual( TEXT( "C 슬롯" ), roster.AddPlayer( playerC.Get(), 2.f ), 2 );
+	TestEqual( TEXT( "인원" ), roster.Num(), 3 );
+
+	TestEqual( TEXT( "B 가 비운 슬롯" ), roster.RemovePlayer( playerB.Get() ), 1 );
+	TestEqual( TEXT( "나간 뒤 인원" ), roster.Num(), 2 );
+	TestNull( TEXT( "나간 플레이어 조회" ), roster.Find( playerB->GetUniqueId() ) );
+	TestEqual( TEXT( "없는 플레이어는 뺄 수 없다" ), roster.RemovePlayer( playerB.Get() ), INDEX_NONE );
+
+	// 나간 슬롯을 재사용하므로 다른 플레이어의 인덱스와 배열 크기가 그대로다.
+	TestEqual( TEXT( "D 는 빈 슬롯을 재사용" ), roster.AddPlayer( playerD.Get(), 3.f ), 1 );
+	TestEqual( TEXT( "슬롯 수 유지" ), roster.GetEntries().Num(), 3 );
+	TestEqual( TEXT( "C 인덱스 유지" ), roster.FindIndex( playerC->GetUniqueId() ), 2 );
+
+	// 같은 ID 로 다시 들어오면 새 슬롯을 잡지 않고 기존 슬롯을 갱신한다.
+	TestTrue( TEXT( "준비" ), roster.SetReady( playerA->GetUniqueId(), true ) );
+	TestEqual( TEXT( "A 재입장" ), roster.AddPlayer( playerA.Get(), 4.f ), 0 );
+	TestEqual( TEXT( "재입장 후 인원" ), roster.Num(), 3 );
+
+	const FLobbyRosterEntry* entryA = roster.Find( playerA->GetUniqueId() );
+	if ( TestNotNull( TEXT( "A 조회" ), entryA ) )
+	{
+		TestFalse( TEXT( "재입장하면 준비를 푼다" ), entryA->bIsReady );
+		TestEqual( TEXT( "재입장 시간" ), entryA->JoinTime, 4.f );
+	}
+
+	roster.Reset();
+	TestEqual( TEXT( "비운 뒤 인원" ), roster.Num(), 0 );
+	TestEqual( TEXT( "비운 뒤 첫 슬롯" ), roster.AddPlayer( playerB.Get(), 5.f ), 0 );
+
+	return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// 이벤트 묶음 : 같은 묶음에서 들어왔다 나간 플레이어 상쇄, 발생 순서 유지
+//////////////////////////////////////////////////////////////////////////
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FLobbyEventCoalescerTest, "MenuSystem.Lobby.Events", LobbyTests::TestFlags )
+bool FLobbyEventCoalescerTest::RunTest( const FString& parameters )
+{
+	FLobbyEventCoalescer coalescer;
+	TestFalse( TEXT( "처음에는 비어 있다" ), coalescer.HasPending() );
+
+	// 슬롯 1 은 들어왔다 나갔으므로 지우고, 슬롯 2 는 나갔다 다른 플레이어가 들어왔을 수 있으므로 둘 다 남긴다.
+	coalescer.Add( ELobbyEventType::Joined, 0 );
+	coalescer.Add( ELobbyEventType::Joined, 1 );
+	coalescer.Add( ELobbyEventType::Left,	1 );
+	coalescer.Add( ELobbyEventType::Left,	2 );
+	coalescer.Add( ELobbyEventType::Joined, 2 );
+	TestTrue( TEXT( "보낼 이벤트" ), coalescer.HasPending() );
+
+	FLobbyEventBatch batch;
+	coalescer.Flush( 2, batch );
+
+	TestEqual( TEXT( "묶음 인원" ), static_cast< int32 >( batch.NumPlayers ), 2 );
+	if ( TestEqual( TEXT( "상쇄 후 이벤트 수" ), batch.Events.Num(), 3 ) )
+	{
+		TestTrue( TEXT( "1 번째" ), ELobbyEventType::Joined == batch.Events[ 0 ].Type && 0 == batch.Events[ 0 ].Slot );
+		TestTrue( TEXT( "2 번째" ), ELobbyEventType::Left	== batch.Events[ 1 ].Type && 2 == batch.Events[ 1 ].Slot );
+		TestTrue( TEXT( "3 번째" ), ELobbyEventType::Joined == batch.Events[ 2 ].Type && 2 == batch.Events[ 2 ].Slot );
+	}
+
+	TestFalse( TEXT( "꺼낸 뒤에는 비어 있다" ), coalescer.HasPending() );
+
+	// 이전 묶음에서 들어온 플레이어가 나가면 클라이언트가 알아야 하므로 지우지 않는다.
+	coalescer.Add( ELobbyEventType::Left, 0 );
+	coalescer.Flush( 1, batch );
+
+	if ( TestEqual( TEXT( "다음 묶음 이벤트 수" ), batch.Events.Num(), 1 ) )
+	{
+		TestTrue( TEXT( "이전 묶음 플레이어의 퇴장" ), ELobbyEventType::Left == batch.Events[ 0 ].Type && 0 == batch.Events[ 0 ].Slot );
+	}
+
+	coalescer.Flush( 1, batch );
+	TestEqual( TEXT( "빈 묶음" ), batch.Events.Num(), 0 );
+
+	return true;
+}
+
+
+#endif // WITH_DEV_AUTOMATION_TESTS